@@ -72,7 +72,39 @@
 #include "wiced_bt_cfg.h"
 #include "wiced_hal_mia.h"
 #include "wiced_hal_mia.h"
+#include "wiced_memory.h"
 #include "GeneratedSource/cycfg_pins.h"
+#ifdef HCI_CONTROL
+#include "wiced_transport.h"
+#include "sensor_motion_hci.h"
+#endif
+#include "sensor_motion_event.h"
+#include "sensor_motion_cadence.h"
+#include "sensor_motion_codec.h"
+#include "sensor_motion_rate_limit.h"
+#include "sensor_motion_publish.h"
+#include "sensor_motion_profile.h"
+#include "sensor_motion_lpn.h"
+#include "sensor_motion_nvram.h"
+#include "sensor_motion_latency.h"
+#include "sensor_motion_time.h"
+#include "sensor_motion_rule.h"
+#include "sensor_motion_relay.h"
+#include "sensor_motion_stack.h"
+#ifdef REMOTE_PROVISION_SERVER_SUPPORTED
+#include "sensor_motion_rpr.h"
+#endif
+#ifdef SYNTHETIC_MOTION
+#include "sensor_motion_workload.h"
+#endif
+#ifdef MESH_DFU_SUPPORTED
+#include "sensor_motion_dfu.h"
+#endif
+#ifdef OTA_DELTA_SUPPORTED
+#include "wiced_firmware_upgrade.h"
+#include "wiced_hal_eflash.h"
+#include "sensor_motion_delta.h"
+#endif
 
 extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
@@ -84,6 +116,15 @@ extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
 #define MESH_SENSOR_PROPERTY_ID                         WICED_BT_MESH_PROPERTY_PRESENCE_DETECTED
 #define MESH_SENSOR_VALUE_LEN                           WICED_BT_MESH_PROPERTY_LEN_PRESENCE_DETECTED
+#define MESH_SENSOR_VALUE_CODEC                         boolean     // selects encoding of the property value
+
+SENSOR_CODEC_STATIC_ASSERT(SENSOR_CODEC_LEN(MESH_SENSOR_VALUE_CODEC) == MESH_SENSOR_VALUE_LEN, presence_detected_len);
+
+// Sensor Status with all the sensors of the element, sent in reply to a Sensor Get without property ID,
+// must not be segmented. The element has the motion sensor only, see MESH_SENSOR_NUM.
+#define MESH_SENSOR_STATUS_LEN                          SENSOR_CODEC_STATUS_ENTRY_LEN(MESH_SENSOR_PROPERTY_ID, MESH_SENSOR_VALUE_LEN)
+
+SENSOR_CODEC_STATIC_ASSERT(MESH_SENSOR_STATUS_LEN <= SENSOR_CODEC_STATUS_UNSEGMENTED_MAX, sensor_status_unsegmented);
 
 #define MESH_MOTION_SENSOR_POSITIVE_TOLERANCE           WICED_BT_MESH_SENSOR_TOLERANCE_UNSPECIFIED
 #define MESH_MOTION_SENSOR_NEGATIVE_TOLERANCE           WICED_BT_MESH_SENSOR_TOLERANCE_UNSPECIFIED
@@ -93,9 +134,86 @@ extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 #define MESH_MOTION_SENSOR_UPDATE_INTERVAL              WICED_BT_MESH_SENSOR_VAL_UNKNOWN
 
 #define MESH_MOTION_SENSOR_CADENCE_VSID_START           WICED_NVRAM_VSID_START
+#define MESH_MOTION_SENSOR_CADENCE_BASELINE_VSID        (WICED_NVRAM_VSID_START + 1)
+#define MESH_MOTION_SENSOR_COMMISSIONING_VSID           (WICED_NVRAM_VSID_START + 2)
+#define MESH_MOTION_SENSOR_ZONE_VSID                    (WICED_NVRAM_VSID_START + 3)
+#define MESH_MOTION_SENSOR_RELAY_VSID                   (WICED_NVRAM_VSID_START + 4)
+#define MESH_MOTION_SENSOR_PIR_SETTING_VSID             (WICED_NVRAM_VSID_START + 5)
+#define MESH_MOTION_SENSOR_PROFILE_VSID                 (WICED_NVRAM_VSID_START + 6)
+#define MESH_MOTION_SENSOR_RULE_VSID                    (WICED_NVRAM_VSID_START + 7)
+#define MESH_MOTION_SENSOR_LPN_POLL_VSID                (WICED_NVRAM_VSID_START + 8)
+#define MESH_MOTION_SENSOR_OCCUPANCY_VSID               (WICED_NVRAM_VSID_START + 9)
+
+// Default TTL of the presence changes sent to the zone group, enough to reach the lights nearby
+#define MESH_SENSOR_ZONE_DEFAULT_TTL                    2
+
+// After power up unprovisioned device advertises fast for 3 minutes to be found and provisioned quickly.
+// Advertising intervals are in 0.625 ms slots.
+#define MESH_COMMISSIONING_FAST_ADV_DURATION            180
+#define MESH_COMMISSIONING_FAST_ADV_MIN_INTERVAL        32          // 20 ms
+#define MESH_COMMISSIONING_FAST_ADV_MAX_INTERVAL        48          // 30 ms
+
+// Relay self-election is done by the nodes which support relay, the result is checked every hour
+#if !defined(LOW_POWER_NODE) || (LOW_POWER_NODE != 1)
+#define MESH_SENSOR_RELAY_ELECTION
+#endif
+#define MESH_SENSOR_RELAY_ELECTION_INTERVAL             3600
+
+// Relay state values of the Config Relay Set message
+#define MESH_SENSOR_RELAY_STATE_DISABLED                0
+#define MESH_SENSOR_RELAY_STATE_ENABLED                 1
+// Relay state has been set by a Config Client, the election does not change it any more
+#define MESH_SENSOR_RELAY_STATE_CONFIGURED              0xFF
+
+// Estimated average current consumption while the device is connected and does not sleep
+#define MESH_SENSOR_CONNECTED_CURRENT_UA                1500
+
+// Buffer pools are sampled at each publication and every minute
+#define MESH_SENSOR_BUFFER_POOLS                        5
+#define MESH_SENSOR_BUFFER_SAMPLE_INTERVAL              60
+
+// Time is requested from the Time Server when presence changes wait in the log and the time was not
+// received in the last hour, which bounds the drift of the tick count. A request without answer is
+// repeated after 10 minutes at the earliest.
+#define MESH_SENSOR_TIME_SYNC_INTERVAL                  3600000
+#define MESH_SENSOR_TIME_RETRY_INTERVAL                 600000
+
+// Number of presence changes kept until they are read in a batch
+#define MESH_SENSOR_OCCUPANCY_LOG_SIZE                  16
+
+// Sleep durations of the Low Power Node are counted in buckets from 1 second to 5 minutes and longer
+#define MESH_SENSOR_LPN_SLEEP_BUCKETS                   7
+
+// Cadence statistics rate is reported as a regression if it exceeds the baseline by more than 25%
+#define MESH_SENSOR_STATS_REGRESSION_MARGIN_PERCENT     25
 
-// After presence is detected, interrupts are disabled for 7 seconds
-#define MESH_PRESENCE_DETECTED_BLIND_TIME               7
+// PIR calibration state
+#define MESH_SENSOR_CALIBRATION_IDLE                    0
+#define MESH_SENSOR_CALIBRATION_RUNNING                 1
+#define MESH_SENSOR_CALIBRATION_DONE                    2
+#define MESH_SENSOR_CALIBRATION_FAILED                  3
+
+// Default PIR calibration observation window in seconds for each setting
+#define MESH_SENSOR_CALIBRATION_DEFAULT_WINDOW          300
+
+// The profile setting is specific to this application, the property is not assigned by the Bluetooth SIG
+#define MESH_SENSOR_PROFILE_SETTING_PROPERTY_ID         0xFF00
+
+// Presence rules are written one at a time with this setting, see sensor_rule_decode
+#define MESH_SENSOR_RULE_SETTING_PROPERTY_ID            0xFF01
+
+// PIR calibration is started by a write of this setting, a read returns the state and the result:
+// window in seconds (2), budget (1), state (1), sensitivity (1), pulse count (1), triggers (2)
+#define MESH_SENSOR_CALIBRATION_SETTING_PROPERTY_ID     0xFF02
+#define MESH_SENSOR_CALIBRATION_SETTING_LEN             8
+#define MESH_SENSOR_CALIBRATION_SETTING_WRITE_LEN       3
+
+// Oldest presence changes of the log are read in a batch with this setting once the time is known:
+// count (1), dropped changes (2), then for each change the TAI time (5), subsecond (1) and presence (1).
+// A write of the number of changes received (1) removes them from the log.
+#define MESH_SENSOR_OCCUPANCY_SETTING_PROPERTY_ID       0xFF03
+#define MESH_SENSOR_OCCUPANCY_BATCH_SIZE                8
+#define MESH_SENSOR_OCCUPANCY_SETTING_LEN               (3 + 7 * MESH_SENSOR_OCCUPANCY_BATCH_SIZE)
 
 /******************************************************
  *          Structures
@@ -107,7 +225,7 @@ e93196_usr_cfg_t e93196_usr_cfg =
     .e93196_init_reg    =
     {
         .sensitivity    = 0x10,                                     /* [24:17]sensitivity,   [Register Value] * 6.5uV           */
-        .blind_time     = MESH_PRESENCE_DETECTED_BLIND_TIME * 2,    /* [16:13]blind time,    [Register Value] * 0.5s, max is 8s */
+        .blind_time     = SENSOR_PROFILE_BLIND_TIME * 2,    /* [16:13]blind time,    [Register Value] * 0.5s, max is 8s */
         .pulse_cnt      = 0x01,                                     /* [12:11]pulse count                                       */
         .window_time    = 0x01,                                     /* [10:9]window time                                        */
         .move_dete_en   = 0x01,                                     /* [8]move detect enable                                    */
@@ -132,31 +250,231 @@ typedef struct
 } mesh_sensor_motion_t;
 
 mesh_sensor_motion_t app_state = { 0 };
+
+// Sleep statistics to compare power consumption of the low power node on different boards
+typedef struct
+{
+    uint32_t start_time;            // tick count when statistics were reset
+    uint32_t sleeps;                // number of times ePDS sleep has been allowed
+    uint32_t suspended;             // number of sleep requests refused because of a GATT connection
+    uint32_t hid_off_failures;      // number of times HID-Off could not be entered
+    uint32_t motion_wakes;          // number of motion interrupts received while idle
+    uint32_t sleep_requested_ms;    // total sleep duration allowed by the mesh core
+    uint64_t sleep_squared_ms;      // sum of the squared sleep durations, for the expected downlink latency
+    uint32_t sleep_max;             // longest sleep, the worst case downlink latency
+    uint32_t sleep_buckets[MESH_SENSOR_LPN_SLEEP_BUCKETS];  // number of sleeps by duration
+} mesh_sensor_lpn_stats_t;
+
+mesh_sensor_lpn_stats_t mesh_sensor_lpn_stats;
+
+// Upper bounds of the sleep duration buckets in ms, the last bucket takes everything longer
+const uint32_t mesh_sensor_lpn_sleep_bounds[MESH_SENSOR_LPN_SLEEP_BUCKETS] =
+{
+    1000, 5000, 10000, 30000, 60000, 300000, 0xFFFFFFFF
+};
+
+// Poll settings which replace the ones of the profile
+sensor_lpn_poll_t mesh_sensor_lpn_poll = { 0 };
+
+// Chip reported with the sleep statistics
+#if defined(CYW20819A1)
+#define MESH_SENSOR_LPN_CHIP    SENSOR_MOTION_CHIP_20819
+#elif defined(CYW20820A1)
+#define MESH_SENSOR_LPN_CHIP    SENSOR_MOTION_CHIP_20820
+#elif defined(CYW20835B1)
+#define MESH_SENSOR_LPN_CHIP    SENSOR_MOTION_CHIP_20835
+#else
+#define MESH_SENSOR_LPN_CHIP    SENSOR_MOTION_CHIP_UNKNOWN
+#endif
+#endif
+
+// Cadence engine statistics to measure the cost of the cadence configuration
+typedef struct
+{
+    uint32_t start_time;            // tick count when statistics were reset
+    uint32_t evaluations;           // number of cadence evaluations on timer expiration or value change
+    uint32_t publishes;             // number of published values
+    uint32_t timer_rearms;          // number of times the cadence timer has been started
+} mesh_sensor_cadence_stats_t;
+
+// Buffer pool telemetry to tell resource starvation apart from RF loss
+typedef struct
+{
+    uint32_t samples;                               // number of times the pools were sampled
+    uint32_t publishes;                             // number of publications passed to the mesh models library
+    uint32_t publish_failures;                      // publications the library failed to send
+    uint32_t event_failures;                        // zone publications dropped for lack of an event
+    uint16_t min_free[MESH_SENSOR_BUFFER_POOLS];    // lowest number of free buffers seen in each pool
+} mesh_sensor_buffer_stats_t;
+
+// Presence change stamped with the tick count, converted to TAI time when the log is read
+typedef struct
+{
+    uint32_t tick;                  // tick count of the change
+    uint8_t  presence;              // presence value after the change
+} mesh_sensor_occupancy_t;
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+// Presence change log, time mapping and delayed rules saved in the NVRAM while the device is in HID-Off
+typedef struct
+{
+    sensor_time_map_t       time_map;
+    mesh_sensor_occupancy_t log[MESH_SENSOR_OCCUPANCY_LOG_SIZE];
+    uint8_t                 first;
+    uint8_t                 count;
+    uint32_t                dropped;
+    uint32_t                rule_due[SENSOR_RULE_MAX];  // tick count when the delayed rules fire
+    uint8_t                 rule_pending;               // delayed rules waiting to fire
+    uint32_t                sleep_tick;     // tick count when HID-Off was entered
+    uint32_t                sleep_duration; // ms until the timed wake
+} mesh_sensor_occupancy_saved_t;
 #endif
 
+// Zone group which receives presence changes in addition to the configured publication
+typedef struct
+{
+    uint16_t addr;                  // zone group address, 0 if not configured
+    uint16_t app_key_idx;           // application key to send the presence changes with
+    uint8_t  ttl;                   // TTL of the presence changes
+} mesh_sensor_zone_t;
+
+// Commissioning time measurement, saved in the NVRAM once the node is commissioned
+typedef struct
+{
+    uint32_t provisioned_time;      // ms from power up to the end of provisioning
+    uint32_t first_publish_time;    // ms from power up to the first publication after provisioning
+} mesh_sensor_commissioning_record_t;
+
+// PIR settings tried by the calibration, saved in the NVRAM when calibrated
+typedef struct
+{
+    uint8_t  sensitivity;           // detection threshold, [Register Value] * 6.5uV
+    uint8_t  pulse_cnt;             // number of pulses to trigger, [Register Value] + 1
+} mesh_sensor_pir_setting_t;
+
+typedef struct
+{
+    uint32_t evaluations_per_hour;
+    uint32_t publishes_per_hour;
+    uint32_t timer_rearms_per_hour;
+} mesh_sensor_cadence_rates_t;
+
 /******************************************************
  *          Function Prototypes
  ******************************************************/
 static void         mesh_app_init(wiced_bool_t is_provisioned);
+static void         mesh_app_gatt_conn_status(wiced_bt_gatt_connection_status_t *p_status);
 static wiced_bool_t mesh_app_notify_period_set(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint32_t period);
 
 static void         mesh_sensor_server_restart_timer(wiced_bt_mesh_core_config_sensor_t *p_sensor);
+static void         mesh_sensor_publish_config(wiced_bt_mesh_core_config_sensor_t *p_sensor, sensor_publish_config_t *p_config);
 static void         mesh_sensor_server_report_handler(uint16_t event, uint8_t element_idx, void *p_get_data, void *p_ref_data);
 static void         mesh_sensor_server_config_change_handler(uint8_t element_idx, uint16_t event, void* p_data);
+#ifdef STACK_PROFILE
+static void         mesh_app_init_profiled(wiced_bool_t is_provisioned);
+static void         mesh_sensor_server_report_handler_profiled(uint16_t event, uint8_t element_idx, void *p_get_data, void *p_ref_data);
+static void         mesh_sensor_server_config_change_handler_profiled(uint8_t element_idx, uint16_t event, void* p_data);
+#define MESH_APP_INIT                               mesh_app_init_profiled
+#define MESH_SENSOR_SERVER_REPORT_HANDLER           mesh_sensor_server_report_handler_profiled
+#define MESH_SENSOR_SERVER_CONFIG_CHANGE_HANDLER    mesh_sensor_server_config_change_handler_profiled
+#else
+#define MESH_APP_INIT                               mesh_app_init
+#define MESH_SENSOR_SERVER_REPORT_HANDLER           mesh_sensor_server_report_handler
+#define MESH_SENSOR_SERVER_CONFIG_CHANGE_HANDLER    mesh_sensor_server_config_change_handler
+#endif
 static void         mesh_sensor_server_process_cadence_changed(uint8_t element_idx, wiced_bt_mesh_sensor_cadence_status_data_t* p_data);
 static void         mesh_sensor_server_process_setting_changed(uint8_t element_idx, wiced_bt_mesh_sensor_setting_status_data_t* p_data);
 static void         mesh_sensor_publish_timer_callback(TIMER_PARAM_TYPE arg);
+static void         mesh_sensor_publish_timer_process(wiced_bt_mesh_core_config_sensor_t *p_sensor);
 static void         e93196_int_proc(void *data, uint8_t port_pin);
 static void         mesh_sensor_presence_detected_timer_callback(TIMER_PARAM_TYPE arg);
-static void         mesh_sensor_publish(void);
+static void         mesh_sensor_event_handler(sensor_motion_event_t *p_event);
+static void         mesh_sensor_presence_detected(uint32_t timestamp, uint8_t count);
+static void         mesh_sensor_presence_timeout(void);
+static void         mesh_sensor_publish(uint8_t dst);
+static void         mesh_sensor_publish_send(uint8_t dst, uint32_t current_time);
+static void         mesh_sensor_zone_set(uint16_t addr, uint8_t ttl, uint16_t app_key_idx);
+#ifdef MESH_SENSOR_RELAY_ELECTION
+static void         mesh_sensor_relay_election_timer_callback(TIMER_PARAM_TYPE arg);
+static void         mesh_sensor_relay_election(void);
+#endif
+static uint32_t     mesh_sensor_rate_limit_interval(void);
+static void         mesh_sensor_publish_deferred_timer_callback(TIMER_PARAM_TYPE arg);
 static void         mesh_sensor_value_changed(wiced_bt_mesh_core_config_sensor_t* p_sensor);
 static int32_t      mesh_sensor_get_current_value(void);
+static void         mesh_sensor_prepare_status(void);
 static void         mesh_app_factory_reset(void);
+static void         mesh_sensor_cadence_stats_reset(void);
+static void         mesh_sensor_commissioning_start(void);
+static void         mesh_sensor_commissioning_provisioned(void);
+static void         mesh_sensor_commissioning_published(void);
+static void         mesh_sensor_commissioning_timer_callback(TIMER_PARAM_TYPE arg);
+static void         mesh_sensor_commissioning_adv_restore(void);
+static void         mesh_sensor_cadence_stats_get_rates(mesh_sensor_cadence_rates_t *p_rates);
+static void         mesh_sensor_buffer_sample(void);
+static void         mesh_sensor_buffer_stats_reset(void);
+static void         mesh_sensor_buffer_timer_callback(TIMER_PARAM_TYPE arg);
+static void         mesh_sensor_time_client_callback(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+static void         mesh_sensor_time_get(void);
+static void         mesh_sensor_time_request(void);
+static void         mesh_sensor_occupancy_log(uint8_t presence, uint32_t tick);
+static void         mesh_sensor_occupancy_remove(uint8_t count);
+static void         mesh_sensor_occupancy_setting_update(void);
+static void         mesh_sensor_rule_set(uint8_t *p_data, uint8_t len);
+static void         mesh_sensor_rule_setting_update(uint8_t index);
+static void         mesh_sensor_rule_action(const sensor_rule_t *p_rule);
+static void         mesh_sensor_rule_timer_restart(uint32_t timeout);
+static void         mesh_sensor_rule_timer_callback(TIMER_PARAM_TYPE arg);
+static void         mesh_sensor_rule_client_callback(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+static void         mesh_sensor_pir_setting_apply(const mesh_sensor_pir_setting_t *p_setting);
+static void         mesh_sensor_profile_set(uint8_t profile);
+static void         mesh_sensor_calibration_start(uint16_t window, uint8_t budget);
+static void         mesh_sensor_calibration_step(void);
+static void         mesh_sensor_calibration_setting_update(void);
+static void         mesh_sensor_calibration_timer_callback(TIMER_PARAM_TYPE arg);
+#ifdef HCI_CONTROL
+static uint32_t     mesh_app_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length);
+static void         mesh_sensor_cadence_stats_send(void);
+static void         mesh_sensor_cadence_baseline_save(void);
+static void         mesh_sensor_nvram_stats_send(void);
+static void         mesh_sensor_commissioning_send(void);
+static void         mesh_sensor_connection_stats_send(void);
+static void         mesh_sensor_latency_stats_send(void);
+static void         mesh_sensor_calibration_send(void);
+static void         mesh_sensor_buffer_stats_send(void);
+static void         mesh_sensor_occupancy_send(void);
+static void         mesh_sensor_rule_send(void);
+#ifdef STACK_PROFILE
+static uint32_t     mesh_app_proc_rx_cmd_profiled(uint16_t opcode, uint8_t *p_data, uint32_t length);
+static void         mesh_sensor_stack_stats_send(void);
+#endif
+#ifdef REMOTE_PROVISION_SERVER_SUPPORTED
+static void         mesh_sensor_rpr_stats_send(void);
+#endif
+#ifdef MESH_DFU_SUPPORTED
+static void         mesh_sensor_dfu_stats_send(void);
+#endif
+#ifdef OTA_DELTA_SUPPORTED
+static void         mesh_sensor_delta_start(void);
+static void         mesh_sensor_delta_data(uint8_t *p_data, uint32_t length);
+static void         mesh_sensor_delta_finish(void);
+static void         mesh_sensor_delta_send(void);
+static wiced_bool_t mesh_sensor_delta_read_old(uint32_t offset, uint8_t *p_data, uint32_t len);
+static wiced_bool_t mesh_sensor_delta_write_new(uint32_t offset, uint8_t *p_data, uint32_t len);
+#endif
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+static void         mesh_sensor_lpn_stats_send(void);
+static void         mesh_sensor_lpn_poll_set(uint8_t *p_data, uint32_t length);
+#endif
+#endif
 
 
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
 void mesh_sensor_motion_lpn_sleep(uint32_t max_sleep_duration);
 static uint32_t mesh_sensor_motion_sleep_poll(wiced_sleep_poll_type_t type);
+static void mesh_sensor_occupancy_save(uint32_t sleep_duration);
+static void mesh_sensor_occupancy_restore(void);
+static void mesh_sensor_occupancy_correct(void);
 #endif
 /******************************************************
  *          Variables Definitions
@@ -167,8 +485,24 @@ uint8_t mesh_prop_fw_version[WICED_BT_MESH_PROPERTY_LEN_DEVICE_FIRMWARE_REVISION
 uint8_t mesh_system_id[8]                                                           = { 0xbb, 0xb8, 0xa1, 0x80, 0x5f, 0x9f, 0x91, 0x71 };
 
 int32_t       mesh_sensor_sent_value = 0;          // Value that was sent, it can be different than pub_value due to GET
-int32_t       mesh_sensor_pub_value;               // value that has been published
-uint32_t      mesh_sensor_pub_time;                // time stamp when data was published
+uint8_t       mesh_sensor_sent_data[MESH_SENSOR_VALUE_LEN]; // Sent value encoded in the property format, the library sends it from here
+uint32_t      mesh_sensor_value_generation = 1;    // incremented each time the sensor value changes
+uint32_t      mesh_sensor_sent_generation = 0;     // value generation encoded in mesh_sensor_sent_data
+mesh_sensor_zone_t mesh_sensor_zone = { 0 };
+
+#ifdef MESH_SENSOR_RELAY_ELECTION
+// Relay state last applied by the election, saved in the NVRAM. The mesh core keeps its own Relay
+// state, a state which differs from this one has been set by a Config Client.
+wiced_timer_t mesh_sensor_relay_election_timer;
+uint8_t       mesh_sensor_relay_state = MESH_SENSOR_RELAY_STATE_ENABLED;
+#endif
+
+// Publication rate limiter. Publication which is not allowed is deferred until a token is available.
+sensor_rate_limit_t mesh_sensor_rate_limit;
+wiced_timer_t mesh_sensor_publish_deferred_timer;
+uint8_t       mesh_sensor_publish_pending = 0;      // destinations of the deferred publications
+int32_t       mesh_sensor_pub_value;               // value that has been published to the gateway
+uint32_t      mesh_sensor_pub_time;                // time stamp when data was published to the gateway
 uint32_t      mesh_sensor_publish_period = 0;      // publish "no presence" every ~5 minutes, with fast cadence 32. This is reset to 0 after provisioning.  Set here for testing.
                                                    // we will publish "presence" every 10 seconds.
 uint32_t      mesh_sensor_fast_publish_period = 0; // publish period in msec when values are outside of limit
@@ -176,14 +510,125 @@ wiced_timer_t mesh_sensor_cadence_timer;
 wiced_timer_t mesh_sensor_presence_detected_timer;
 wiced_bool_t  presence_detected = WICED_FALSE;
 uint32_t      mesh_sensor_sleep_max_time = 0;       // motion sensor max sleep time. unit is ms.
+mesh_sensor_cadence_stats_t mesh_sensor_cadence_stats;
+mesh_sensor_buffer_stats_t  mesh_sensor_buffer_stats;
+wiced_bt_buffer_statistics_t mesh_sensor_buffer_pools[MESH_SENSOR_BUFFER_POOLS]; // last sample
+wiced_timer_t mesh_sensor_buffer_timer;
+
+// Mapping of the tick count to TAI time received from the Time Server, and the presence changes stamped with the tick count
+sensor_time_map_t mesh_sensor_time_map;
+wiced_bool_t  mesh_sensor_time_requested = WICED_FALSE;
+uint32_t      mesh_sensor_time_request_time;        // tick count of the last Time Get
+mesh_sensor_occupancy_t mesh_sensor_occupancy[MESH_SENSOR_OCCUPANCY_LOG_SIZE];
+uint8_t       mesh_sensor_occupancy_first;          // oldest change in the log
+uint8_t       mesh_sensor_occupancy_count;          // number of changes in the log
+uint32_t      mesh_sensor_occupancy_dropped;        // changes overwritten before they have been read
+uint8_t       mesh_sensor_occupancy_batch;          // changes in the batch of the occupancy setting
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+// Mapping saved before HID-Off, kept until the time is received again if the sleep duration is not known
+sensor_time_map_t mesh_sensor_time_map_restored;
+uint8_t       mesh_sensor_occupancy_restored;       // oldest changes in the log which were recorded before HID-Off
+#endif
+
+// Presence rules evaluated on each presence change
+sensor_rule_engine_t mesh_sensor_rules;
+wiced_timer_t mesh_sensor_rule_timer;
+uint32_t      mesh_sensor_rule_actions;             // messages sent by the rules since power up
+uint32_t      mesh_sensor_rule_failures;            // messages which could not be sent
+
+// Commissioning mode state. Commissioning is measured only if the device has been powered up unprovisioned.
+wiced_timer_t mesh_sensor_commissioning_timer;
+wiced_bool_t  mesh_sensor_commissioning_active = WICED_FALSE;
+wiced_bool_t  mesh_sensor_commissioning_fast_adv = WICED_FALSE;
+uint16_t      mesh_sensor_commissioning_saved_adv_interval[2];
+mesh_sensor_commissioning_record_t mesh_sensor_commissioning;
+
+// PIR calibration tries the settings from the most sensitive one while the room is empty
+const mesh_sensor_pir_setting_t mesh_sensor_pir_settings[] =
+{
+    { 0x08, 0x00 },
+    { 0x10, 0x00 },
+    { 0x10, 0x01 },                                 // default setting
+    { 0x18, 0x01 },
+    { 0x20, 0x01 },
+    { 0x30, 0x02 },
+    { 0x40, 0x02 },
+    { 0x60, 0x03 },
+};
+#define MESH_SENSOR_PIR_SETTINGS_NUM    ((uint8_t)(sizeof(mesh_sensor_pir_settings) / sizeof(mesh_sensor_pir_setting_t)))
+
+wiced_timer_t mesh_sensor_calibration_timer;
+wiced_bool_t  mesh_sensor_calibration_ready = WICED_FALSE;   // PIR and calibration timer initialized
+uint8_t       mesh_sensor_calibration_state = MESH_SENSOR_CALIBRATION_IDLE;
+uint8_t       mesh_sensor_calibration_index;        // setting being observed
+uint8_t       mesh_sensor_calibration_budget;       // allowed false triggers per window
+uint16_t      mesh_sensor_calibration_window;       // observation window in seconds
+uint32_t      mesh_sensor_calibration_triggers;     // triggers in the current or the last window
+
+#ifdef OTA_DELTA_SUPPORTED
+// Delta OTA image received over WICED HCI and applied to the running image as it arrives
+sensor_delta_t mesh_sensor_delta;
+wiced_bool_t  mesh_sensor_delta_active = WICED_FALSE;
+#endif
+
+// GATT proxy connection state and connection time measurement
+wiced_bool_t  mesh_sensor_proxy_connected = WICED_FALSE;
+uint32_t      mesh_sensor_proxy_connect_time;       // tick count when the current connection was established
+uint32_t      mesh_sensor_proxy_connections;        // number of connections since power up
+uint32_t      mesh_sensor_proxy_connected_ms;       // total duration of completed connections
+
+// Motion to publication latency. Measured from the interrupt which detects presence to the publication of the presence.
+sensor_latency_t mesh_sensor_latency;
+uint32_t      mesh_sensor_latency_start_time;       // tick count when the latency statistics were reset
+uint32_t      mesh_sensor_latency_missed;           // presence ended before it has been published
+wiced_bool_t  mesh_sensor_motion_pending = WICED_FALSE;
+uint32_t      mesh_sensor_motion_time;              // tick count of the interrupt which detected presence
 
 // We define optional setting for the motion sensor, the Motion Threshold. Default is 80%.
 uint8_t       mesh_motion_sensor_threshold_val = 0x50;
 
+uint8_t       mesh_sensor_profile = SENSOR_PROFILE_BALANCED;
+uint8_t       mesh_sensor_profile_setting = SENSOR_PROFILE_BALANCED;   // profile in effect, as read with the profile setting
+uint8_t       mesh_sensor_rule_setting[SENSOR_RULE_ENCODED_LEN];    // rule last written, as kept in the rule table
+uint8_t       mesh_sensor_rule_setting_index;                       // index of the rule in the setting
+uint8_t       mesh_sensor_calibration_setting[MESH_SENSOR_CALIBRATION_SETTING_LEN];
+uint8_t       mesh_sensor_occupancy_setting[MESH_SENSOR_OCCUPANCY_SETTING_LEN];
+
+wiced_bt_mesh_sensor_config_setting_t mesh_element1_sensor_settings[] =
+{
+    {
+        .setting_property_id = MESH_SENSOR_PROFILE_SETTING_PROPERTY_ID,
+        .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,
+        .value_len           = 1,
+        .val                 = &mesh_sensor_profile_setting,
+    },
+    {
+        .setting_property_id = MESH_SENSOR_RULE_SETTING_PROPERTY_ID,
+        .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,
+        .value_len           = SENSOR_RULE_ENCODED_LEN,
+        .val                 = mesh_sensor_rule_setting,
+    },
+    {
+        .setting_property_id = MESH_SENSOR_CALIBRATION_SETTING_PROPERTY_ID,
+        .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,
+        .value_len           = MESH_SENSOR_CALIBRATION_SETTING_LEN,
+        .val                 = mesh_sensor_calibration_setting,
+    },
+    {
+        .setting_property_id = MESH_SENSOR_OCCUPANCY_SETTING_PROPERTY_ID,
+        .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,
+        .value_len           = MESH_SENSOR_OCCUPANCY_SETTING_LEN,
+        .val                 = mesh_sensor_occupancy_setting,
+    },
+};
+
 wiced_bt_mesh_core_config_model_t mesh_element1_models[] =
 {
     WICED_BT_MESH_DEVICE,
     WICED_BT_MESH_MODEL_SENSOR_SERVER,
+    WICED_BT_MESH_MODEL_TIME_CLIENT,
+    WICED_BT_MESH_MODEL_ONOFF_CLIENT,
+    WICED_BT_MESH_MODEL_LEVEL_CLIENT,
 };
 #define MESH_APP_NUM_MODELS  (sizeof(mesh_element1_models) / sizeof(wiced_bt_mesh_core_config_model_t))
 
@@ -200,7 +645,7 @@ wiced_bt_mesh_core_config_sensor_t mesh_element1_sensors[] =
             .measurement_period = MESH_MOTION_SENSOR_MEASUREMENT_PERIOD,
             .update_interval    = MESH_MOTION_SENSOR_UPDATE_INTERVAL,
         },
-        .data = (uint8_t*)&mesh_sensor_sent_value,
+        .data = mesh_sensor_sent_data,
         .cadence =
         {
             // Value 0 indicates that cadence does not change depending on the measurements
@@ -216,10 +661,14 @@ wiced_bt_mesh_core_config_sensor_t mesh_element1_sensors[] =
         },
         .num_series     = 0,
         .series_columns = NULL,
-        .num_settings   = 0,
-        .settings       = NULL,
+        .num_settings   = sizeof(mesh_element1_sensor_settings) / sizeof(wiced_bt_mesh_sensor_config_setting_t),
+        .settings       = mesh_element1_sensor_settings,
     },
 };
+#define MESH_SENSOR_NUM         (sizeof(mesh_element1_sensors) / sizeof(wiced_bt_mesh_core_config_sensor_t))
+
+// Add the entry of a new sensor to MESH_SENSOR_STATUS_LEN before changing the number of sensors
+SENSOR_CODEC_STATIC_ASSERT(MESH_SENSOR_NUM == 1, sensor_status_len);
 
 
 #define MESH_APP_NUM_PROPERTIES (sizeof(mesh_element1_properties) / sizeof(wiced_bt_mesh_core_config_property_t))
@@ -239,7 +688,7 @@ wiced_bt_mesh_core_config_element_t mesh_elements[] =
         .move_rollover = 0,                                              // If true when level gets to range_max during move operation, it switches to min, otherwise move stops.
         .properties_num = 0,                                             // Number of properties in the array models
         .properties = NULL,                                              // Array of properties in the element.
-        .sensors_num = 1,                                                // Number of properties in the array models
+        .sensors_num = MESH_SENSOR_NUM,                                  // Number of properties in the array models
         .sensors = mesh_element1_sensors,                                // Array of properties in the element.
         .models_num = MESH_APP_NUM_MODELS,                               // Number of models in the array models
         .models = mesh_element1_models,                                  // Array of models located in that element. Model data is defined by structure wiced_bt_mesh_core_config_model_t
@@ -294,12 +743,18 @@ wiced_bt_mesh_core_config_t  mesh_config =
  */
 wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table =
 {
-    mesh_app_init,                  // application initialization
+    MESH_APP_INIT,                  // application initialization
     NULL,                           // Default SDK platform button processing
-    NULL,                           // GATT connection status
+    mesh_app_gatt_conn_status,      // GATT connection status
     NULL,                           // attention processing
     mesh_app_notify_period_set,     // notify period set
+#if defined(HCI_CONTROL) && defined(STACK_PROFILE)
+    mesh_app_proc_rx_cmd_profiled,  // WICED HCI command
+#elif defined(HCI_CONTROL)
+    mesh_app_proc_rx_cmd,           // WICED HCI command
+#else
     NULL,                           // WICED HCI command
+#endif
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
     mesh_sensor_motion_lpn_sleep,   // LPN sleep
 #else
@@ -326,6 +781,7 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 #endif
     wiced_result_t result;
     wiced_bt_mesh_core_config_sensor_t *p_sensor;
+    mesh_sensor_pir_setting_t pir_setting;
 
     // This means that device came out of HID off mode and it is not a power cycle
     if(wiced_hal_mia_is_reset_reason_por())
@@ -334,7 +790,7 @@ void mesh_app_init(wiced_bool_t is_provisioned)
     }
     else
     {
-#if CYW20819A1
+#if defined(CYW20819A1) || defined(CYW20835B1)
         if(wiced_hal_mia_is_reset_reason_hid_timeout())
         {
             WICED_BT_TRACE("Wake from HID off: timed wake\n");
@@ -347,6 +803,20 @@ void mesh_app_init(wiced_bool_t is_provisioned)
         }
     }
 
+    // Profile selected by the setting. Friendship parameters are taken by the mesh core at start up.
+    wiced_hal_read_nvram(MESH_MOTION_SENSOR_PROFILE_VSID, sizeof(mesh_sensor_profile), &mesh_sensor_profile, &result);
+    if (mesh_sensor_profile >= SENSOR_PROFILE_MAX)
+        mesh_sensor_profile = SENSOR_PROFILE_BALANCED;
+    mesh_sensor_profile_setting = mesh_sensor_profile;
+    e93196_usr_cfg.e93196_init_reg.blind_time = sensor_profiles[mesh_sensor_profile].blind_time * 2;
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    // Poll settings tuned for the installation replace the ones of the profile
+    wiced_hal_read_nvram(MESH_MOTION_SENSOR_LPN_POLL_VSID, sizeof(mesh_sensor_lpn_poll), (uint8_t *)&mesh_sensor_lpn_poll, &result);
+    mesh_config.low_power.poll_timeout = sensor_lpn_poll_timeout(&mesh_sensor_lpn_poll, &sensor_profiles[mesh_sensor_profile]);
+    if (mesh_sensor_lpn_poll.receive_delay != 0)
+        mesh_config.low_power.receive_delay = mesh_sensor_lpn_poll.receive_delay;
+#endif
+
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
     wiced_bt_cfg_settings.device_name = (uint8_t *)"Motion Sensor LPN";
 #else
@@ -365,6 +835,18 @@ void mesh_app_init(wiced_bool_t is_provisioned)
     mesh_prop_fw_version[6] = wiced_bt_mesh_base64_encode_6bits((uint8_t)(WICED_SDK_BUILD_NUMBER >> 6) & 0x3f);
     mesh_prop_fw_version[7] = wiced_bt_mesh_base64_encode_6bits((uint8_t)WICED_SDK_BUILD_NUMBER & 0x3f);
 
+#ifdef REMOTE_PROVISION_SERVER_SUPPORTED
+    sensor_motion_rpr_init(mesh_element1_models, MESH_APP_NUM_MODELS);
+#endif
+#ifdef MESH_DFU_SUPPORTED
+    sensor_motion_dfu_init(mesh_element1_models, MESH_APP_NUM_MODELS);
+#endif
+#ifdef MESH_SENSOR_RELAY_ELECTION
+    // The relay feature stays in the Composition Data, the election changes only the Relay state
+    wiced_hal_read_nvram(MESH_MOTION_SENSOR_RELAY_VSID, sizeof(mesh_sensor_relay_state), &mesh_sensor_relay_state, &result);
+    sensor_relay_init(mesh_element1_models, MESH_APP_NUM_MODELS, 0);
+#endif
+
     // Adv Data is fixed. Spec allows to put URI, Name, Appearance and Tx Power in the Scan Response Data.
     if (!is_provisioned)
     {
@@ -386,13 +868,33 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 
         wiced_bt_mesh_set_raw_scan_response_data(num_elem, adv_elem);
 
-        wiced_bt_mesh_model_sensor_server_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, mesh_sensor_server_report_handler, mesh_sensor_server_config_change_handler, is_provisioned);
+        mesh_sensor_commissioning_start();
+
+        wiced_bt_mesh_model_sensor_server_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_SENSOR_SERVER_REPORT_HANDLER, MESH_SENSOR_SERVER_CONFIG_CHANGE_HANDLER, is_provisioned);
         return;
     }
 
     p_sensor = &mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX];
 
+    mesh_sensor_commissioning_provisioned();
+
+    // PIR interrupts and timer expirations are processed from the deferred event queue
+    sensor_motion_event_init(mesh_sensor_event_handler);
+#ifdef SYNTHETIC_MOTION
+    sensor_workload_init();
+    sensor_workload_set_blind_time(sensor_profiles[mesh_sensor_profile].blind_time * 1000);
+#endif
+
+    // PIR setting selected by the calibration of this installation
+    if (wiced_hal_read_nvram(MESH_MOTION_SENSOR_PIR_SETTING_VSID, sizeof(pir_setting), (uint8_t *)&pir_setting, &result) == sizeof(pir_setting))
+    {
+        e93196_usr_cfg.e93196_init_reg.sensitivity = pir_setting.sensitivity;
+        e93196_usr_cfg.e93196_init_reg.pulse_cnt   = pir_setting.pulse_cnt;
+    }
     e93196_init(&e93196_usr_cfg, e93196_int_proc, NULL);
+    wiced_init_timer(&mesh_sensor_calibration_timer, mesh_sensor_calibration_timer_callback, 0, WICED_SECONDS_TIMER);
+    mesh_sensor_calibration_ready = WICED_TRUE;
+    mesh_sensor_calibration_setting_update();
 
     // initialize the cadence timer.  Need a timer for each element because each sensor model can be
     // configured for different publication period.  This app has only one sensor.
@@ -400,10 +902,46 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 
     wiced_init_timer(&mesh_sensor_presence_detected_timer, mesh_sensor_presence_detected_timer_callback, (TIMER_PARAM_TYPE)&mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX], WICED_SECONDS_TIMER);
 
+    wiced_init_timer(&mesh_sensor_publish_deferred_timer, mesh_sensor_publish_deferred_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+
+    mesh_sensor_buffer_stats_reset();
+    wiced_init_timer(&mesh_sensor_buffer_timer, mesh_sensor_buffer_timer_callback, 0, WICED_SECONDS_TIMER);
+    wiced_start_timer(&mesh_sensor_buffer_timer, MESH_SENSOR_BUFFER_SAMPLE_INTERVAL);
+
+    // restore the presence rules, OnOff and Level clients send the messages of the rules
+    sensor_rule_init(&mesh_sensor_rules);
+    wiced_hal_read_nvram(MESH_MOTION_SENSOR_RULE_VSID, sizeof(mesh_sensor_rules.rules), (uint8_t *)mesh_sensor_rules.rules, &result);
+    mesh_sensor_rule_setting_update(0);
+    wiced_init_timer(&mesh_sensor_rule_timer, mesh_sensor_rule_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+    wiced_bt_mesh_model_onoff_client_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, mesh_sensor_rule_client_callback, is_provisioned);
+    wiced_bt_mesh_model_level_client_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, mesh_sensor_rule_client_callback, is_provisioned);
+
+    // The tick count restarts on power up and on wake from HID-Off, the time has to be received again.
+    // The presence change log and the delayed rules saved before HID-Off are restored.
+    sensor_time_map_reset(&mesh_sensor_time_map);
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    mesh_sensor_occupancy_restore();
+#endif
+    wiced_bt_mesh_model_time_client_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, mesh_sensor_time_client_callback, is_provisioned);
+    mesh_sensor_occupancy_setting_update();
+    mesh_sensor_time_request();
+
     //restore the cadence from NVRAM
     wiced_hal_read_nvram( MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &result);
 
-    wiced_bt_mesh_model_sensor_server_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, mesh_sensor_server_report_handler, mesh_sensor_server_config_change_handler, is_provisioned);
+    // restore the zone group from NVRAM, presence changes are sent to the model publication if it is not configured
+    wiced_hal_read_nvram(MESH_MOTION_SENSOR_ZONE_VSID, sizeof(mesh_sensor_zone), (uint8_t *)&mesh_sensor_zone, &result);
+
+#ifdef MESH_SENSOR_RELAY_ELECTION
+    // neighbours of the zone are heard through the presence changes they send to the zone group
+    sensor_relay_set_direct_ttl((mesh_sensor_zone.addr != 0) ? mesh_sensor_zone.ttl : 0);
+    wiced_init_timer(&mesh_sensor_relay_election_timer, mesh_sensor_relay_election_timer_callback, 0, WICED_SECONDS_TIMER);
+    wiced_start_timer(&mesh_sensor_relay_election_timer, MESH_SENSOR_RELAY_ELECTION_INTERVAL);
+#endif
+
+    sensor_rate_limit_init(&mesh_sensor_rate_limit, SENSOR_PUBLISH_RATE_LIMIT_BURST, mesh_sensor_rate_limit_interval(), wiced_bt_mesh_core_get_tick_count());
+
+    wiced_bt_mesh_model_sensor_server_init(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_SENSOR_SERVER_REPORT_HANDLER, MESH_SENSOR_SERVER_CONFIG_CHANGE_HANDLER, is_provisioned);
 
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
     if (!do_not_init_again)
@@ -431,6 +969,40 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 #endif
 }
 
+/*
+ * GATT connection status. While a phone is connected through the proxy the device does not
+ * sleep and publishes with the short min interval, so that configuration round trips are fast.
+ * Low power policy is restored on disconnect.
+ */
+void mesh_app_gatt_conn_status(wiced_bt_gatt_connection_status_t *p_status)
+{
+    uint32_t current_time = wiced_bt_mesh_core_get_tick_count();
+
+    WICED_BT_TRACE("gatt conn status connected:%d conn_id:%d\n", p_status->connected, p_status->conn_id);
+
+    if (p_status->connected == mesh_sensor_proxy_connected)
+        return;
+
+    mesh_sensor_proxy_connected = p_status->connected;
+    if (mesh_sensor_proxy_connected)
+    {
+        mesh_sensor_proxy_connections++;
+        mesh_sensor_proxy_connect_time = current_time;
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+        app_state.lpn_state = MESH_LPN_STATE_NOT_IDLE;
+#endif
+    }
+    else
+    {
+        mesh_sensor_proxy_connected_ms += current_time - mesh_sensor_proxy_connect_time;
+        WICED_BT_TRACE("gatt connection time:%dms\n", current_time - mesh_sensor_proxy_connect_time);
+    }
+
+    // Min interval has changed, timer runs only if the device is configured to publish periodically
+    if (mesh_sensor_publish_period != 0)
+        mesh_sensor_server_restart_timer(&mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX]);
+}
+
 /*
  * New publication period is set. If it is for the sensor model, this application should take care of it.
  * The period may need to be adjusted based on the divisor.
@@ -455,39 +1027,57 @@ wiced_bool_t mesh_app_notify_period_set(uint8_t element_idx, uint16_t company_id
  */
 void mesh_sensor_server_restart_timer(wiced_bt_mesh_core_config_sensor_t *p_sensor)
 {
-    // If there are no specific cadence settings, publish every publish period.
-    uint32_t timeout = mesh_sensor_publish_period;
+    sensor_publish_config_t config;
+    uint32_t timeout;
 
     wiced_stop_timer(&mesh_sensor_cadence_timer);
+
+    mesh_sensor_publish_config(p_sensor, &config);
+    timeout = sensor_publish_timer_timeout(&config, &mesh_sensor_fast_publish_period);
     if (timeout == 0)
     {
         WICED_BT_TRACE("sensor restart timer period:%d\n", mesh_sensor_publish_period);
         return;
     }
-    // If fast cadence period divisor is set, we need to check data more
-    // often than publication period.  Publish if measurement is in specified range
-    if (p_sensor->cadence.fast_cadence_period_divisor > 1)
-    {
-        timeout = mesh_sensor_publish_period / p_sensor->cadence.fast_cadence_period_divisor;
-        mesh_sensor_fast_publish_period = timeout ;
-        WICED_BT_TRACE("sensor fast cadence:%d\n", mesh_sensor_fast_publish_period);
-    }
-    else
-    {
-        mesh_sensor_fast_publish_period = 0;
-        WICED_BT_TRACE("sensor fast pub period:0 cadence devisor:%d\n", p_sensor->cadence.fast_cadence_period_divisor);
-    }
-    // should not send data more often than min_interval
-    if ((p_sensor->cadence.min_interval != 0) && (p_sensor->cadence.min_interval > timeout) &&
-        ((p_sensor->cadence.trigger_delta_up != 0) || (p_sensor->cadence.trigger_delta_down != 0)))
-    {
-        timeout = p_sensor->cadence.min_interval;
-        WICED_BT_TRACE("sensor min interval:%d\n", timeout);
-    }
-    WICED_BT_TRACE("sensor restart timer:%d\n", timeout);
+    WICED_BT_TRACE("sensor restart timer:%d fast pub period:%d cadence divisor:%d\n", timeout, mesh_sensor_fast_publish_period,
+                   p_sensor->cadence.fast_cadence_period_divisor);
     mesh_sensor_sleep_max_time = timeout;
     wiced_start_timer(&mesh_sensor_cadence_timer, timeout);
+    mesh_sensor_cadence_stats.timer_rearms++;
+}
+
+/*
+ * State of the device the publication decisions depend on
+ */
+void mesh_sensor_publish_config(wiced_bt_mesh_core_config_sensor_t *p_sensor, sensor_publish_config_t *p_config)
+{
+    p_config->p_cadence       = &p_sensor->cadence;
+    p_config->publish_period  = mesh_sensor_publish_period;
+    p_config->zone            = (mesh_sensor_zone.addr != 0);
+    p_config->proxy_connected = mesh_sensor_proxy_connected;
+#ifdef MESH_DFU_SUPPORTED
+    p_config->dfu_transfer    = sensor_motion_dfu_transfer_active();
+#else
+    p_config->dfu_transfer    = WICED_FALSE;
+#endif
+}
+
+#ifdef STACK_PROFILE
+void mesh_app_init_profiled(wiced_bool_t is_provisioned)
+{
+    SENSOR_STACK_PROFILE(SENSOR_STACK_APP_INIT, mesh_app_init(is_provisioned));
+}
+
+void mesh_sensor_server_report_handler_profiled(uint16_t event, uint8_t element_idx, void *p_get_data, void *p_ref_data)
+{
+    SENSOR_STACK_PROFILE(SENSOR_STACK_REPORT_HANDLER, mesh_sensor_server_report_handler(event, element_idx, p_get_data, p_ref_data));
+}
+
+void mesh_sensor_server_config_change_handler_profiled(uint8_t element_idx, uint16_t event, void* p_data)
+{
+    SENSOR_STACK_PROFILE(SENSOR_STACK_CONFIG_CHANGE_HANDLER, mesh_sensor_server_config_change_handler(element_idx, event, p_data));
 }
+#endif
 
 /*
  * Process the configuration changes set by the Sensor Client.
@@ -520,7 +1110,7 @@ void mesh_sensor_server_report_handler(uint16_t event, uint8_t element_idx, void
     {
     case WICED_BT_MESH_SENSOR_GET:
         // tell mesh models library that data is ready to be shipped out, the library will get data from mesh_config
-        mesh_sensor_sent_value = presence_detected;
+        mesh_sensor_prepare_status();
         wiced_bt_mesh_model_sensor_server_data(element_idx, p_sensor_get->property_id, p_ref_data);
         break;
 
@@ -555,8 +1145,8 @@ void mesh_sensor_server_process_cadence_changed(uint8_t element_idx, wiced_bt_me
     WICED_BT_TRACE("Fast cadence low:%d\n", p_sensor->cadence.fast_cadence_low);
     WICED_BT_TRACE("Fast cadence high:%d\n", p_sensor->cadence.fast_cadence_high);
 
-    /* save cadence to NVRAM */
-    written_byte = wiced_hal_write_nvram( MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &status);
+    /* save cadence to NVRAM, write is skipped if the cadence has not changed */
+    written_byte = sensor_motion_nvram_write( MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &status);
     WICED_BT_TRACE("NVRAM write: %d\n", written_byte);
 
     mesh_sensor_server_restart_timer(p_sensor);
@@ -566,145 +1156,222 @@ void mesh_sensor_server_process_cadence_changed(uint8_t element_idx, wiced_bt_me
 }
 
 /*
- * Publication timer callback.  Need to send data if publish period expired, or
+ * Publication timer callback.  The work is done from the event queue.
+ */
+void mesh_sensor_publish_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PUBLISH_TIMER, (void *)arg);
+}
+
+/*
+ * Publication timer processing.  Need to send data if publish period expired, or
  * if value has changed more than specified in the triggers, or if value is in range
  * of fast cadence values and fast cadence interval expired.
  */
-void mesh_sensor_publish_timer_callback(TIMER_PARAM_TYPE arg)
+void mesh_sensor_publish_timer_process(wiced_bt_mesh_core_config_sensor_t *p_sensor)
 {
-    wiced_bt_mesh_event_t *p_event;
-    wiced_bt_mesh_core_config_sensor_t *p_sensor = (wiced_bt_mesh_core_config_sensor_t *)arg;
-    wiced_bool_t pub_needed = WICED_FALSE;
-    uint32_t current_time = wiced_bt_mesh_core_get_tick_count();
+    sensor_publish_config_t config;
     int32_t current_value = mesh_sensor_get_current_value();
+    uint32_t elapsed = wiced_bt_mesh_core_get_tick_count() - mesh_sensor_pub_time;
+
+    mesh_sensor_cadence_stats.evaluations++;
+
+    WICED_BT_TRACE("cadence cur value:%d sent:%d time since last pub:%d\n", current_value, mesh_sensor_pub_value, elapsed);
 
-    if ((p_sensor->cadence.min_interval != 0) && ((current_time - mesh_sensor_pub_time) < p_sensor->cadence.min_interval))
+    mesh_sensor_publish_config(p_sensor, &config);
+    if (sensor_publish_on_timer(&config, elapsed, mesh_sensor_fast_publish_period, current_value, mesh_sensor_pub_value))
     {
-        WICED_BT_TRACE("time since last pub:%d less then cadence interval:%d\n", current_time - mesh_sensor_pub_time, p_sensor->cadence.min_interval);
+        WICED_BT_TRACE("Pub needed\n");
+        mesh_sensor_publish(SENSOR_PUBLISH_GATEWAY);
     }
-    else
+    mesh_sensor_server_restart_timer(p_sensor);
+}
+
+/*
+ * Process setting change
+ */
+void mesh_sensor_server_process_setting_changed(uint8_t element_idx, wiced_bt_mesh_sensor_setting_status_data_t* p_data)
+{
+    WICED_BT_TRACE("settings changed sensor, prop_id:%x, setting prop_id:%x\n", p_data->property_id, p_data->setting.setting_property_id);
+
+    if (p_data->setting.setting_property_id == MESH_SENSOR_PROFILE_SETTING_PROPERTY_ID)
     {
-        // check if publication timer expired
-        if ((mesh_sensor_publish_period != 0) && (current_time - mesh_sensor_pub_time >= mesh_sensor_publish_period))
-        {
-            WICED_BT_TRACE("Pub needed period\n");
-            pub_needed = WICED_TRUE;
-        }
-        // still need to send if publication timer has not expired, but triggers are configured, and value
-        // changed too much
-        if (!pub_needed && ((p_sensor->cadence.trigger_delta_up != 0) || (p_sensor->cadence.trigger_delta_down != 0)))
-        {
-            if (!p_sensor->cadence.trigger_type_percentage)
-            {
-                WICED_BT_TRACE("Native cur value:%d sent:%d delta:%d/%d\n",
-                        current_value, mesh_sensor_pub_value, p_sensor->cadence.trigger_delta_up, p_sensor->cadence.trigger_delta_down);
-
-                if (((p_sensor->cadence.trigger_delta_up != 0)   && (current_value >= (mesh_sensor_pub_value + p_sensor->cadence.trigger_delta_up)))
-                 || ((p_sensor->cadence.trigger_delta_down != 0) && (current_value <= (mesh_sensor_pub_value - p_sensor->cadence.trigger_delta_down))))
-                {
-                    WICED_BT_TRACE("Pub needed native value\n");
-                    pub_needed = WICED_TRUE;
-                }
-            }
-            else
-            {
-                // need to calculate percentage of the increase or decrease.  The deltas are in 0.01%.
-                if ((p_sensor->cadence.trigger_delta_up != 0) && (current_value > mesh_sensor_pub_value))
-                {
-                    WICED_BT_TRACE("Delta up:%d\n", ((uint32_t)(current_value - mesh_sensor_pub_value) * 10000 / current_value));
-                    if (((uint32_t)(current_value - mesh_sensor_pub_value) * 10000 / current_value) > p_sensor->cadence.trigger_delta_up)
-                    {
-                        WICED_BT_TRACE("Pub needed percent delta up:%d\n", ((current_value - mesh_sensor_pub_value) * 10000 / current_value));
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else if ((p_sensor->cadence.trigger_delta_down != 0) && (current_value < mesh_sensor_pub_value))
-                {
-                    WICED_BT_TRACE("Delta down:%d\n", ((uint32_t)(mesh_sensor_pub_value - current_value) * 10000 / current_value));
-                    if (((uint32_t)(mesh_sensor_pub_value - current_value) * 10000 / current_value) > p_sensor->cadence.trigger_delta_down)
-                    {
-                        WICED_BT_TRACE("Pub needed percent delta down:%d\n", ((mesh_sensor_pub_value - current_value) * 10000 / current_value));
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-            }
-        }
-        // may still need to send if fast publication is configured
-        if (!pub_needed && (mesh_sensor_fast_publish_period != 0))
+        if (p_data->setting.value_len < 1)
+            WICED_BT_TRACE("invalid profile setting len:%d\n", p_data->setting.value_len);
+        else
+            mesh_sensor_profile_set(p_data->setting.val[0]);
+        // the setting may have been overwritten with the rejected value
+        mesh_sensor_profile_setting = mesh_sensor_profile;
+    }
+    else if (p_data->setting.setting_property_id == MESH_SENSOR_RULE_SETTING_PROPERTY_ID)
+        mesh_sensor_rule_set(p_data->setting.val, p_data->setting.value_len);
+    else if (p_data->setting.setting_property_id == MESH_SENSOR_CALIBRATION_SETTING_PROPERTY_ID)
+    {
+        if (p_data->setting.value_len < MESH_SENSOR_CALIBRATION_SETTING_WRITE_LEN)
+            WICED_BT_TRACE("invalid calibration setting len:%d\n", p_data->setting.value_len);
+        else
+            mesh_sensor_calibration_start(p_data->setting.val[0] | (p_data->setting.val[1] << 8), p_data->setting.val[2]);
+        // the setting may have been overwritten with the written value
+        mesh_sensor_calibration_setting_update();
+    }
+    else if (p_data->setting.setting_property_id == MESH_SENSOR_OCCUPANCY_SETTING_PROPERTY_ID)
+    {
+        // the client acknowledges the number of changes it received with the last read
+        if ((p_data->setting.value_len < 1) || (p_data->setting.val[0] > mesh_sensor_occupancy_batch))
         {
-            // check if fast publish period expired
-            if (current_time - mesh_sensor_pub_time >= mesh_sensor_fast_publish_period)
-            {
-                // if cadence high is more than cadence low, to publish, the value should be in range
-                if (p_sensor->cadence.fast_cadence_high > p_sensor->cadence.fast_cadence_low)
-                {
-                    if ((current_value > p_sensor->cadence.fast_cadence_low) &&
-                        (current_value <= p_sensor->cadence.fast_cadence_high))
-                    {
-                        WICED_BT_TRACE("Pub needed in range\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else if (p_sensor->cadence.fast_cadence_high < p_sensor->cadence.fast_cadence_low)
-                {
-                    if ((current_value >= p_sensor->cadence.fast_cadence_low) ||
-                        (current_value < p_sensor->cadence.fast_cadence_high))
-                    {
-                        WICED_BT_TRACE("Pub needed out of range\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else // p_sensor->cadence.fast_cadence_high == p_sensor->cadence.fast_cadence_low
-                {
-                    // publish if current value is the same as cadence high/low
-                    if (current_value == p_sensor->cadence.fast_cadence_low)
-                    {
-                        WICED_BT_TRACE("Pub needed equal\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-            }
+            WICED_BT_TRACE("invalid occupancy ack len:%d\n", p_data->setting.value_len);
+            mesh_sensor_occupancy_setting_update();
         }
-        if (pub_needed)
+        else
         {
-            mesh_sensor_publish();
+            mesh_sensor_occupancy_remove(p_data->setting.val[0]);
+            mesh_sensor_time_request();
         }
     }
-    mesh_sensor_server_restart_timer(p_sensor);
 }
 
 /*
- * Process setting change
+ * Switch to the performance profile. Blind time and min interval are applied immediately,
+ * the poll timeout of the Low Power Node when the device restarts. An unknown profile is
+ * rejected and the profile in effect is kept.
  */
-void mesh_sensor_server_process_setting_changed(uint8_t element_idx, wiced_bt_mesh_sensor_setting_status_data_t* p_data)
+void mesh_sensor_profile_set(uint8_t profile)
 {
-    WICED_BT_TRACE("settings changed sensor, prop_id:%x, setting prop_id:%x\n", p_data->property_id, p_data->setting.setting_property_id);
+    wiced_bt_mesh_core_config_sensor_t *p_sensor = &mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX];
+    wiced_result_t result;
+
+    if (profile >= SENSOR_PROFILE_MAX)
+    {
+        WICED_BT_TRACE("invalid profile:%d\n", profile);
+        return;
+    }
+    mesh_sensor_profile = profile;
+    WICED_BT_TRACE("profile:%d\n", profile);
+
+    e93196_usr_cfg.e93196_init_reg.blind_time = sensor_profiles[profile].blind_time * 2;
+    e93196_reg_update(&e93196_usr_cfg);
+#ifdef SYNTHETIC_MOTION
+    sensor_workload_set_blind_time(sensor_profiles[profile].blind_time * 1000);
+#endif
+
+    // min interval is a part of the cadence, it is saved with it and can be changed later by the Sensor Client
+    p_sensor->cadence.min_interval = sensor_profiles[profile].min_interval;
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t *)&p_sensor->cadence, &result);
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_PROFILE_VSID, sizeof(mesh_sensor_profile), &mesh_sensor_profile, &result);
 
+    // the cadence timer and the rate limiter run at the min interval of the new profile, a deferred
+    // publication is retried with the refilled bucket
+    mesh_sensor_server_restart_timer(p_sensor);
+    sensor_rate_limit_init(&mesh_sensor_rate_limit, SENSOR_PUBLISH_RATE_LIMIT_BURST, mesh_sensor_rate_limit_interval(), wiced_bt_mesh_core_get_tick_count());
+    if (mesh_sensor_publish_pending != 0)
+        sensor_motion_event_post(SENSOR_MOTION_EVENT_PUBLISH_DEFERRED, NULL);
 }
 
+/*
+ * PIR sensor interrupt. Only clear the interrupt and defer the processing, repeated
+ * interrupts are coalesced until the event is processed.
+ */
 void e93196_int_proc(void* data, uint8_t port_pin)
 {
-    WICED_BT_TRACE("presence detected TRUE\n");
     e93196_int_clean(port_pin);
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PRESENCE_DETECTED, NULL);
+}
+
+void mesh_sensor_presence_detected_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PRESENCE_TIMEOUT, NULL);
+}
+
+/*
+ * Process events deferred from the interrupt and timer callbacks
+ */
+void mesh_sensor_event_handler(sensor_motion_event_t *p_event)
+{
+    switch (p_event->type)
+    {
+    case SENSOR_MOTION_EVENT_PRESENCE_DETECTED:
+        mesh_sensor_presence_detected(p_event->timestamp, p_event->count);
+        break;
+
+    case SENSOR_MOTION_EVENT_PRESENCE_TIMEOUT:
+        mesh_sensor_presence_timeout();
+        break;
+
+    case SENSOR_MOTION_EVENT_PUBLISH_TIMER:
+        mesh_sensor_publish_timer_process((wiced_bt_mesh_core_config_sensor_t *)p_event->p_arg);
+        break;
+
+    case SENSOR_MOTION_EVENT_PUBLISH_DEFERRED:
+        if (mesh_sensor_publish_pending != 0)
+            mesh_sensor_publish(0);
+        break;
+
+    case SENSOR_MOTION_EVENT_CALIBRATION:
+        mesh_sensor_calibration_step();
+        break;
 
-    // We disable interrupts for MESH_PRESENCE_DETECTED_BLIND_TIME.  If interrupt does not happen within
-    // MESH_PRESENCE_DETECTED_BLIND_TIME * 2, we assume that there is no presence anymore
-    wiced_start_timer(&mesh_sensor_presence_detected_timer, 2 * MESH_PRESENCE_DETECTED_BLIND_TIME);
+    case SENSOR_MOTION_EVENT_BUFFER_SAMPLE:
+        mesh_sensor_buffer_sample();
+        wiced_start_timer(&mesh_sensor_buffer_timer, MESH_SENSOR_BUFFER_SAMPLE_INTERVAL);
+        break;
+
+    case SENSOR_MOTION_EVENT_RULE:
+        mesh_sensor_rule_timer_restart(sensor_rule_expired(&mesh_sensor_rules, wiced_bt_mesh_core_get_tick_count(), mesh_sensor_rule_action));
+        break;
+
+#ifdef MESH_SENSOR_RELAY_ELECTION
+    case SENSOR_MOTION_EVENT_RELAY_ELECTION:
+        mesh_sensor_relay_election();
+        break;
+#endif
+    }
+}
+
+void mesh_sensor_presence_detected(uint32_t timestamp, uint8_t count)
+{
+    WICED_BT_TRACE("presence detected TRUE time:%d interrupts:%d\n", timestamp, count);
+
+    // The room is declared empty during calibration, every trigger is a false one and is not published
+    if (mesh_sensor_calibration_state == MESH_SENSOR_CALIBRATION_RUNNING)
+    {
+        mesh_sensor_calibration_triggers += count;
+        return;
+    }
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    if (app_state.lpn_state == MESH_LPN_STATE_IDLE)
+        mesh_sensor_lpn_stats.motion_wakes++;
+#endif
+
+    // We disable interrupts for the blind time of the profile.  If interrupt does not happen within
+    // blind time * 2, we assume that there is no presence anymore
+    wiced_start_timer(&mesh_sensor_presence_detected_timer, 2 * sensor_profiles[mesh_sensor_profile].blind_time);
 
     if (!presence_detected)
     {
         presence_detected = WICED_TRUE;
+        mesh_sensor_motion_pending = WICED_TRUE;
+        mesh_sensor_motion_time = timestamp;
+        mesh_sensor_occupancy_log(WICED_TRUE, timestamp);
+        mesh_sensor_value_generation++;
         mesh_sensor_value_changed(&mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX]);
     }
 }
 
-void mesh_sensor_presence_detected_timer_callback(TIMER_PARAM_TYPE arg)
+void mesh_sensor_presence_timeout(void)
 {
     WICED_BT_TRACE("presence detected FALSE\n");
 
     if (presence_detected)
     {
         presence_detected = WICED_FALSE;
+        if (mesh_sensor_motion_pending)
+        {
+            mesh_sensor_motion_pending = WICED_FALSE;
+            mesh_sensor_latency_missed++;
+        }
+        mesh_sensor_occupancy_log(WICED_FALSE, wiced_bt_mesh_core_get_tick_count());
+        mesh_sensor_value_generation++;
         mesh_sensor_value_changed(&mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX]);
     }
 }
@@ -714,57 +1381,453 @@ void mesh_sensor_presence_detected_timer_callback(TIMER_PARAM_TYPE arg)
  */
 void mesh_sensor_value_changed(wiced_bt_mesh_core_config_sensor_t* p_sensor)
 {
-    int32_t current_value;
-    uint32_t current_time;
+    sensor_publish_config_t config;
+    uint8_t decision;
+
+    // Local actuation does not depend on the publication of the value
+    mesh_sensor_rule_timer_restart(sensor_rule_transition(&mesh_sensor_rules, presence_detected ? SENSOR_RULE_TRIGGER_OCCUPIED : SENSOR_RULE_TRIGGER_VACANT,
+                                                          wiced_bt_mesh_core_get_tick_count(), mesh_sensor_rule_action));
+
+    // The change goes to the zone group as it happens, the reports of the cadence to the gateway.
+    // If sensor is configured for periodic publication, the publication to the gateway follows the period.
+    mesh_sensor_publish_config(p_sensor, &config);
+    decision = sensor_publish_on_change(&config, wiced_bt_mesh_core_get_tick_count() - mesh_sensor_pub_time,
+                                        mesh_sensor_get_current_value(), mesh_sensor_pub_value);
+    if (decision & SENSOR_PUBLISH_EVALUATED)
+        mesh_sensor_cadence_stats.evaluations++;
+    else
+        WICED_BT_TRACE("sensor value change ignored will publish on timeout\n");
 
-    // If sensor is configured for periodic publication, don't need to do anything because
-    // value will be published on schedule
-    if (mesh_sensor_publish_period != 0)
+    if (decision & SENSOR_PUBLISH_DST_MASK)
+        mesh_sensor_publish(decision & SENSOR_PUBLISH_DST_MASK);
+    if (decision & SENSOR_PUBLISH_RESTART_TIMER)
+        mesh_sensor_server_restart_timer(p_sensor);
+}
+
+/*
+ * Publish Sensor Data. Presence changes go to the zone group with a small TTL, so that they reach
+ * the local lights fast without flooding the whole mesh. Reports of the cadence go to the publication
+ * address configured for the Sensor Server model, for example the gateway.
+ */
+void mesh_sensor_publish(uint8_t dst)
+{
+    uint32_t current_time = wiced_bt_mesh_core_get_tick_count();
+    uint32_t interval = mesh_sensor_rate_limit_interval();
+    uint32_t wait;
+
+    // Publication that is not allowed now is coalesced with the other deferred ones to the same
+    // destination. The value is read when it is finally sent, so the last state is always published.
+    // Each message takes a token, the zone is served first because the lights wait for it. The timer
+    // is restarted on every refusal, including the deferred publication itself, because the interval
+    // may have grown since the timer was started.
+    mesh_sensor_publish_pending |= dst;
+    while ((dst = sensor_publish_next(&mesh_sensor_publish_pending, &mesh_sensor_rate_limit, interval, current_time, &wait)) != 0)
+        mesh_sensor_publish_send(dst, current_time);
+
+    if (mesh_sensor_publish_pending != 0)
     {
-        WICED_BT_TRACE("sensor value change ignored will publish on timeout\n");
+        wiced_start_timer(&mesh_sensor_publish_deferred_timer, wait);
+        WICED_BT_TRACE("pub rate limited, deferred:%x\n", mesh_sensor_publish_pending);
         return;
     }
+    if (wiced_is_timer_in_use(&mesh_sensor_publish_deferred_timer))
+        wiced_stop_timer(&mesh_sensor_publish_deferred_timer);
+}
+
+/*
+ * Send Sensor Status to one destination. Only the publication to the gateway is the reference of
+ * the cadence, the zone group does not receive the reports the cadence is evaluated against.
+ */
+void mesh_sensor_publish_send(uint8_t dst, uint32_t current_time)
+{
+    wiced_bt_mesh_event_t *p_event = NULL;
+
+    if (dst == SENSOR_PUBLISH_ZONE)
+    {
+        // zone may have been removed while the publication was deferred
+        if (mesh_sensor_zone.addr == 0)
+            return;
+
+        p_event = wiced_bt_mesh_create_event(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV,
+                                             mesh_sensor_zone.addr, mesh_sensor_zone.app_key_idx);
+        if (p_event == NULL)
+        {
+            mesh_sensor_buffer_stats.event_failures++;
+            return;
+        }
+        p_event->ttl = mesh_sensor_zone.ttl;
+    }
+
+    mesh_sensor_prepare_status();
+    if (dst == SENSOR_PUBLISH_GATEWAY)
+    {
+        mesh_sensor_pub_value = mesh_sensor_sent_value;
+        mesh_sensor_pub_time = current_time;
+    }
+    mesh_sensor_cadence_stats.publishes++;
+    mesh_sensor_commissioning_published();
+
+    if (mesh_sensor_motion_pending && mesh_sensor_sent_value)
+    {
+        mesh_sensor_motion_pending = WICED_FALSE;
+        sensor_latency_record(&mesh_sensor_latency, current_time - mesh_sensor_motion_time);
+    }
 
-    // When periodic publishing is disabled, however, the behavior triggered by a change in
-    // the Sensor Data state shall depend on whether the Sensor Cadence state has been configured
-    if ((p_sensor->cadence.fast_cadence_period_divisor == 1) && (p_sensor->cadence.trigger_delta_up == 0) && (p_sensor->cadence.trigger_delta_down == 0))
+    WICED_BT_TRACE("*** Pub value:%d time:%d dst:%04x\n", mesh_sensor_sent_value, current_time, (p_event != NULL) ? p_event->dst : 0);
+    mesh_sensor_buffer_sample();
+    mesh_sensor_buffer_stats.publishes++;
+    if (wiced_bt_mesh_model_sensor_server_data(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_SENSOR_PROPERTY_ID, p_event) != WICED_BT_SUCCESS)
     {
-        // If Cadence is not configured we should publish on every change. Implementation needs to make sure that
-        // the value is not published too often, but in Motion Sensor it is not a problem because there is a blind timer involved.
-        mesh_sensor_publish();
+        mesh_sensor_buffer_stats.publish_failures++;
+        WICED_BT_TRACE("pub failed\n");
+    }
+}
+
+/*
+ * Sample the buffer pools and keep the lowest number of free buffers of each pool
+ */
+void mesh_sensor_buffer_sample(void)
+{
+    uint8_t  i;
+    uint16_t free_buffers;
+
+    if (wiced_bt_get_buffer_usage(mesh_sensor_buffer_pools, sizeof(mesh_sensor_buffer_pools)) != WICED_BT_SUCCESS)
         return;
+
+    mesh_sensor_buffer_stats.samples++;
+    for (i = 0; i < MESH_SENSOR_BUFFER_POOLS; i++)
+    {
+        free_buffers = mesh_sensor_buffer_pools[i].total_count - mesh_sensor_buffer_pools[i].current_allocated_count;
+        if (free_buffers < mesh_sensor_buffer_stats.min_free[i])
+            mesh_sensor_buffer_stats.min_free[i] = free_buffers;
     }
+}
+
+void mesh_sensor_buffer_stats_reset(void)
+{
+    memset(&mesh_sensor_buffer_stats, 0, sizeof(mesh_sensor_buffer_stats));
+    memset(mesh_sensor_buffer_stats.min_free, 0xff, sizeof(mesh_sensor_buffer_stats.min_free));
+}
+
+/*
+ * Buffer pool sampling timer callback. The pools are sampled from the event queue.
+ */
+void mesh_sensor_buffer_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_BUFFER_SAMPLE, NULL);
+}
+
+/*
+ * Send Time Get to the publication of the Time Client. The Time Status published periodically
+ * by the Time Server is also received if the Time Client is subscribed to it.
+ */
+void mesh_sensor_time_get(void)
+{
+    wiced_bt_mesh_event_t *p_event;
 
-    current_time = wiced_bt_mesh_core_get_tick_count();
-    if (mesh_sensor_pub_time + p_sensor->cadence.min_interval > current_time)
+    p_event = wiced_bt_mesh_create_event(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT, 0, 0);
+    if (p_event == NULL)
     {
-        WICED_BT_TRACE("sensor value change min_interval not expired pub_time:%d current_time:%d\n", mesh_sensor_pub_time, current_time);
+        WICED_BT_TRACE("time get: no publication\n");
         return;
     }
+    wiced_bt_mesh_model_time_client_time_get_send(p_event);
+}
+
+/*
+ * Request the time only for a batch of presence changes to be read, when the time is not known or
+ * was received too long ago. A Low Power Node does not poll its Friend for a periodic Time Get.
+ */
+void mesh_sensor_time_request(void)
+{
+    uint32_t now = wiced_bt_mesh_core_get_tick_count();
+
+    if (mesh_sensor_occupancy_count == 0)
+        return;
+    if (mesh_sensor_time_map.synchronized && ((now - mesh_sensor_time_map.anchor_tick) < MESH_SENSOR_TIME_SYNC_INTERVAL))
+        return;
+    if (mesh_sensor_time_requested && ((now - mesh_sensor_time_request_time) < MESH_SENSOR_TIME_RETRY_INTERVAL))
+        return;
+
+    mesh_sensor_time_requested    = WICED_TRUE;
+    mesh_sensor_time_request_time = now;
+    mesh_sensor_time_get();
+}
 
-    // If cadence is configured, we will publish if conditions are setisifed
-    current_value = mesh_sensor_get_current_value();
+/*
+ * Time Client callback. A Time Status anchors the tick count to the TAI time.
+ */
+void mesh_sensor_time_client_callback(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data)
+{
+    wiced_bt_mesh_time_state_msg_t *p_time = (wiced_bt_mesh_time_state_msg_t *)p_data;
 
-    if (((p_sensor->cadence.trigger_delta_down != 0) && (current_value < mesh_sensor_pub_value - p_sensor->cadence.trigger_delta_down)) ||
-        ((p_sensor->cadence.trigger_delta_up != 0) && (current_value > mesh_sensor_pub_value - p_sensor->cadence.trigger_delta_up)))
+    if (event == WICED_BT_MESH_TIME_STATUS)
     {
-        mesh_sensor_publish();
-        mesh_sensor_server_restart_timer(p_sensor);
+        if (sensor_time_map_update(&mesh_sensor_time_map, p_time->tai_seconds, p_time->subsecond, p_time->uncertainty,
+                                   p_time->tai_utc_delta_current, p_time->time_zone_offset_current, wiced_bt_mesh_core_get_tick_count()))
+        {
+            WICED_BT_TRACE("time from:%04x uncertainty:%d\n", p_event->src, p_time->uncertainty);
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+            mesh_sensor_occupancy_correct();
+#endif
+            mesh_sensor_occupancy_setting_update();
+        }
+    }
+    wiced_bt_mesh_release_event(p_event);
+}
+
+/*
+ * Replace a presence rule and save the table in the NVRAM
+ */
+void mesh_sensor_rule_set(uint8_t *p_data, uint8_t len)
+{
+    sensor_rule_t  rule;
+    uint8_t        index;
+    wiced_result_t result;
+
+    if (!sensor_rule_decode(p_data, len, &index, &rule) || !sensor_rule_set(&mesh_sensor_rules, index, &rule))
+    {
+        WICED_BT_TRACE("invalid rule\n");
+        // the setting may have been overwritten with the rejected value
+        mesh_sensor_rule_setting_update(mesh_sensor_rule_setting_index);
         return;
     }
+    WICED_BT_TRACE("rule:%d type:%x delay:%d dst:%04x value:%d\n", index, rule.type, rule.delay, rule.dst, rule.value);
+
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_RULE_VSID, sizeof(mesh_sensor_rules.rules), (uint8_t *)mesh_sensor_rules.rules, &result);
+    mesh_sensor_rule_setting_update(index);
 }
 
 /*
- * Publish Sensor Data
+ * Set the rule setting to a rule as it is kept in the table, so that a read returns the rule in
+ * effect, which is cleared if it was removed, rather than the last value received.
  */
-void mesh_sensor_publish(void)
+void mesh_sensor_rule_setting_update(uint8_t index)
 {
-    mesh_sensor_sent_value = mesh_sensor_get_current_value();
-    mesh_sensor_pub_value = mesh_sensor_sent_value;
-    mesh_sensor_pub_time = wiced_bt_mesh_core_get_tick_count();
+    mesh_sensor_rule_setting_index = index;
+    sensor_rule_encode(index, &mesh_sensor_rules.rules[index], mesh_sensor_rule_setting);
+}
+
+/*
+ * Send the message of a presence rule. Messages are not acknowledged, they are usually sent to a group.
+ */
+void mesh_sensor_rule_action(const sensor_rule_t *p_rule)
+{
+    wiced_bt_mesh_event_t           *p_event;
+    wiced_bt_mesh_onoff_set_data_t  onoff;
+    wiced_bt_mesh_level_set_level_t level;
+    wiced_result_t                  result;
+    uint16_t model_id = (SENSOR_RULE_ACTION(p_rule) == SENSOR_RULE_ACTION_ONOFF) ? WICED_BT_MESH_CORE_MODEL_ID_GENERIC_ONOFF_CLNT : WICED_BT_MESH_CORE_MODEL_ID_GENERIC_LEVEL_CLNT;
+
+    p_event = wiced_bt_mesh_create_event(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_COMPANY_ID_BT_SIG, model_id, p_rule->dst, p_rule->app_key_idx);
+    if (p_event == NULL)
+    {
+        mesh_sensor_rule_failures++;
+        return;
+    }
+    p_event->reply = 0;
+
+    if (SENSOR_RULE_ACTION(p_rule) == SENSOR_RULE_ACTION_ONOFF)
+    {
+        onoff.onoff           = (p_rule->value != 0) ? 1 : 0;
+        onoff.transition_time = WICED_BT_MESH_TRANSITION_TIME_DEFAULT;
+        onoff.delay           = 0;
+        result = wiced_bt_mesh_model_onoff_client_set(p_event, &onoff);
+    }
+    else
+    {
+        level.level           = p_rule->value;
+        level.transition_time = WICED_BT_MESH_TRANSITION_TIME_DEFAULT;
+        level.delay           = 0;
+        result = wiced_bt_mesh_model_level_client_set(p_event, &level);
+    }
+    WICED_BT_TRACE("rule dst:%04x value:%d result:%d\n", p_rule->dst, p_rule->value, result);
+
+    if (result == WICED_BT_SUCCESS)
+        mesh_sensor_rule_actions++;
+    else
+        mesh_sensor_rule_failures++;
+}
+
+/*
+ * Start the rule timer for the next delayed rule, or stop it if none is pending
+ */
+void mesh_sensor_rule_timer_restart(uint32_t timeout)
+{
+    if (timeout != 0)
+        wiced_start_timer(&mesh_sensor_rule_timer, timeout);
+    else if (wiced_is_timer_in_use(&mesh_sensor_rule_timer))
+        wiced_stop_timer(&mesh_sensor_rule_timer);
+}
+
+void mesh_sensor_rule_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_RULE, NULL);
+}
+
+/*
+ * Rules send unacknowledged messages, a status is received only if a Generic Server replies to a Get sent by another client
+ */
+void mesh_sensor_rule_client_callback(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data)
+{
+    wiced_bt_mesh_release_event(p_event);
+}
+
+/*
+ * Keep the presence change in the log, the oldest change is overwritten if the log is full
+ */
+void mesh_sensor_occupancy_log(uint8_t presence, uint32_t tick)
+{
+    mesh_sensor_occupancy_t *p_entry;
+
+    if (mesh_sensor_occupancy_count == MESH_SENSOR_OCCUPANCY_LOG_SIZE)
+    {
+        mesh_sensor_occupancy_first = (mesh_sensor_occupancy_first + 1) % MESH_SENSOR_OCCUPANCY_LOG_SIZE;
+        mesh_sensor_occupancy_count--;
+        mesh_sensor_occupancy_dropped++;
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+        if (mesh_sensor_occupancy_restored != 0)
+            mesh_sensor_occupancy_restored--;
+#endif
+    }
+    p_entry = &mesh_sensor_occupancy[(mesh_sensor_occupancy_first + mesh_sensor_occupancy_count) % MESH_SENSOR_OCCUPANCY_LOG_SIZE];
+    p_entry->tick     = tick;
+    p_entry->presence = presence;
+    mesh_sensor_occupancy_count++;
+
+    mesh_sensor_occupancy_setting_update();
+    mesh_sensor_time_request();
+}
+
+/*
+ * Remove the oldest changes from the log once they have been read
+ */
+void mesh_sensor_occupancy_remove(uint8_t count)
+{
+    if (count > mesh_sensor_occupancy_count)
+        count = mesh_sensor_occupancy_count;
+
+    mesh_sensor_occupancy_first = (mesh_sensor_occupancy_first + count) % MESH_SENSOR_OCCUPANCY_LOG_SIZE;
+    mesh_sensor_occupancy_count -= count;
+    mesh_sensor_occupancy_dropped = 0;
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    mesh_sensor_occupancy_restored = (mesh_sensor_occupancy_restored > count) ? (mesh_sensor_occupancy_restored - count) : 0;
+#endif
+    mesh_sensor_occupancy_setting_update();
+}
+
+/*
+ * Prepare the batch of the oldest changes read with the occupancy setting. The changes are
+ * stamped with the TAI time, the batch is empty until the time is known.
+ */
+void mesh_sensor_occupancy_setting_update(void)
+{
+    uint8_t  *p = mesh_sensor_occupancy_setting;
+    uint8_t  count = 0;
+    uint8_t  i, j;
+    uint64_t tai_seconds;
+    uint8_t  subsecond;
+    mesh_sensor_occupancy_t *p_entry;
+
+    memset(mesh_sensor_occupancy_setting, 0, sizeof(mesh_sensor_occupancy_setting));
+    if (mesh_sensor_time_map.synchronized)
+        count = (mesh_sensor_occupancy_count < MESH_SENSOR_OCCUPANCY_BATCH_SIZE) ? mesh_sensor_occupancy_count : MESH_SENSOR_OCCUPANCY_BATCH_SIZE;
+
+    mesh_sensor_occupancy_batch = count;
+    UINT8_TO_STREAM(p, count);
+    UINT16_TO_STREAM(p, (mesh_sensor_occupancy_dropped < 0xFFFF) ? mesh_sensor_occupancy_dropped : 0xFFFF);
+    for (i = 0; i < count; i++)
+    {
+        p_entry = &mesh_sensor_occupancy[(mesh_sensor_occupancy_first + i) % MESH_SENSOR_OCCUPANCY_LOG_SIZE];
+        sensor_time_tick_to_tai(&mesh_sensor_time_map, p_entry->tick, &tai_seconds, &subsecond);
+        for (j = 0; j < 5; j++)
+            UINT8_TO_STREAM(p, (uint8_t)(tai_seconds >> (8 * j)));
+        UINT8_TO_STREAM(p, subsecond);
+        UINT8_TO_STREAM(p, p_entry->presence);
+    }
+}
+
+/*
+ * Deferred publication timer callback. The publication is done from the event queue.
+ */
+void mesh_sensor_publish_deferred_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PUBLISH_DEFERRED, NULL);
+}
+
+#ifdef MESH_SENSOR_RELAY_ELECTION
+/*
+ * Relay election timer callback. The election is done from the event queue.
+ */
+void mesh_sensor_relay_election_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_RELAY_ELECTION, NULL);
+}
+
+/*
+ * Elect the relay state from the neighbours heard. A new state is applied to the mesh core at run
+ * time, the same way as a Config Relay Set, and is saved for the next election. The Relay state of
+ * the mesh core is read first: if it is not the one the election applied last, a Config Client has
+ * set it, and the election leaves the Relay state to the Config Client from then on.
+ */
+void mesh_sensor_relay_election(void)
+{
+    wiced_bool_t   relay;
+    uint8_t        core_state;
+    wiced_result_t result;
+
+    wiced_start_timer(&mesh_sensor_relay_election_timer, MESH_SENSOR_RELAY_ELECTION_INTERVAL);
+
+    if (mesh_sensor_relay_state == MESH_SENSOR_RELAY_STATE_CONFIGURED)
+        return;
+
+    core_state = wiced_bt_mesh_core_get_relay_state();
+    if (core_state != mesh_sensor_relay_state)
+    {
+        WICED_BT_TRACE("relay state:%d set by config client, election stopped\n", core_state);
+        mesh_sensor_relay_state = MESH_SENSOR_RELAY_STATE_CONFIGURED;
+        sensor_motion_nvram_write(MESH_MOTION_SENSOR_RELAY_VSID, sizeof(mesh_sensor_relay_state), &mesh_sensor_relay_state, &result);
+        return;
+    }
+
+    relay = sensor_relay_elect(core_state == MESH_SENSOR_RELAY_STATE_ENABLED, wiced_bt_mesh_core_get_local_addr(), wiced_bt_mesh_core_get_tick_count());
+    if (relay == (core_state == MESH_SENSOR_RELAY_STATE_ENABLED))
+        return;
+
+    WICED_BT_TRACE("relay %s\n", relay ? "enabled" : "disabled");
+    mesh_sensor_relay_state = relay ? MESH_SENSOR_RELAY_STATE_ENABLED : MESH_SENSOR_RELAY_STATE_DISABLED;
+    wiced_bt_mesh_core_set_relay_state(mesh_sensor_relay_state);
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_RELAY_VSID, sizeof(mesh_sensor_relay_state), &mesh_sensor_relay_state, &result);
+}
+#endif
+
+/*
+ * Rate limiter earns a token every min interval
+ */
+uint32_t mesh_sensor_rate_limit_interval(void)
+{
+    sensor_publish_config_t config;
+
+    mesh_sensor_publish_config(&mesh_config.elements[MESH_SENSOR_SERVER_ELEMENT_INDEX].sensors[MESH_MOTION_SENSOR_INDEX], &config);
+    return sensor_publish_rate_limit_interval(&config);
+}
+
+/*
+ * Configure the zone group for presence changes. Address 0 sends presence changes to the model publication.
+ */
+void mesh_sensor_zone_set(uint16_t addr, uint8_t ttl, uint16_t app_key_idx)
+{
+    wiced_result_t result;
 
-    WICED_BT_TRACE("*** Pub value:%d time:%d\n", mesh_sensor_sent_value, mesh_sensor_pub_time);
-    wiced_bt_mesh_model_sensor_server_data(MESH_SENSOR_SERVER_ELEMENT_INDEX, MESH_SENSOR_PROPERTY_ID, NULL);
+    mesh_sensor_zone.addr        = addr;
+    mesh_sensor_zone.ttl         = (ttl != 0) ? ttl : MESH_SENSOR_ZONE_DEFAULT_TTL;
+    mesh_sensor_zone.app_key_idx = app_key_idx;
+    WICED_BT_TRACE("zone addr:%04x ttl:%d app_key_idx:%d\n", mesh_sensor_zone.addr, mesh_sensor_zone.ttl, mesh_sensor_zone.app_key_idx);
+
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_ZONE_VSID, sizeof(mesh_sensor_zone), (uint8_t *)&mesh_sensor_zone, &result);
+#ifdef MESH_SENSOR_RELAY_ELECTION
+    sensor_relay_set_direct_ttl((mesh_sensor_zone.addr != 0) ? mesh_sensor_zone.ttl : 0);
+#endif
 }
 
 int32_t mesh_sensor_get_current_value(void)
@@ -772,42 +1835,1014 @@ int32_t mesh_sensor_get_current_value(void)
     return presence_detected;
 }
 
+/*
+ * Prepare the Sensor Status payload for the current value. The encoded value is reused for
+ * periodic publications and GET replies until the value changes.
+ */
+void mesh_sensor_prepare_status(void)
+{
+    if (mesh_sensor_sent_generation == mesh_sensor_value_generation)
+        return;
+
+    mesh_sensor_sent_value = mesh_sensor_get_current_value();
+    SENSOR_CODEC_ENCODE(MESH_SENSOR_VALUE_CODEC, mesh_sensor_sent_data, mesh_sensor_sent_value);
+    mesh_sensor_sent_generation = mesh_sensor_value_generation;
+}
+
 /*
  * Application is notified that factory reset is executed.
  */
 void mesh_app_factory_reset(void)
 {
-    wiced_hal_delete_nvram(MESH_MOTION_SENSOR_CADENCE_VSID_START, NULL);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_CADENCE_VSID_START);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_CADENCE_BASELINE_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_COMMISSIONING_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_ZONE_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_RELAY_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_PIR_SETTING_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_PROFILE_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_RULE_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_LPN_POLL_VSID);
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_OCCUPANCY_VSID);
 }
 
-#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
-void mesh_sensor_motion_lpn_sleep(uint32_t max_sleep_duration)
+/*
+ * Unprovisioned device starts commissioning mode. Mesh core sends unprovisioned beacons on its own
+ * schedule, but the connectable advertisements used by the PB-GATT provisioners are sent with the
+ * intervals from the configuration. Use fast intervals for the first minutes after power up
+ * and back off to the configured ones after that.
+ */
+void mesh_sensor_commissioning_start(void)
 {
-    WICED_BT_TRACE("Mesh core allow max_sleep_duration:%ds configured:%ds presence:%d\n", max_sleep_duration / 1000, mesh_sensor_sleep_max_time / 1000, presence_detected);
+    if (mesh_sensor_commissioning_active)
+        return;
+
+    mesh_sensor_commissioning_active = WICED_TRUE;
+    memset(&mesh_sensor_commissioning, 0, sizeof(mesh_sensor_commissioning));
+
+    mesh_sensor_commissioning_saved_adv_interval[0] = wiced_bt_cfg_settings.ble_advert_cfg.high_duty_min_interval;
+    mesh_sensor_commissioning_saved_adv_interval[1] = wiced_bt_cfg_settings.ble_advert_cfg.high_duty_max_interval;
+    wiced_bt_cfg_settings.ble_advert_cfg.high_duty_min_interval = MESH_COMMISSIONING_FAST_ADV_MIN_INTERVAL;
+    wiced_bt_cfg_settings.ble_advert_cfg.high_duty_max_interval = MESH_COMMISSIONING_FAST_ADV_MAX_INTERVAL;
+    mesh_sensor_commissioning_fast_adv = WICED_TRUE;
+
+    wiced_init_timer(&mesh_sensor_commissioning_timer, mesh_sensor_commissioning_timer_callback, 0, WICED_SECONDS_TIMER);
+    wiced_start_timer(&mesh_sensor_commissioning_timer, MESH_COMMISSIONING_FAST_ADV_DURATION);
+
+    WICED_BT_TRACE("commissioning fast adv for %ds\n", MESH_COMMISSIONING_FAST_ADV_DURATION);
+}
+
+/*
+ * Fast advertising period expired, back off to the configured advertising intervals
+ */
+void mesh_sensor_commissioning_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    WICED_BT_TRACE("commissioning fast adv expired\n");
+    mesh_sensor_commissioning_adv_restore();
+}
+
+void mesh_sensor_commissioning_adv_restore(void)
+{
+    if (!mesh_sensor_commissioning_fast_adv)
+        return;
+
+    wiced_bt_cfg_settings.ble_advert_cfg.high_duty_min_interval = mesh_sensor_commissioning_saved_adv_interval[0];
+    wiced_bt_cfg_settings.ble_advert_cfg.high_duty_max_interval = mesh_sensor_commissioning_saved_adv_interval[1];
+    mesh_sensor_commissioning_fast_adv = WICED_FALSE;
+}
+
+/*
+ * Device has been provisioned. Record the time if the device was powered up unprovisioned.
+ */
+void mesh_sensor_commissioning_provisioned(void)
+{
+    if (!mesh_sensor_commissioning_active || (mesh_sensor_commissioning.provisioned_time != 0))
+        return;
+
+    wiced_stop_timer(&mesh_sensor_commissioning_timer);
+    mesh_sensor_commissioning_adv_restore();
+
+    mesh_sensor_commissioning.provisioned_time = wiced_bt_mesh_core_get_tick_count();
+    WICED_BT_TRACE("commissioning provisioned at:%dms\n", mesh_sensor_commissioning.provisioned_time);
+}
+
+/*
+ * Value has been published. The first publication after provisioning completes the commissioning.
+ */
+void mesh_sensor_commissioning_published(void)
+{
+    wiced_result_t result;
+
+    if (!mesh_sensor_commissioning_active || (mesh_sensor_commissioning.provisioned_time == 0))
+        return;
+
+    mesh_sensor_commissioning.first_publish_time = wiced_bt_mesh_core_get_tick_count();
+    mesh_sensor_commissioning_active = WICED_FALSE;
+    WICED_BT_TRACE("commissioning first publish at:%dms\n", mesh_sensor_commissioning.first_publish_time);
+
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_COMMISSIONING_VSID, sizeof(mesh_sensor_commissioning), (uint8_t *)&mesh_sensor_commissioning, &result);
+}
+
+/*
+ * Write the PIR setting to the sensor
+ */
+void mesh_sensor_pir_setting_apply(const mesh_sensor_pir_setting_t *p_setting)
+{
+    e93196_usr_cfg.e93196_init_reg.sensitivity = p_setting->sensitivity;
+    e93196_usr_cfg.e93196_init_reg.pulse_cnt   = p_setting->pulse_cnt;
+    e93196_reg_update(&e93196_usr_cfg);
+}
+
+/*
+ * Start the PIR calibration. The room has to stay empty until the calibration is done. Each setting
+ * is observed for the window and the most sensitive one with no more than budget triggers is kept.
+ */
+void mesh_sensor_calibration_start(uint16_t window, uint8_t budget)
+{
+    // PIR is initialized only after the device is provisioned
+    if (!mesh_sensor_calibration_ready)
+    {
+        WICED_BT_TRACE("calibration not available before provisioning\n");
+        return;
+    }
+    mesh_sensor_calibration_window   = (window != 0) ? window : MESH_SENSOR_CALIBRATION_DEFAULT_WINDOW;
+    mesh_sensor_calibration_budget   = budget;
+    mesh_sensor_calibration_index    = 0;
+    mesh_sensor_calibration_triggers = 0;
+    mesh_sensor_calibration_state    = MESH_SENSOR_CALIBRATION_RUNNING;
+    WICED_BT_TRACE("calibration start window:%ds budget:%d\n", mesh_sensor_calibration_window, budget);
+
+    mesh_sensor_pir_setting_apply(&mesh_sensor_pir_settings[0]);
+    wiced_start_timer(&mesh_sensor_calibration_timer, mesh_sensor_calibration_window);
+    mesh_sensor_calibration_setting_update();
+}
+
+void mesh_sensor_calibration_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_CALIBRATION, NULL);
+}
+
+/*
+ * Observation window of a setting ended. Keep the setting if it is within the budget, otherwise
+ * try the next less sensitive one.
+ */
+void mesh_sensor_calibration_step(void)
+{
+    const mesh_sensor_pir_setting_t *p_setting = &mesh_sensor_pir_settings[mesh_sensor_calibration_index];
+    wiced_result_t result;
+
+    if (mesh_sensor_calibration_state != MESH_SENSOR_CALIBRATION_RUNNING)
+        return;
 
-    // Currently cannot sleep for more than a minute. It's for better demo.
-    if (max_sleep_duration > 60000)
-        max_sleep_duration = 60000;
+    WICED_BT_TRACE("calibration sensitivity:%d pulses:%d triggers:%d\n", p_setting->sensitivity, p_setting->pulse_cnt, mesh_sensor_calibration_triggers);
 
-    if (mesh_sensor_sleep_max_time != 0)
+    if (mesh_sensor_calibration_triggers <= mesh_sensor_calibration_budget)
+    {
+        mesh_sensor_calibration_state = MESH_SENSOR_CALIBRATION_DONE;
+    }
+    else if (mesh_sensor_calibration_index + 1 < MESH_SENSOR_PIR_SETTINGS_NUM)
+    {
+        mesh_sensor_calibration_index++;
+        mesh_sensor_calibration_triggers = 0;
+        mesh_sensor_pir_setting_apply(&mesh_sensor_pir_settings[mesh_sensor_calibration_index]);
+        wiced_start_timer(&mesh_sensor_calibration_timer, mesh_sensor_calibration_window);
+        mesh_sensor_calibration_setting_update();
+        return;
+    }
+    else
     {
-        // If presence is detected we cannot sleep for more than configured period.
-        // Otherwise we can sleep until need to send the next LPN poll
-        if (presence_detected && (mesh_sensor_sleep_max_time < max_sleep_duration))
-            max_sleep_duration = mesh_sensor_sleep_max_time;
+        // even the least sensitive setting triggers too often, keep it as the best available
+        mesh_sensor_calibration_state = MESH_SENSOR_CALIBRATION_FAILED;
     }
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_PIR_SETTING_VSID, sizeof(mesh_sensor_pir_setting_t), (uint8_t *)p_setting, &result);
+    mesh_sensor_calibration_setting_update();
+#ifdef HCI_CONTROL
+    mesh_sensor_calibration_send();
+#endif
+}
+
+/*
+ * Set the calibration setting to the state of the calibration, so that a Sensor Client which started
+ * it can read the progress and the selected PIR setting. The triggers are the ones of the last window
+ * while the calibration runs.
+ */
+void mesh_sensor_calibration_setting_update(void)
+{
+    uint8_t *p = mesh_sensor_calibration_setting;
+
+    UINT16_TO_STREAM(p, mesh_sensor_calibration_window);
+    UINT8_TO_STREAM(p, mesh_sensor_calibration_budget);
+    UINT8_TO_STREAM(p, mesh_sensor_calibration_state);
+    UINT8_TO_STREAM(p, e93196_usr_cfg.e93196_init_reg.sensitivity);
+    UINT8_TO_STREAM(p, e93196_usr_cfg.e93196_init_reg.pulse_cnt);
+    UINT16_TO_STREAM(p, (mesh_sensor_calibration_triggers < 0xFFFF) ? mesh_sensor_calibration_triggers : 0xFFFF);
+}
+
+/*
+ * Reset cadence engine statistics
+ */
+void mesh_sensor_cadence_stats_reset(void)
+{
+    memset(&mesh_sensor_cadence_stats, 0, sizeof(mesh_sensor_cadence_stats));
+    mesh_sensor_cadence_stats.start_time = wiced_bt_mesh_core_get_tick_count();
+}
+
+/*
+ * Calculate cadence engine statistics normalized per hour so that runs of different
+ * duration can be compared
+ */
+void mesh_sensor_cadence_stats_get_rates(mesh_sensor_cadence_rates_t *p_rates)
+{
+    uint32_t elapsed = wiced_bt_mesh_core_get_tick_count() - mesh_sensor_cadence_stats.start_time;
+
+    if (elapsed == 0)
+        elapsed = 1;
+
+    p_rates->evaluations_per_hour  = (uint32_t)((uint64_t)mesh_sensor_cadence_stats.evaluations * 3600000 / elapsed);
+    p_rates->publishes_per_hour    = (uint32_t)((uint64_t)mesh_sensor_cadence_stats.publishes * 3600000 / elapsed);
+    p_rates->timer_rearms_per_hour = (uint32_t)((uint64_t)mesh_sensor_cadence_stats.timer_rearms * 3600000 / elapsed);
+}
+
+#ifdef HCI_CONTROL
+/*
+ * Process application specific WICED HCI commands
+ */
+uint32_t mesh_app_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    WICED_BT_TRACE("[%s] cmd_opcode 0x%02x\n", __FUNCTION__, opcode);
+
+    switch (opcode)
+    {
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_CADENCE_STATS_GET:
+        mesh_sensor_cadence_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_CADENCE_STATS_RESET:
+        mesh_sensor_cadence_stats_reset();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_CADENCE_BASELINE_SET:
+        mesh_sensor_cadence_baseline_save();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_NVRAM_STATS_GET:
+        mesh_sensor_nvram_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_NVRAM_STATS_RESET:
+        sensor_motion_nvram_stats_reset();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_COMMISSIONING_GET:
+        mesh_sensor_commissioning_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_CONNECTION_STATS_GET:
+        mesh_sensor_connection_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_LATENCY_STATS_GET:
+        mesh_sensor_latency_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_LATENCY_STATS_RESET:
+        sensor_latency_reset(&mesh_sensor_latency);
+        mesh_sensor_latency_missed = 0;
+        mesh_sensor_latency_start_time = wiced_bt_mesh_core_get_tick_count();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_CALIBRATION_START:
+        if (length < 3)
+            return WICED_FALSE;
+        mesh_sensor_calibration_start(p_data[0] | (p_data[1] << 8), p_data[2]);
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_CALIBRATION_GET:
+        mesh_sensor_calibration_send();
+        break;
+
+#ifdef STACK_PROFILE
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_STACK_STATS_GET:
+        mesh_sensor_stack_stats_send();
+        break;
+#endif
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_BUFFER_STATS_GET:
+        mesh_sensor_buffer_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_BUFFER_STATS_RESET:
+        mesh_sensor_buffer_stats_reset();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_OCCUPANCY_GET:
+        mesh_sensor_occupancy_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_RULE_SET:
+        mesh_sensor_rule_set(p_data, (uint8_t)length);
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_RULE_GET:
+        mesh_sensor_rule_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_ZONE_SET:
+        if (length < 5)
+            return WICED_FALSE;
+        mesh_sensor_zone_set(p_data[0] | (p_data[1] << 8), p_data[2], p_data[3] | (p_data[4] << 8));
+        break;
+
+#ifdef REMOTE_PROVISION_SERVER_SUPPORTED
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_RPR_STATS_GET:
+        mesh_sensor_rpr_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_RPR_STATS_RESET:
+        sensor_motion_rpr_stats_reset();
+        break;
+#endif
+
+#ifdef MESH_DFU_SUPPORTED
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_DFU_STATS_GET:
+        mesh_sensor_dfu_stats_send();
+        break;
+#endif
+
+#ifdef OTA_DELTA_SUPPORTED
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_OTA_DELTA_START:
+        mesh_sensor_delta_start();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_OTA_DELTA_DATA:
+        mesh_sensor_delta_data(p_data, length);
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_OTA_DELTA_FINISH:
+        mesh_sensor_delta_finish();
+        break;
+#endif
+
+#ifdef SYNTHETIC_MOTION
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_WORKLOAD_START:
+        if (length < 5)
+            return WICED_FALSE;
+        return sensor_workload_start(p_data[0], p_data[1] | (p_data[2] << 8) | (p_data[3] << 16) | ((uint32_t)p_data[4] << 24));
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_WORKLOAD_STOP:
+        sensor_workload_stop();
+        break;
+#endif
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_LPN_STATS_GET:
+        mesh_sensor_lpn_stats_send();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_LPN_STATS_RESET:
+        memset(&mesh_sensor_lpn_stats, 0, sizeof(mesh_sensor_lpn_stats));
+        mesh_sensor_lpn_stats.start_time = wiced_bt_mesh_core_get_tick_count();
+        break;
+
+    case HCI_CONTROL_SENSOR_MOTION_COMMAND_LPN_POLL_SET:
+        mesh_sensor_lpn_poll_set(p_data, length);
+        break;
+#endif
+
+    default:
+        return WICED_FALSE;
+    }
+    return WICED_TRUE;
+}
+
+/*
+ * Send cadence statistics to the host. Rates are compared to the baseline saved in the NVRAM.
+ */
+void mesh_sensor_cadence_stats_send(void)
+{
+    mesh_sensor_cadence_rates_t rates;
+    mesh_sensor_cadence_rates_t baseline;
+    wiced_result_t              result;
+    uint8_t                     regression = 0;
+    uint8_t                     buf[29];
+    uint8_t                     *p = buf;
+
+    mesh_sensor_cadence_stats_get_rates(&rates);
+
+    if (wiced_hal_read_nvram(MESH_MOTION_SENSOR_CADENCE_BASELINE_VSID, sizeof(baseline), (uint8_t *)&baseline, &result) == sizeof(baseline))
+    {
+        if ((uint64_t)rates.evaluations_per_hour * 100 > (uint64_t)baseline.evaluations_per_hour * (100 + MESH_SENSOR_STATS_REGRESSION_MARGIN_PERCENT))
+            regression |= SENSOR_MOTION_REGRESSION_EVALUATIONS;
+        if ((uint64_t)rates.publishes_per_hour * 100 > (uint64_t)baseline.publishes_per_hour * (100 + MESH_SENSOR_STATS_REGRESSION_MARGIN_PERCENT))
+            regression |= SENSOR_MOTION_REGRESSION_PUBLISHES;
+        if ((uint64_t)rates.timer_rearms_per_hour * 100 > (uint64_t)baseline.timer_rearms_per_hour * (100 + MESH_SENSOR_STATS_REGRESSION_MARGIN_PERCENT))
+            regression |= SENSOR_MOTION_REGRESSION_TIMER_REARMS;
+    }
+    WICED_BT_TRACE("cadence stats eval:%d pub:%d rearm:%d regression:%x\n", mesh_sensor_cadence_stats.evaluations,
+            mesh_sensor_cadence_stats.publishes, mesh_sensor_cadence_stats.timer_rearms, regression);
+
+    UINT32_TO_STREAM(p, wiced_bt_mesh_core_get_tick_count() - mesh_sensor_cadence_stats.start_time);
+    UINT32_TO_STREAM(p, mesh_sensor_cadence_stats.evaluations);
+    UINT32_TO_STREAM(p, mesh_sensor_cadence_stats.publishes);
+    UINT32_TO_STREAM(p, mesh_sensor_cadence_stats.timer_rearms);
+    UINT32_TO_STREAM(p, rates.evaluations_per_hour);
+    UINT32_TO_STREAM(p, rates.publishes_per_hour);
+    UINT32_TO_STREAM(p, rates.timer_rearms_per_hour);
+    UINT8_TO_STREAM(p, regression);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_CADENCE_STATS, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Save current cadence statistics rates as the baseline for the regression check
+ */
+void mesh_sensor_cadence_baseline_save(void)
+{
+    mesh_sensor_cadence_rates_t rates;
+    wiced_result_t              result;
+
+    mesh_sensor_cadence_stats_get_rates(&rates);
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_CADENCE_BASELINE_VSID, sizeof(rates), (uint8_t *)&rates, &result);
+    WICED_BT_TRACE("cadence baseline saved pub/hour:%d result:%d\n", rates.publishes_per_hour, result);
+}
+
+/*
+ * Send NVRAM wear and latency statistics to the host
+ */
+void mesh_sensor_nvram_stats_send(void)
+{
+    sensor_motion_nvram_stats_t stats;
+    uint8_t                     buf[32 + 4 * SENSOR_MOTION_NVRAM_NUM_SECTORS];
+    uint8_t                     *p = buf;
+    uint8_t                     i;
+
+    sensor_motion_nvram_get_stats(&stats);
+
+    UINT32_TO_STREAM(p, wiced_bt_mesh_core_get_tick_count() - stats.start_time);
+    UINT32_TO_STREAM(p, stats.writes);
+    UINT32_TO_STREAM(p, stats.writes_skipped);
+    UINT32_TO_STREAM(p, stats.deletes);
+    UINT32_TO_STREAM(p, stats.bytes_written);
+    UINT32_TO_STREAM(p, stats.stall_ms);
+    UINT32_TO_STREAM(p, stats.model_stall_us);
+    for (i = 0; i < SENSOR_MOTION_NVRAM_NUM_SECTORS; i++)
+    {
+        UINT32_TO_STREAM(p, stats.sector_erases[i]);
+    }
+    UINT32_TO_STREAM(p, sensor_motion_nvram_erases_per_year());
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_NVRAM_STATS, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Send commissioning time measurement to the host. If this boot did not commission the device,
+ * the measurement saved in the NVRAM is reported.
+ */
+void mesh_sensor_commissioning_send(void)
+{
+    mesh_sensor_commissioning_record_t record = mesh_sensor_commissioning;
+    wiced_result_t                     result;
+    uint8_t                            buf[9];
+    uint8_t                            *p = buf;
+
+    if (!mesh_sensor_commissioning_active && (record.first_publish_time == 0))
+        wiced_hal_read_nvram(MESH_MOTION_SENSOR_COMMISSIONING_VSID, sizeof(record), (uint8_t *)&record, &result);
+
+    UINT8_TO_STREAM(p, mesh_sensor_commissioning_active);
+    UINT32_TO_STREAM(p, record.provisioned_time);
+    UINT32_TO_STREAM(p, record.first_publish_time);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_COMMISSIONING, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Send GATT proxy connection time and the estimated charge consumed while connected to the host
+ */
+void mesh_sensor_connection_stats_send(void)
+{
+    uint32_t connected_ms = mesh_sensor_proxy_connected_ms;
+    uint8_t  buf[13];
+    uint8_t  *p = buf;
+
+    if (mesh_sensor_proxy_connected)
+        connected_ms += wiced_bt_mesh_core_get_tick_count() - mesh_sensor_proxy_connect_time;
+
+    UINT8_TO_STREAM(p, mesh_sensor_proxy_connected);
+    UINT32_TO_STREAM(p, mesh_sensor_proxy_connections);
+    UINT32_TO_STREAM(p, connected_ms);
+    // charge in uA * s
+    UINT32_TO_STREAM(p, (uint32_t)((uint64_t)connected_ms * MESH_SENSOR_CONNECTED_CURRENT_UA / 1000));
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_CONNECTION_STATS, buf, (uint16_t)(p - buf));
+}
+
+#ifdef STACK_PROFILE
+uint32_t mesh_app_proc_rx_cmd_profiled(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    uint32_t ret;
+
+    SENSOR_STACK_PROFILE(SENSOR_STACK_HCI_COMMAND, ret = mesh_app_proc_rx_cmd(opcode, p_data, length));
+    return ret;
+}
+
+/*
+ * Send the stack high-water mark and the headroom within the profiled depth of each callback
+ */
+void mesh_sensor_stack_stats_send(void)
+{
+    uint8_t  buf[3 + 4 * SENSOR_STACK_NUM];
+    uint8_t  *p = buf;
+    uint16_t used;
+    uint8_t  id;
+
+    UINT16_TO_STREAM(p, STACK_PROFILE_DEPTH);
+    UINT8_TO_STREAM(p, SENSOR_STACK_NUM);
+    for (id = 0; id < SENSOR_STACK_NUM; id++)
+    {
+        used = sensor_stack_high_water(id);
+        UINT16_TO_STREAM(p, used);
+        UINT16_TO_STREAM(p, STACK_PROFILE_DEPTH - used);
+    }
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_STACK_STATS, buf, (uint16_t)(p - buf));
+}
+#endif
+
+/*
+ * Send buffer pool telemetry to the host. Pools are sampled first, so that the current state is included.
+ */
+void mesh_sensor_buffer_stats_send(void)
+{
+    uint8_t  buf[17 + 6 * MESH_SENSOR_BUFFER_POOLS];
+    uint8_t  *p = buf;
+    uint8_t  i;
+
+    mesh_sensor_buffer_sample();
+
+    UINT32_TO_STREAM(p, mesh_sensor_buffer_stats.samples);
+    UINT32_TO_STREAM(p, mesh_sensor_buffer_stats.publishes);
+    UINT32_TO_STREAM(p, mesh_sensor_buffer_stats.publish_failures);
+    UINT32_TO_STREAM(p, mesh_sensor_buffer_stats.event_failures);
+    UINT8_TO_STREAM(p, MESH_SENSOR_BUFFER_POOLS);
+    for (i = 0; i < MESH_SENSOR_BUFFER_POOLS; i++)
+    {
+        UINT16_TO_STREAM(p, mesh_sensor_buffer_pools[i].pool_size);
+        UINT16_TO_STREAM(p, mesh_sensor_buffer_pools[i].total_count);
+        UINT16_TO_STREAM(p, mesh_sensor_buffer_stats.min_free[i]);
+    }
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_BUFFER_STATS, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Send the logged presence changes to the host in one batch and empty the log. The changes are
+ * stamped with the TAI time (40 bits) and 1/256 of a second. The TAI time is 0 if the time has
+ * not been received since power up, in that case the log is kept until the time is known.
+ */
+void mesh_sensor_occupancy_send(void)
+{
+    uint8_t  buf[12 + 7 * MESH_SENSOR_OCCUPANCY_LOG_SIZE];
+    uint8_t  *p = buf;
+    uint8_t  i, j;
+    uint64_t tai_seconds = 0;
+    uint8_t  subsecond = 0;
+    mesh_sensor_occupancy_t *p_entry;
+
+    UINT8_TO_STREAM(p, mesh_sensor_time_map.synchronized);
+    UINT8_TO_STREAM(p, mesh_sensor_time_map.uncertainty);
+    UINT16_TO_STREAM(p, mesh_sensor_time_map.tai_utc_delta);
+    UINT8_TO_STREAM(p, mesh_sensor_time_map.time_zone_offset);
+    UINT32_TO_STREAM(p, mesh_sensor_occupancy_dropped);
+    UINT8_TO_STREAM(p, mesh_sensor_occupancy_count);
+    for (i = 0; i < mesh_sensor_occupancy_count; i++)
+    {
+        p_entry = &mesh_sensor_occupancy[(mesh_sensor_occupancy_first + i) % MESH_SENSOR_OCCUPANCY_LOG_SIZE];
+        sensor_time_tick_to_tai(&mesh_sensor_time_map, p_entry->tick, &tai_seconds, &subsecond);
+        for (j = 0; j < 5; j++)
+            UINT8_TO_STREAM(p, (uint8_t)(tai_seconds >> (8 * j)));
+        UINT8_TO_STREAM(p, subsecond);
+        UINT8_TO_STREAM(p, p_entry->presence);
+    }
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_OCCUPANCY, buf, (uint16_t)(p - buf));
+
+    if (mesh_sensor_time_map.synchronized)
+        mesh_sensor_occupancy_remove(mesh_sensor_occupancy_count);
+}
+
+/*
+ * Send the presence rules to the host in the format of the rule setting
+ */
+void mesh_sensor_rule_send(void)
+{
+    uint8_t  buf[10 + SENSOR_RULE_ENCODED_LEN * SENSOR_RULE_MAX];
+    uint8_t  *p = buf;
+    uint8_t  i;
+
+    UINT32_TO_STREAM(p, mesh_sensor_rule_actions);
+    UINT32_TO_STREAM(p, mesh_sensor_rule_failures);
+    UINT8_TO_STREAM(p, mesh_sensor_rules.pending);
+    UINT8_TO_STREAM(p, SENSOR_RULE_MAX);
+    for (i = 0; i < SENSOR_RULE_MAX; i++)
+    {
+        sensor_rule_encode(i, &mesh_sensor_rules.rules[i], p);
+        p += SENSOR_RULE_ENCODED_LEN;
+    }
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_RULES, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Send PIR calibration state and the current PIR setting to the host
+ */
+void mesh_sensor_calibration_send(void)
+{
+    uint8_t  buf[8];
+    uint8_t  *p = buf;
+
+    UINT8_TO_STREAM(p, mesh_sensor_calibration_state);
+    UINT8_TO_STREAM(p, mesh_sensor_calibration_index);
+    UINT8_TO_STREAM(p, e93196_usr_cfg.e93196_init_reg.sensitivity);
+    UINT8_TO_STREAM(p, e93196_usr_cfg.e93196_init_reg.pulse_cnt);
+    UINT32_TO_STREAM(p, mesh_sensor_calibration_triggers);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_CALIBRATION, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Send motion to publication latency statistics to the host
+ */
+void mesh_sensor_latency_stats_send(void)
+{
+    uint8_t  buf[24 + 4 * SENSOR_LATENCY_BUCKETS];
+    uint8_t  *p = buf;
+    uint8_t  bucket;
+
+    WICED_BT_TRACE("latency samples:%d missed:%d p95:%d max:%d\n", mesh_sensor_latency.samples, mesh_sensor_latency_missed,
+            sensor_latency_percentile(&mesh_sensor_latency, 95), mesh_sensor_latency.max);
+
+    UINT32_TO_STREAM(p, wiced_bt_mesh_core_get_tick_count() - mesh_sensor_latency_start_time);
+    UINT32_TO_STREAM(p, mesh_sensor_latency.samples);
+    UINT32_TO_STREAM(p, mesh_sensor_latency_missed);
+    UINT32_TO_STREAM(p, sensor_latency_percentile(&mesh_sensor_latency, 50));
+    UINT32_TO_STREAM(p, sensor_latency_percentile(&mesh_sensor_latency, 95));
+    UINT32_TO_STREAM(p, mesh_sensor_latency.max);
+    for (bucket = 0; bucket < SENSOR_LATENCY_BUCKETS; bucket++)
+        UINT32_TO_STREAM(p, mesh_sensor_latency.buckets[bucket]);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_LATENCY_STATS, buf, (uint16_t)(p - buf));
+}
+
+#ifdef REMOTE_PROVISION_SERVER_SUPPORTED
+/*
+ * Send Remote Provisioning Server session statistics to the host
+ */
+void mesh_sensor_rpr_stats_send(void)
+{
+    sensor_motion_rpr_stats_t stats;
+    uint8_t                   buf[25];
+    uint8_t                   *p = buf;
+
+    sensor_motion_rpr_get_stats(&stats);
+
+    UINT8_TO_STREAM(p, stats.session_active);
+    UINT32_TO_STREAM(p, stats.sessions);
+    UINT32_TO_STREAM(p, stats.scans);
+    UINT32_TO_STREAM(p, stats.pdus_forwarded);
+    UINT32_TO_STREAM(p, stats.retransmissions);
+    UINT32_TO_STREAM(p, stats.session_duration);
+    UINT32_TO_STREAM(p, stats.total_duration);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_RPR_STATS, buf, (uint16_t)(p - buf));
+}
+#endif
+
+#ifdef MESH_DFU_SUPPORTED
+/*
+ * Send firmware transfer statistics to the host
+ */
+void mesh_sensor_dfu_stats_send(void)
+{
+    sensor_motion_dfu_stats_t stats;
+    uint8_t                   buf[13];
+    uint8_t                   *p = buf;
+
+    sensor_motion_dfu_get_stats(&stats);
+
+    UINT8_TO_STREAM(p, stats.transfer_active);
+    UINT32_TO_STREAM(p, stats.transfers);
+    UINT32_TO_STREAM(p, stats.messages);
+    UINT32_TO_STREAM(p, stats.transfer_duration);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_DFU_STATS, buf, (uint16_t)(p - buf));
+}
+#endif
+
+#ifdef OTA_DELTA_SUPPORTED
+/*
+ * Start to receive a delta OTA image. The new image is written to the upgrade partition of the
+ * firmware upgrade library, which cannot hold more than OTA_DELTA_IMAGE_LEN bytes.
+ */
+void mesh_sensor_delta_start(void)
+{
+    sensor_delta_init(&mesh_sensor_delta, mesh_sensor_delta_read_old, mesh_sensor_delta_write_new, OTA_DELTA_IMAGE_LEN, OTA_DELTA_IMAGE_LEN);
+    mesh_sensor_delta_active = WICED_TRUE;
+    if (!wiced_firmware_upgrade_prepare())
+    {
+        WICED_BT_TRACE("delta: upgrade partition not ready\n");
+        mesh_sensor_delta.status = SENSOR_DELTA_STATUS_FLASH;
+        mesh_sensor_delta_active = WICED_FALSE;
+    }
+    mesh_sensor_delta_send();
+}
+
+/*
+ * Apply the next chunk of the delta. The host is told only when the delta is rejected, the
+ * following chunks are then ignored until the next start.
+ */
+void mesh_sensor_delta_data(uint8_t *p_data, uint32_t length)
+{
+    if (!mesh_sensor_delta_active)
+        return;
+
+    if (sensor_delta_process(&mesh_sensor_delta, p_data, length) != SENSOR_DELTA_STATUS_OK)
+    {
+        WICED_BT_TRACE("delta: rejected status:%d at:%d\n", mesh_sensor_delta.status, mesh_sensor_delta.received);
+        mesh_sensor_delta_active = WICED_FALSE;
+        mesh_sensor_delta_send();
+    }
+}
+
+/*
+ * End of the delta. When the rebuilt image matches its CRC-32, the firmware upgrade library
+ * verifies and activates it and the device restarts with the new image.
+ */
+void mesh_sensor_delta_finish(void)
+{
+    if (mesh_sensor_delta_active)
+    {
+        mesh_sensor_delta_active = WICED_FALSE;
+        sensor_delta_finish(&mesh_sensor_delta);
+    }
+    mesh_sensor_delta_send();
+
+    if (mesh_sensor_delta.status == SENSOR_DELTA_STATUS_OK)
+    {
+        WICED_BT_TRACE("delta: image rebuilt len:%d\n", mesh_sensor_delta.written);
+        wiced_firmware_upgrade_finish();
+    }
+}
+
+void mesh_sensor_delta_send(void)
+{
+    uint8_t buf[9];
+    uint8_t *p = buf;
+
+    UINT8_TO_STREAM(p, mesh_sensor_delta.status);
+    UINT32_TO_STREAM(p, mesh_sensor_delta.received);
+    UINT32_TO_STREAM(p, mesh_sensor_delta.written);
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_OTA_DELTA, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * The running image is read from the flash at the address of its partition
+ */
+wiced_bool_t mesh_sensor_delta_read_old(uint32_t offset, uint8_t *p_data, uint32_t len)
+{
+    return wiced_hal_eflash_read(OTA_DELTA_IMAGE_ADDR + offset, p_data, len) == WICED_SUCCESS;
+}
+
+wiced_bool_t mesh_sensor_delta_write_new(uint32_t offset, uint8_t *p_data, uint32_t len)
+{
+    return wiced_firmware_upgrade_store_to_nv(offset, p_data, len) == len;
+}
+#endif
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+/*
+ * Send low power node sleep statistics to the host. The requested sleep time is an upper bound of the
+ * time spent in ePDS, the device wakes up earlier on motion or on the mesh core activity.
+ *
+ * A message sent to the device waits in the Friend queue until the next poll. A message sent at a random
+ * time falls in a sleep with a probability proportional to its duration and waits half of it on average,
+ * so the expected downlink latency is the sum of the squared sleeps over twice their sum, plus the receive
+ * delay. The longest sleep is the worst case.
+ */
+void mesh_sensor_lpn_stats_send(void)
+{
+    uint32_t elapsed = wiced_bt_mesh_core_get_tick_count() - mesh_sensor_lpn_stats.start_time;
+    uint32_t per_mille = 0;
+    uint32_t expected_latency = 0;
+    uint8_t  buf[45 + 8 * MESH_SENSOR_LPN_SLEEP_BUCKETS];
+    uint8_t  *p = buf;
+    uint8_t  i;
+
+    if (elapsed != 0)
+    {
+        per_mille = (uint32_t)((uint64_t)mesh_sensor_lpn_stats.sleep_requested_ms * 1000 / elapsed);
+        if (per_mille > 1000)
+            per_mille = 1000;
+    }
+    if (mesh_sensor_lpn_stats.sleep_requested_ms != 0)
+        expected_latency = (uint32_t)(mesh_sensor_lpn_stats.sleep_squared_ms / (2 * (uint64_t)mesh_sensor_lpn_stats.sleep_requested_ms)) +
+                           mesh_config.low_power.receive_delay;
+    UINT8_TO_STREAM(p, MESH_SENSOR_LPN_CHIP);
+    UINT32_TO_STREAM(p, elapsed);
+    UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.sleeps);
+    UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.suspended);
+    UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.hid_off_failures);
+    UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.motion_wakes);
+    UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.sleep_requested_ms);
+    UINT16_TO_STREAM(p, per_mille);
+    UINT32_TO_STREAM(p, expected_latency);
+    UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.sleep_max + mesh_config.low_power.receive_delay);
+    UINT32_TO_STREAM(p, sensor_lpn_max_sleep(&mesh_sensor_lpn_poll, &sensor_profiles[mesh_sensor_profile]));
+    UINT32_TO_STREAM(p, mesh_config.low_power.poll_timeout);
+    UINT8_TO_STREAM(p, mesh_config.low_power.receive_delay);
+    UINT8_TO_STREAM(p, MESH_SENSOR_LPN_SLEEP_BUCKETS);
+    for (i = 0; i < MESH_SENSOR_LPN_SLEEP_BUCKETS; i++)
+    {
+        UINT32_TO_STREAM(p, mesh_sensor_lpn_sleep_bounds[i]);
+        UINT32_TO_STREAM(p, mesh_sensor_lpn_stats.sleep_buckets[i]);
+    }
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_MOTION_EVENT_LPN_STATS, buf, (uint16_t)(p - buf));
+}
+
+/*
+ * Replace the poll settings of the profile and save them in the NVRAM. The maximum sleep is applied
+ * immediately, the poll timeout and receive delay are requested from the Friend when the device restarts.
+ * The settings are rejected if the poll timeout is out of the range of the specification, or if it does
+ * not exceed the maximum sleep, as the Friend would then terminate the friendship between two polls.
+ */
+void mesh_sensor_lpn_poll_set(uint8_t *p_data, uint32_t length)
+{
+    sensor_lpn_poll_t poll;
+    wiced_result_t    result;
+
+    if (length < 9)
+        return;
+
+    STREAM_TO_UINT32(poll.max_sleep, p_data);
+    STREAM_TO_UINT32(poll.poll_timeout, p_data);
+    STREAM_TO_UINT8(poll.receive_delay, p_data);
+
+    if (!sensor_lpn_poll_check(&poll, &sensor_profiles[mesh_sensor_profile]))
+    {
+        WICED_BT_TRACE("invalid lpn max_sleep:%d poll_timeout:%d\n", sensor_lpn_max_sleep(&poll, &sensor_profiles[mesh_sensor_profile]),
+                       sensor_lpn_poll_timeout(&poll, &sensor_profiles[mesh_sensor_profile]));
+        return;
+    }
+    mesh_sensor_lpn_poll = poll;
+
+    WICED_BT_TRACE("lpn max_sleep:%d poll_timeout:%d receive_delay:%d\n", mesh_sensor_lpn_poll.max_sleep, mesh_sensor_lpn_poll.poll_timeout, mesh_sensor_lpn_poll.receive_delay);
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_LPN_POLL_VSID, sizeof(mesh_sensor_lpn_poll), (uint8_t *)&mesh_sensor_lpn_poll, &result);
+}
+#endif
+#endif
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+/*
+ * RAM is not retained in HID-Off. Save the presence change log and the time mapping in the NVRAM
+ * before entering it, so that the changes which have not been read yet survive the sleep.
+ */
+void mesh_sensor_occupancy_save(uint32_t sleep_duration)
+{
+    mesh_sensor_occupancy_saved_t saved;
+    wiced_result_t result;
+
+    saved.time_map       = mesh_sensor_time_map;
+    memcpy(saved.log, mesh_sensor_occupancy, sizeof(saved.log));
+    saved.first          = mesh_sensor_occupancy_first;
+    saved.count          = mesh_sensor_occupancy_count;
+    saved.dropped        = mesh_sensor_occupancy_dropped;
+    memcpy(saved.rule_due, mesh_sensor_rules.due, sizeof(saved.rule_due));
+    saved.rule_pending   = mesh_sensor_rules.pending;
+    saved.sleep_tick     = wiced_bt_mesh_core_get_tick_count();
+    saved.sleep_duration = sleep_duration;
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_OCCUPANCY_VSID, sizeof(saved), (uint8_t *)&saved, &result);
+}
+
+/*
+ * Restore the log saved before HID-Off. The tick count restarted at the wake, the saved ticks are
+ * moved to the new count assuming that the device slept for the whole duration. After a timed wake
+ * that is exact and the saved mapping is used until the next Time Status. After a motion interrupt
+ * the sleep duration is not known, the saved mapping is kept aside and the restored changes are
+ * corrected when the time is received again. Without a mapping these changes cannot be placed on
+ * the wall clock and are counted as dropped. The delayed rules are moved the same way. The sleep
+ * ends when the next one is due, so after a timed wake it fires on time. After a motion interrupt
+ * it fires late by the time slept, unless the presence detected cancels it, as for a vacant rule.
+ */
+void mesh_sensor_occupancy_restore(void)
+{
+    mesh_sensor_occupancy_saved_t saved;
+    wiced_result_t result;
+    wiced_bool_t   timed_wake = WICED_FALSE;
+    uint32_t       restart_tick;
+    uint8_t        i;
+
+    if (wiced_hal_read_nvram(MESH_MOTION_SENSOR_OCCUPANCY_VSID, sizeof(saved), (uint8_t *)&saved, &result) != sizeof(saved))
+        return;
+    sensor_motion_nvram_delete(MESH_MOTION_SENSOR_OCCUPANCY_VSID);
+
+    // the log is saved only for HID-Off, it is stale after a power cycle
+    if (wiced_hal_mia_is_reset_reason_por())
+        return;
+#if defined(CYW20819A1) || defined(CYW20835B1)
+    timed_wake = wiced_hal_mia_is_reset_reason_hid_timeout();
+#endif
+
+    restart_tick = saved.sleep_tick + (timed_wake ? saved.sleep_duration : 0);
+    memcpy(mesh_sensor_rules.due, saved.rule_due, sizeof(mesh_sensor_rules.due));
+    mesh_sensor_rules.pending = saved.rule_pending;
+    sensor_rule_rebase(&mesh_sensor_rules, restart_tick);
+    mesh_sensor_rule_timer_restart(sensor_rule_next_due(&mesh_sensor_rules, wiced_bt_mesh_core_get_tick_count()));
+    WICED_BT_TRACE("rules restored pending:%x\n", mesh_sensor_rules.pending);
+
+    if (!timed_wake && !saved.time_map.synchronized)
+    {
+        mesh_sensor_occupancy_dropped = saved.dropped + saved.count;
+        WICED_BT_TRACE("occupancy log lost:%d\n", saved.count);
+        return;
+    }
+
+    for (i = 0; i < saved.count; i++)
+        saved.log[(saved.first + i) % MESH_SENSOR_OCCUPANCY_LOG_SIZE].tick -= restart_tick;
+    sensor_time_map_rebase(&saved.time_map, restart_tick);
+
+    memcpy(mesh_sensor_occupancy, saved.log, sizeof(mesh_sensor_occupancy));
+    mesh_sensor_occupancy_first   = saved.first;
+    mesh_sensor_occupancy_count   = saved.count;
+    mesh_sensor_occupancy_dropped = saved.dropped;
+    if (timed_wake)
+    {
+        mesh_sensor_time_map = saved.time_map;
+    }
+    else
+    {
+        mesh_sensor_time_map_restored  = saved.time_map;
+        mesh_sensor_occupancy_restored = saved.count;
+    }
+    WICED_BT_TRACE("occupancy log restored:%d timed:%d\n", saved.count, timed_wake);
+}
+
+/*
+ * Time has been received after a wake with an unknown sleep duration. The restored changes were
+ * placed assuming no sleep at all, move them back by the time the saved mapping is behind.
+ */
+void mesh_sensor_occupancy_correct(void)
+{
+    int32_t offset;
+    uint8_t i;
+
+    if (mesh_sensor_occupancy_restored == 0)
+        return;
+
+    offset = sensor_time_map_offset(&mesh_sensor_time_map_restored, &mesh_sensor_time_map, wiced_bt_mesh_core_get_tick_count());
+    for (i = 0; i < mesh_sensor_occupancy_restored; i++)
+        mesh_sensor_occupancy[(mesh_sensor_occupancy_first + i) % MESH_SENSOR_OCCUPANCY_LOG_SIZE].tick -= (uint32_t)offset;
+    WICED_BT_TRACE("occupancy log corrected:%d offset:%dms\n", mesh_sensor_occupancy_restored, offset);
+    mesh_sensor_occupancy_restored = 0;
+}
+
+void mesh_sensor_motion_lpn_sleep(uint32_t max_sleep_duration)
+{
+    uint8_t  bucket = 0;
+
+    WICED_BT_TRACE("Mesh core allow max_sleep_duration:%ds configured:%ds presence:%d\n", max_sleep_duration / 1000, mesh_sensor_sleep_max_time / 1000, presence_detected);
+
+    // Do not sleep while a phone is connected through the GATT proxy
+    if (mesh_sensor_proxy_connected)
+    {
+        WICED_BT_TRACE("GATT connected, sleep suspended\n");
+        app_state.lpn_state = MESH_LPN_STATE_NOT_IDLE;
+        mesh_sensor_lpn_stats.suspended++;
+        return;
+    }
+
+    // Sleep is limited by the profile, by the cadence timer while presence is detected and by the next delayed rule
+    max_sleep_duration = sensor_lpn_sleep_duration(&mesh_sensor_lpn_poll, &sensor_profiles[mesh_sensor_profile], max_sleep_duration,
+                                                   mesh_sensor_sleep_max_time, presence_detected,
+                                                   sensor_rule_next_due(&mesh_sensor_rules, wiced_bt_mesh_core_get_tick_count()));
 
     // We think if sleep timer is bigger than 30mins, then hid-off will save more power. But it's up to your design.
-    if (max_sleep_duration < 1800000)// 30mins
+    if (!sensor_lpn_hid_off(max_sleep_duration))
     {
         WICED_BT_TRACE("Get ready to go into ePDS sleep, duration=%d\n\r", max_sleep_duration);
         app_state.lpn_state = MESH_LPN_STATE_IDLE;
+        mesh_sensor_lpn_stats.sleeps++;
+        mesh_sensor_lpn_stats.sleep_requested_ms += max_sleep_duration;
+        mesh_sensor_lpn_stats.sleep_squared_ms += (uint64_t)max_sleep_duration * max_sleep_duration;
+        if (max_sleep_duration > mesh_sensor_lpn_stats.sleep_max)
+            mesh_sensor_lpn_stats.sleep_max = max_sleep_duration;
+        while (max_sleep_duration > mesh_sensor_lpn_sleep_bounds[bucket])
+            bucket++;
+        mesh_sensor_lpn_stats.sleep_buckets[bucket]++;
     }
     else
     {
         WICED_BT_TRACE("Get ready to go into HID-OFF, duration=%d\n\r", max_sleep_duration);
+        mesh_sensor_occupancy_save(max_sleep_duration);
         wiced_sleep_enter_hid_off(max_sleep_duration, e93196_usr_cfg.doci_pin, WICED_GPIO_ACTIVE_HIGH);
         WICED_BT_TRACE("Entering HID-Off failed\n\r");
+        sensor_motion_nvram_delete(MESH_MOTION_SENSOR_OCCUPANCY_VSID);
+        mesh_sensor_lpn_stats.hid_off_failures++;
     }
 }
 
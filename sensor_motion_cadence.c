@@ -0,0 +1,174 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Sensor cadence evaluation specialized per property value type.
+ */
+#include "wiced_bt_trace.h"
+#include "sensor_motion_cadence.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Percentage trigger deltas are in 0.01% units
+#define SENSOR_CADENCE_PERCENT_100                      10000
+
+/******************************************************
+ *          Macros
+ ******************************************************/
+#define SENSOR_CADENCE_MAGNITUDE_UNSIGNED(x)            (x)
+#define SENSOR_CADENCE_MAGNITUDE_SIGNED(x)              (((x) < 0) ? -(x) : (x))
+
+/*
+ * Publication is needed if the publish period expired, or if the value has changed more than
+ * specified in the triggers, or if the value is in the fast cadence range and the fast
+ * cadence period expired. Nothing can be published before the min interval expires. The min interval is
+ * passed in the timing, so that the application can apply a different one than configured in the cadence.
+ */
+#define SENSOR_CADENCE_DEFINE_PUB_NEEDED(type)                                                                      \
+wiced_bool_t sensor_cadence_pub_needed_##type(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,              \
+                                              sensor_cadence_##type##_t current, sensor_cadence_##type##_t published, \
+                                              const sensor_cadence_timing_t *p_timing)                             \
+{                                                                                                                   \
+    if ((p_timing->min_interval != 0) && (p_timing->elapsed < p_timing->min_interval))                              \
+        return WICED_FALSE;                                                                                         \
+    if ((p_timing->publish_period != 0) && (p_timing->elapsed >= p_timing->publish_period))                         \
+        return WICED_TRUE;                                                                                          \
+    if (sensor_cadence_trigger_##type(p_cadence, current, published))                                               \
+        return WICED_TRUE;                                                                                          \
+    return (p_timing->fast_publish_period != 0) && (p_timing->elapsed >= p_timing->fast_publish_period) &&          \
+           sensor_cadence_fast_##type(p_cadence, current);                                                          \
+}
+
+/*
+ * If cadence high is more than cadence low, the value should be in range (low, high].
+ * If cadence high is less than cadence low, the value should be out of range [high, low).
+ * If they are equal, the value should be equal to them.
+ */
+#define SENSOR_CADENCE_DEFINE_FAST(type)                                                                            \
+wiced_bool_t sensor_cadence_fast_##type(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,                    \
+                                        sensor_cadence_##type##_t current)                                          \
+{                                                                                                                   \
+    sensor_cadence_##type##_t low  = (sensor_cadence_##type##_t)p_cadence->fast_cadence_low;                        \
+    sensor_cadence_##type##_t high = (sensor_cadence_##type##_t)p_cadence->fast_cadence_high;                       \
+                                                                                                                    \
+    if (high > low)                                                                                                 \
+        return (current > low) && (current <= high);                                                                \
+    if (high < low)                                                                                                 \
+        return (current >= low) || (current < high);                                                                \
+    return current == low;                                                                                          \
+}
+
+/*
+ * Native triggers fire if the difference is at least the delta. Percentage triggers fire if
+ * the difference relative to the current value is more than the delta. The difference is
+ * calculated in the wide type so that it cannot overflow.
+ */
+#define SENSOR_CADENCE_DEFINE_TRIGGER(type, wide_t, magnitude)                                                      \
+wiced_bool_t sensor_cadence_trigger_##type(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,                 \
+                                           sensor_cadence_##type##_t current, sensor_cadence_##type##_t published) \
+{                                                                                                                   \
+    wide_t   delta;                                                                                                 \
+    wide_t   base;                                                                                                  \
+    uint32_t threshold;                                                                                             \
+                                                                                                                    \
+    if (current > published)                                                                                        \
+    {                                                                                                               \
+        threshold = p_cadence->trigger_delta_up;                                                                    \
+        delta     = (wide_t)current - (wide_t)published;                                                            \
+    }                                                                                                               \
+    else if (current < published)                                                                                   \
+    {                                                                                                               \
+        threshold = p_cadence->trigger_delta_down;                                                                  \
+        delta     = (wide_t)published - (wide_t)current;                                                            \
+    }                                                                                                               \
+    else                                                                                                            \
+        return WICED_FALSE;                                                                                         \
+                                                                                                                    \
+    if (threshold == 0)                                                                                             \
+        return WICED_FALSE;                                                                                         \
+    if (!p_cadence->trigger_type_percentage)                                                                        \
+        return delta >= (wide_t)threshold;                                                                          \
+    base = magnitude((wide_t)current);                                                                              \
+    if (base == 0)                                                                                                  \
+        return WICED_TRUE;                                                                                          \
+    return (delta * SENSOR_CADENCE_PERCENT_100 / base) > (wide_t)threshold;                                         \
+}
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Boolean values can only change by one in either direction, which is 100% of the change.
+ */
+wiced_bool_t sensor_cadence_trigger_boolean(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,
+                                            sensor_cadence_boolean_t current, sensor_cadence_boolean_t published)
+{
+    uint32_t threshold;
+
+    if (current == published)
+        return WICED_FALSE;
+
+    threshold = current ? p_cadence->trigger_delta_up : p_cadence->trigger_delta_down;
+    if (p_cadence->trigger_type_percentage)
+        return (threshold != 0) && (threshold < SENSOR_CADENCE_PERCENT_100);
+    return threshold == 1;
+}
+
+/*
+ * For boolean values the range check reduces to a lookup of the two possible values
+ */
+wiced_bool_t sensor_cadence_fast_boolean(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,
+                                         sensor_cadence_boolean_t current)
+{
+    return sensor_cadence_fast_u8(p_cadence, current != 0);
+}
+
+SENSOR_CADENCE_DEFINE_PUB_NEEDED(boolean)
+
+SENSOR_CADENCE_DEFINE_TRIGGER(u8, uint32_t, SENSOR_CADENCE_MAGNITUDE_UNSIGNED)
+SENSOR_CADENCE_DEFINE_FAST(u8)
+SENSOR_CADENCE_DEFINE_PUB_NEEDED(u8)
+
+SENSOR_CADENCE_DEFINE_TRIGGER(u16, uint32_t, SENSOR_CADENCE_MAGNITUDE_UNSIGNED)
+SENSOR_CADENCE_DEFINE_FAST(u16)
+SENSOR_CADENCE_DEFINE_PUB_NEEDED(u16)
+
+SENSOR_CADENCE_DEFINE_TRIGGER(u24, uint64_t, SENSOR_CADENCE_MAGNITUDE_UNSIGNED)
+SENSOR_CADENCE_DEFINE_FAST(u24)
+SENSOR_CADENCE_DEFINE_PUB_NEEDED(u24)
+
+SENSOR_CADENCE_DEFINE_TRIGGER(s32, int64_t, SENSOR_CADENCE_MAGNITUDE_SIGNED)
+SENSOR_CADENCE_DEFINE_FAST(s32)
+SENSOR_CADENCE_DEFINE_PUB_NEEDED(s32)
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Sensor cadence evaluation.
+ *
+ * The Sensor Cadence state decides if a sensor value shall be published based on the
+ * time since the last publication, the trigger deltas and the fast cadence range.
+ * The evaluation is specialized per property value type. The application selects the
+ * implementation at compile time with the value type tag of the property, for example
+ *
+ *     #define SENSOR_PUBLISH_VALUE_TYPE  boolean
+ *     SENSOR_CADENCE_PUB_NEEDED(SENSOR_PUBLISH_VALUE_TYPE, &p_sensor->cadence, value, pub_value, &timing);
+ *
+ * Supported value type tags
+ *   boolean - boolean properties, for example Presence Detected
+ *   u8   - one octet unsigned properties, for example Percentage 8
+ *   u16  - two octets unsigned or fixed point properties, for example Time Second 16
+ *   u24  - three octets unsigned or fixed point properties, for example Illuminance
+ *   s32  - signed properties up to four octets
+ */
+#ifndef SENSOR_MOTION_CADENCE_H__
+#define SENSOR_MOTION_CADENCE_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_mesh_models.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// C types of the sensor values for each value type tag
+typedef uint8_t  sensor_cadence_boolean_t;
+typedef uint8_t  sensor_cadence_u8_t;
+typedef uint16_t sensor_cadence_u16_t;
+typedef uint32_t sensor_cadence_u24_t;
+typedef int32_t  sensor_cadence_s32_t;
+
+typedef struct
+{
+    uint32_t elapsed;                   // time in ms since the value was published last time
+    uint32_t publish_period;            // publish period in ms, 0 if periodic publishing is disabled
+    uint32_t fast_publish_period;       // publish period in ms when value is in the fast cadence range, 0 if not configured
+    uint32_t min_interval;              // minimum interval in ms between publications, normally the cadence min interval
+} sensor_cadence_timing_t;
+
+/******************************************************
+ *          Macros
+ ******************************************************/
+#define SENSOR_CADENCE_FN_(fn, type)    sensor_cadence_##fn##_##type
+#define SENSOR_CADENCE_FN(fn, type)     SENSOR_CADENCE_FN_(fn, type)
+#define SENSOR_CADENCE_T_(type)         sensor_cadence_##type##_t
+#define SENSOR_CADENCE_T(type)          SENSOR_CADENCE_T_(type)
+
+// C type of the value for the value type tag
+#define SENSOR_CADENCE_VALUE_T(type)                                        SENSOR_CADENCE_T(type)
+
+// Returns WICED_TRUE if the change from the published value exceeds the configured trigger delta
+#define SENSOR_CADENCE_TRIGGER(type, p_cadence, current, published)         SENSOR_CADENCE_FN(trigger, type)(p_cadence, current, published)
+
+// Returns WICED_TRUE if the value is in the fast cadence range
+#define SENSOR_CADENCE_FAST(type, p_cadence, current)                       SENSOR_CADENCE_FN(fast, type)(p_cadence, current)
+
+// Returns WICED_TRUE if the value shall be published now
+#define SENSOR_CADENCE_PUB_NEEDED(type, p_cadence, current, published, p_timing) \
+    SENSOR_CADENCE_FN(pub_needed, type)(p_cadence, current, published, p_timing)
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+#define SENSOR_CADENCE_DECLARE(type)                                                                                            \
+    wiced_bool_t sensor_cadence_trigger_##type(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,                         \
+                                               sensor_cadence_##type##_t current, sensor_cadence_##type##_t published);          \
+    wiced_bool_t sensor_cadence_fast_##type(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,                            \
+                                            sensor_cadence_##type##_t current);                                                 \
+    wiced_bool_t sensor_cadence_pub_needed_##type(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,                      \
+                                                  sensor_cadence_##type##_t current, sensor_cadence_##type##_t published,      \
+                                                  const sensor_cadence_timing_t *p_timing);
+
+SENSOR_CADENCE_DECLARE(boolean)
+SENSOR_CADENCE_DECLARE(u8)
+SENSOR_CADENCE_DECLARE(u16)
+SENSOR_CADENCE_DECLARE(u24)
+SENSOR_CADENCE_DECLARE(s32)
+
+#endif // SENSOR_MOTION_CADENCE_H__
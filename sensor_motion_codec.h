@@ -0,0 +1,148 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Typed sensor property value encoders.
+ *
+ * Each encoder writes the value in the Mesh Device Properties format (little endian)
+ * directly to the buffer which is sent in the Sensor Status message, and returns the
+ * pointer past the encoded value. Encoded length of each format is a compile time
+ * constant, so that buffers can be sized and checked at compile time, for example
+ *
+ *     #define MESH_SENSOR_VALUE_CODEC  boolean
+ *     uint8_t buf[SENSOR_CODEC_LEN(MESH_SENSOR_VALUE_CODEC)];
+ *     SENSOR_CODEC_ENCODE(MESH_SENSOR_VALUE_CODEC, buf, value);
+ *
+ * Supported formats
+ *   boolean        - Boolean, for example Presence Detected
+ *   percentage8    - Percentage 8, value in 0.5% units
+ *   time_second_16 - Time Second 16, value in seconds
+ *   illuminance_24 - Illuminance, value in 0.01 lux units
+ *
+ * In the Sensor Status message each value follows a Marshalled Property ID, 2 bytes (format A)
+ * for values up to 16 bytes and property IDs below 0x800, 3 bytes (format B) otherwise. A
+ * Sensor Status longer than the unsegmented access payload is segmented, which multiplies
+ * the airtime and the chance of loss, SENSOR_CODEC_STATUS_ENTRY_LEN sizes the entries so that
+ * the set of properties can be checked at compile time.
+ */
+#ifndef SENSOR_MOTION_CODEC_H__
+#define SENSOR_MOTION_CODEC_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_CODEC_LEN_boolean                        1
+#define SENSOR_CODEC_LEN_percentage8                    1
+#define SENSOR_CODEC_LEN_time_second_16                 2
+#define SENSOR_CODEC_LEN_illuminance_24                 3
+
+#define SENSOR_CODEC_PERCENTAGE8_MAX                    200         // 100%
+#define SENSOR_CODEC_PERCENTAGE8_UNKNOWN                0xff
+#define SENSOR_CODEC_TIME_SECOND_16_UNKNOWN             0xffff
+#define SENSOR_CODEC_ILLUMINANCE_24_MAX                 0xfffffe
+#define SENSOR_CODEC_ILLUMINANCE_24_UNKNOWN             0xffffff
+
+#define SENSOR_CODEC_MPID_FORMAT_A_LEN                  2
+#define SENSOR_CODEC_MPID_FORMAT_B_LEN                  3
+#define SENSOR_CODEC_MPID_FORMAT_A_MAX_VALUE_LEN        16
+#define SENSOR_CODEC_MPID_FORMAT_A_MAX_PROPERTY_ID      0x7ff
+
+// Unsegmented access message is 11 bytes with the 32 bit TransMIC, the Sensor Status opcode takes 1 byte of it
+#define SENSOR_CODEC_UNSEGMENTED_ACCESS_LEN             11
+#define SENSOR_CODEC_SENSOR_STATUS_OPCODE_LEN           1
+#define SENSOR_CODEC_STATUS_UNSEGMENTED_MAX             (SENSOR_CODEC_UNSEGMENTED_ACCESS_LEN - SENSOR_CODEC_SENSOR_STATUS_OPCODE_LEN)
+
+/******************************************************
+ *          Macros
+ ******************************************************/
+#define SENSOR_CODEC_LEN_(codec)                        SENSOR_CODEC_LEN_##codec
+#define SENSOR_CODEC_FN_(codec)                         sensor_codec_encode_##codec
+
+// Encoded length of the format
+#define SENSOR_CODEC_LEN(codec)                         SENSOR_CODEC_LEN_(codec)
+
+// Encode value to the buffer p, returns pointer past the value
+#define SENSOR_CODEC_ENCODE(codec, p, value)            SENSOR_CODEC_FN_(codec)(p, value)
+
+// Length of the shortest Marshalled Property ID for the property and value length
+#define SENSOR_CODEC_MPID_LEN(property_id, value_len)                               \
+    ((((value_len) <= SENSOR_CODEC_MPID_FORMAT_A_MAX_VALUE_LEN) &&                  \
+      ((property_id) <= SENSOR_CODEC_MPID_FORMAT_A_MAX_PROPERTY_ID)) ?              \
+     SENSOR_CODEC_MPID_FORMAT_A_LEN : SENSOR_CODEC_MPID_FORMAT_B_LEN)
+
+// Length of a property in the Sensor Status message
+#define SENSOR_CODEC_STATUS_ENTRY_LEN(property_id, value_len)                       \
+    (SENSOR_CODEC_MPID_LEN(property_id, value_len) + (value_len))
+
+// Compilation fails if the condition is false
+#define SENSOR_CODEC_STATIC_ASSERT(cond, name)          typedef char sensor_codec_assert_##name[(cond) ? 1 : -1]
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+static inline uint8_t *sensor_codec_encode_boolean(uint8_t *p, int32_t value)
+{
+    *p++ = (value != 0) ? 1 : 0;
+    return p;
+}
+
+static inline uint8_t *sensor_codec_encode_percentage8(uint8_t *p, int32_t value)
+{
+    *p++ = ((value < 0) || (value > SENSOR_CODEC_PERCENTAGE8_MAX)) ? SENSOR_CODEC_PERCENTAGE8_UNKNOWN : (uint8_t)value;
+    return p;
+}
+
+static inline uint8_t *sensor_codec_encode_time_second_16(uint8_t *p, int32_t value)
+{
+    uint16_t val = ((value < 0) || (value >= SENSOR_CODEC_TIME_SECOND_16_UNKNOWN)) ? SENSOR_CODEC_TIME_SECOND_16_UNKNOWN : (uint16_t)value;
+
+    *p++ = (uint8_t)val;
+    *p++ = (uint8_t)(val >> 8);
+    return p;
+}
+
+static inline uint8_t *sensor_codec_encode_illuminance_24(uint8_t *p, int32_t value)
+{
+    uint32_t val = (value < 0) ? SENSOR_CODEC_ILLUMINANCE_24_UNKNOWN :
+                   ((uint32_t)value > SENSOR_CODEC_ILLUMINANCE_24_MAX) ? SENSOR_CODEC_ILLUMINANCE_24_MAX : (uint32_t)value;
+
+    *p++ = (uint8_t)val;
+    *p++ = (uint8_t)(val >> 8);
+    *p++ = (uint8_t)(val >> 16);
+    return p;
+}
+
+#endif // SENSOR_MOTION_CODEC_H__
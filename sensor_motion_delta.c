@@ -0,0 +1,320 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Delta OTA image patch applier.
+ */
+#include <string.h>
+#include "sensor_motion_delta.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Same as tools/ota_delta.py
+#define SENSOR_DELTA_MAGIC              "SMD1"
+#define SENSOR_DELTA_OP_COPY            0
+#define SENSOR_DELTA_OP_ADD             1
+
+// Decoder states
+#define SENSOR_DELTA_STATE_HEADER       0
+#define SENSOR_DELTA_STATE_OP           1
+#define SENSOR_DELTA_STATE_COPY_OFFSET  2
+#define SENSOR_DELTA_STATE_COPY_COUNT   3
+#define SENSOR_DELTA_STATE_ADD_COUNT    4
+#define SENSOR_DELTA_STATE_ADD_DATA     5
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t sensor_delta_operand(sensor_delta_t *p_delta, uint8_t byte);
+static void         sensor_delta_header(sensor_delta_t *p_delta);
+static void         sensor_delta_copy(sensor_delta_t *p_delta, uint32_t count);
+static void         sensor_delta_add(sensor_delta_t *p_delta, const uint8_t *p_data, uint32_t len);
+static void         sensor_delta_flush(sensor_delta_t *p_delta);
+static uint32_t     sensor_delta_crc32(uint32_t crc, const uint8_t *p_data, uint32_t len);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+// CRC-32 of zlib, reflected polynomial 0xEDB88320, computed 4 bits at a time to keep the table small
+static const uint32_t sensor_delta_crc_table[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+void sensor_delta_init(sensor_delta_t *p_delta, sensor_delta_read_t read_old, sensor_delta_write_t write_new, uint32_t old_len, uint32_t max_len)
+{
+    memset(p_delta, 0, sizeof(sensor_delta_t));
+    p_delta->read_old  = read_old;
+    p_delta->write_new = write_new;
+    p_delta->old_len   = old_len;
+    p_delta->max_len   = max_len;
+    p_delta->crc       = 0xFFFFFFFF;
+    p_delta->state     = SENSOR_DELTA_STATE_HEADER;
+    p_delta->status    = SENSOR_DELTA_STATUS_OK;
+}
+
+/*
+ * Apply the next chunk of the delta. Returns the status, which stays set after an error.
+ */
+uint8_t sensor_delta_process(sensor_delta_t *p_delta, const uint8_t *p_data, uint32_t len)
+{
+    uint32_t n;
+
+    p_delta->received += len;
+    while ((len != 0) && (p_delta->status == SENSOR_DELTA_STATUS_OK))
+    {
+        switch (p_delta->state)
+        {
+        case SENSOR_DELTA_STATE_HEADER:
+            // the header is collected in the write buffer, which is not in use yet
+            n = SENSOR_DELTA_HEADER_LEN - p_delta->buf_len;
+            if (n > len)
+                n = len;
+            memcpy(&p_delta->buf[p_delta->buf_len], p_data, n);
+            p_delta->buf_len += n;
+            p_data += n;
+            len -= n;
+            if (p_delta->buf_len == SENSOR_DELTA_HEADER_LEN)
+                sensor_delta_header(p_delta);
+            break;
+
+        case SENSOR_DELTA_STATE_OP:
+            if (*p_data == SENSOR_DELTA_OP_COPY)
+                p_delta->state = SENSOR_DELTA_STATE_COPY_OFFSET;
+            else if (*p_data == SENSOR_DELTA_OP_ADD)
+                p_delta->state = SENSOR_DELTA_STATE_ADD_COUNT;
+            else
+                p_delta->status = SENSOR_DELTA_STATUS_FORMAT;
+            p_delta->value = 0;
+            p_delta->shift = 0;
+            p_data++;
+            len--;
+            break;
+
+        case SENSOR_DELTA_STATE_COPY_OFFSET:
+            if (sensor_delta_operand(p_delta, *p_data++))
+            {
+                p_delta->copy_offset = p_delta->value;
+                p_delta->value       = 0;
+                p_delta->shift       = 0;
+                p_delta->state       = SENSOR_DELTA_STATE_COPY_COUNT;
+            }
+            len--;
+            break;
+
+        case SENSOR_DELTA_STATE_COPY_COUNT:
+            if (sensor_delta_operand(p_delta, *p_data++))
+            {
+                sensor_delta_copy(p_delta, p_delta->value);
+                p_delta->state = SENSOR_DELTA_STATE_OP;
+            }
+            len--;
+            break;
+
+        case SENSOR_DELTA_STATE_ADD_COUNT:
+            if (sensor_delta_operand(p_delta, *p_data++))
+            {
+                if (p_delta->value > p_delta->new_len - p_delta->written - p_delta->buf_len)
+                    p_delta->status = SENSOR_DELTA_STATUS_SIZE;
+                p_delta->state = (p_delta->value != 0) ? SENSOR_DELTA_STATE_ADD_DATA : SENSOR_DELTA_STATE_OP;
+            }
+            len--;
+            break;
+
+        case SENSOR_DELTA_STATE_ADD_DATA:
+            // value counts the literal bytes still to come
+            n = (p_delta->value < len) ? p_delta->value : len;
+            sensor_delta_add(p_delta, p_data, n);
+            p_delta->value -= n;
+            p_data += n;
+            len -= n;
+            if (p_delta->value == 0)
+                p_delta->state = SENSOR_DELTA_STATE_OP;
+            break;
+        }
+    }
+    return p_delta->status;
+}
+
+/*
+ * End of the delta. Writes the rest of the new image and checks its length and CRC-32.
+ */
+uint8_t sensor_delta_finish(sensor_delta_t *p_delta)
+{
+    if (p_delta->status != SENSOR_DELTA_STATUS_OK)
+        return p_delta->status;
+
+    if (p_delta->state != SENSOR_DELTA_STATE_OP)
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_INCOMPLETE;
+        return p_delta->status;
+    }
+    sensor_delta_flush(p_delta);
+    if (p_delta->status != SENSOR_DELTA_STATUS_OK)
+        return p_delta->status;
+
+    if (p_delta->written != p_delta->new_len)
+        p_delta->status = SENSOR_DELTA_STATUS_INCOMPLETE;
+    else if ((p_delta->crc ^ 0xFFFFFFFF) != p_delta->new_crc)
+        p_delta->status = SENSOR_DELTA_STATUS_CRC;
+    return p_delta->status;
+}
+
+/*
+ * Decode one byte of an operand, 7 bits per byte starting with the least significant ones, the
+ * top bit is set in all bytes but the last one. Returns WICED_TRUE when the operand is complete.
+ */
+wiced_bool_t sensor_delta_operand(sensor_delta_t *p_delta, uint8_t byte)
+{
+    // an operand is at most 32 bits
+    if ((p_delta->shift > 28) || ((p_delta->shift == 28) && ((byte & 0x70) != 0)))
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_FORMAT;
+        return WICED_FALSE;
+    }
+    p_delta->value |= (uint32_t)(byte & 0x7F) << p_delta->shift;
+    p_delta->shift += 7;
+    return (byte & 0x80) == 0;
+}
+
+void sensor_delta_header(sensor_delta_t *p_delta)
+{
+    uint8_t *p = p_delta->buf;
+
+    p_delta->buf_len = 0;
+    if (memcmp(p, SENSOR_DELTA_MAGIC, 4) != 0)
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_FORMAT;
+        return;
+    }
+    p_delta->new_len = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+    p_delta->new_crc = p[8] | (p[9] << 8) | (p[10] << 16) | ((uint32_t)p[11] << 24);
+    if (p_delta->new_len > p_delta->max_len)
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_SIZE;
+        return;
+    }
+    p_delta->state = SENSOR_DELTA_STATE_OP;
+}
+
+/*
+ * Copy a range of the old image to the new image, through the write buffer
+ */
+void sensor_delta_copy(sensor_delta_t *p_delta, uint32_t count)
+{
+    uint32_t n;
+
+    if ((p_delta->copy_offset > p_delta->old_len) || (count > p_delta->old_len - p_delta->copy_offset))
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_RANGE;
+        return;
+    }
+    if (count > p_delta->new_len - p_delta->written - p_delta->buf_len)
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_SIZE;
+        return;
+    }
+    while ((count != 0) && (p_delta->status == SENSOR_DELTA_STATUS_OK))
+    {
+        n = SENSOR_DELTA_BUFFER_SIZE - p_delta->buf_len;
+        if (n > count)
+            n = count;
+        if (!p_delta->read_old(p_delta->copy_offset, &p_delta->buf[p_delta->buf_len], n))
+        {
+            p_delta->status = SENSOR_DELTA_STATUS_FLASH;
+            return;
+        }
+        p_delta->crc = sensor_delta_crc32(p_delta->crc, &p_delta->buf[p_delta->buf_len], n);
+        p_delta->buf_len     += n;
+        p_delta->copy_offset += n;
+        count                -= n;
+        if (p_delta->buf_len == SENSOR_DELTA_BUFFER_SIZE)
+            sensor_delta_flush(p_delta);
+    }
+}
+
+/*
+ * Add literal bytes of the delta to the new image, through the write buffer
+ */
+void sensor_delta_add(sensor_delta_t *p_delta, const uint8_t *p_data, uint32_t len)
+{
+    uint32_t n;
+
+    while ((len != 0) && (p_delta->status == SENSOR_DELTA_STATUS_OK))
+    {
+        n = SENSOR_DELTA_BUFFER_SIZE - p_delta->buf_len;
+        if (n > len)
+            n = len;
+        memcpy(&p_delta->buf[p_delta->buf_len], p_data, n);
+        p_delta->crc = sensor_delta_crc32(p_delta->crc, p_data, n);
+        p_delta->buf_len += n;
+        p_data           += n;
+        len              -= n;
+        if (p_delta->buf_len == SENSOR_DELTA_BUFFER_SIZE)
+            sensor_delta_flush(p_delta);
+    }
+}
+
+/*
+ * Write the buffered part of the new image to the upgrade partition
+ */
+void sensor_delta_flush(sensor_delta_t *p_delta)
+{
+    if (p_delta->buf_len == 0)
+        return;
+
+    if (!p_delta->write_new(p_delta->written, p_delta->buf, p_delta->buf_len))
+    {
+        p_delta->status = SENSOR_DELTA_STATUS_FLASH;
+        return;
+    }
+    p_delta->written += p_delta->buf_len;
+    p_delta->buf_len  = 0;
+}
+
+uint32_t sensor_delta_crc32(uint32_t crc, const uint8_t *p_data, uint32_t len)
+{
+    while (len-- != 0)
+    {
+        crc ^= *p_data++;
+        crc = (crc >> 4) ^ sensor_delta_crc_table[crc & 0x0F];
+        crc = (crc >> 4) ^ sensor_delta_crc_table[crc & 0x0F];
+    }
+    return crc;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Delta OTA image patch applier.
+ *
+ * A delta rebuilds the new image from the image running on the device. It is generated on the
+ * host by tools/ota_delta.py: the magic "SMD1", the length and the CRC-32 of the new image, then
+ * a list of operations, each a copy of a range of the old image or literal bytes. The delta is
+ * applied while it is received, in chunks of any size. The new image is written to the upgrade
+ * partition through a buffer of one flash write unit, the old image is read from flash, so the
+ * RAM used does not depend on the image size. The CRC-32 of the new image is checked when the
+ * whole delta has been received.
+ */
+#ifndef SENSOR_MOTION_DELTA_H__
+#define SENSOR_MOTION_DELTA_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Size of the write buffer of the new image, one write to the upgrade partition
+#ifndef SENSOR_DELTA_BUFFER_SIZE
+#define SENSOR_DELTA_BUFFER_SIZE        256
+#endif
+
+#define SENSOR_DELTA_HEADER_LEN         12      // magic (4), new image length (4), new image CRC-32 (4)
+
+// Status of the delta
+#define SENSOR_DELTA_STATUS_OK          0       // delta is valid so far, or rebuilt the image at the end
+#define SENSOR_DELTA_STATUS_FORMAT      1       // bad magic, operation or length
+#define SENSOR_DELTA_STATUS_SIZE        2       // new image larger than the upgrade partition or than announced
+#define SENSOR_DELTA_STATUS_RANGE       3       // copy outside of the old image
+#define SENSOR_DELTA_STATUS_FLASH       4       // old image read or new image write failed
+#define SENSOR_DELTA_STATUS_INCOMPLETE  5       // delta ended before the new image was rebuilt
+#define SENSOR_DELTA_STATUS_CRC         6       // rebuilt image does not match the CRC-32
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// Read of the old image and write of the new image at an offset from the start of the image
+typedef wiced_bool_t (*sensor_delta_read_t)(uint32_t offset, uint8_t *p_data, uint32_t len);
+typedef wiced_bool_t (*sensor_delta_write_t)(uint32_t offset, uint8_t *p_data, uint32_t len);
+
+typedef struct
+{
+    sensor_delta_read_t  read_old;
+    sensor_delta_write_t write_new;
+    uint32_t old_len;                   // length of the old image, copies beyond are rejected
+    uint32_t max_len;                   // size of the upgrade partition
+    uint32_t new_len;                   // length of the new image from the header
+    uint32_t new_crc;                   // CRC-32 of the new image from the header
+    uint32_t crc;                       // CRC-32 of the new image produced so far
+    uint32_t written;                   // bytes of the new image written to the upgrade partition
+    uint32_t received;                  // bytes of the delta received
+    uint32_t value;                     // operand being decoded
+    uint32_t copy_offset;               // offset in the old image of the current copy
+    uint8_t  shift;                     // bits of the operand decoded so far
+    uint8_t  state;
+    uint8_t  status;
+    uint16_t buf_len;
+    uint8_t  buf[SENSOR_DELTA_BUFFER_SIZE];
+} sensor_delta_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void    sensor_delta_init(sensor_delta_t *p_delta, sensor_delta_read_t read_old, sensor_delta_write_t write_new, uint32_t old_len, uint32_t max_len);
+uint8_t sensor_delta_process(sensor_delta_t *p_delta, const uint8_t *p_data, uint32_t len);
+uint8_t sensor_delta_finish(sensor_delta_t *p_delta);
+
+#endif // SENSOR_MOTION_DELTA_H__
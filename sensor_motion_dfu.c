@@ -0,0 +1,135 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Mesh Device Firmware Update target support.
+ */
+#ifdef MESH_DFU_SUPPORTED
+
+#include "wiced_bt_trace.h"
+#include "wiced_bt_mesh_models.h"
+#include "sensor_motion_dfu.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#ifndef WICED_BT_MESH_CORE_MODEL_ID_BLOB_TRANSFER_SRV
+#define WICED_BT_MESH_CORE_MODEL_ID_BLOB_TRANSFER_SRV   0x1400
+#endif
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t sensor_motion_dfu_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static wiced_bt_mesh_core_received_msg_handler_t dfu_model_handler = NULL;
+static sensor_motion_dfu_stats_t                 dfu_stats;
+static uint32_t                                  dfu_transfer_start;
+static uint32_t                                  dfu_last_message_time;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Install the handler in front of the BLOB Transfer Server model
+ */
+void sensor_motion_dfu_init(wiced_bt_mesh_core_config_model_t *p_models, uint8_t models_num)
+{
+    uint8_t i;
+
+    for (i = 0; i < models_num; i++)
+    {
+        if ((p_models[i].company_id != MESH_COMPANY_ID_BT_SIG) || (p_models[i].model_id != WICED_BT_MESH_CORE_MODEL_ID_BLOB_TRANSFER_SRV))
+            continue;
+
+        if ((p_models[i].p_message_handler == NULL) || (p_models[i].p_message_handler == sensor_motion_dfu_message_handler))
+            break;
+
+        dfu_model_handler = p_models[i].p_message_handler;
+        p_models[i].p_message_handler = sensor_motion_dfu_message_handler;
+        WICED_BT_TRACE("dfu transfer monitor installed\n");
+        return;
+    }
+    WICED_BT_TRACE("dfu transfer monitor not installed\n");
+}
+
+/*
+ * Note the BLOB Transfer activity and pass the message to the model
+ */
+wiced_bool_t sensor_motion_dfu_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    uint32_t now = wiced_bt_mesh_core_get_tick_count();
+
+    if (p_event != NULL)
+    {
+        if (!sensor_motion_dfu_transfer_active())
+        {
+            dfu_stats.transfers++;
+            dfu_stats.transfer_active = WICED_TRUE;
+            dfu_transfer_start = now;
+            WICED_BT_TRACE("dfu transfer started\n");
+        }
+        dfu_last_message_time = now;
+        dfu_stats.messages++;
+    }
+    return dfu_model_handler(p_event, p_data, data_len);
+}
+
+/*
+ * Returns WICED_TRUE while BLOB Transfer messages keep coming
+ */
+wiced_bool_t sensor_motion_dfu_transfer_active(void)
+{
+    if (dfu_stats.transfer_active && (wiced_bt_mesh_core_get_tick_count() - dfu_last_message_time >= SENSOR_DFU_IDLE_TIMEOUT))
+    {
+        dfu_stats.transfer_active   = WICED_FALSE;
+        dfu_stats.transfer_duration = dfu_last_message_time - dfu_transfer_start;
+        WICED_BT_TRACE("dfu transfer ended duration:%dms messages:%d\n", dfu_stats.transfer_duration, dfu_stats.messages);
+    }
+    return dfu_stats.transfer_active;
+}
+
+void sensor_motion_dfu_get_stats(sensor_motion_dfu_stats_t *p_stats)
+{
+    sensor_motion_dfu_transfer_active();
+
+    *p_stats = dfu_stats;
+    if (dfu_stats.transfer_active)
+        p_stats->transfer_duration = wiced_bt_mesh_core_get_tick_count() - dfu_transfer_start;
+}
+
+#endif // MESH_DFU_SUPPORTED
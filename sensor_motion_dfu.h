@@ -0,0 +1,75 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Mesh Device Firmware Update target support.
+ *
+ * When the device is built with MESH_DFU=1, the mesh models library adds the Firmware Update
+ * Server and the BLOB Transfer Server models to the primary element, so that a distributor can
+ * send a new image to a group of sensors at once. The messages of the BLOB Transfer Server are
+ * watched before they are passed to the model. While a transfer is in progress the application
+ * keeps publishing, but with a longer min interval, so that the sensor traffic does not compete
+ * with the image chunks.
+ */
+#ifndef SENSOR_MOTION_DFU_H__
+#define SENSOR_MOTION_DFU_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_mesh_core.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Transfer is considered finished if no BLOB Transfer message is received for this time in ms
+#define SENSOR_DFU_IDLE_TIMEOUT                         10000
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t     transfers;                 // number of transfers started
+    uint32_t     messages;                  // number of BLOB Transfer Server messages received
+    uint32_t     transfer_duration;         // duration of the last transfer, or of the current transfer so far, in ms
+    wiced_bool_t transfer_active;           // transfer is in progress
+} sensor_motion_dfu_stats_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_motion_dfu_init(wiced_bt_mesh_core_config_model_t *p_models, uint8_t models_num);
+wiced_bool_t sensor_motion_dfu_transfer_active(void);
+void         sensor_motion_dfu_get_stats(sensor_motion_dfu_stats_t *p_stats);
+
+#endif // SENSOR_MOTION_DFU_H__
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Deferred event queue of the motion sensor application.
+ */
+#include <string.h>
+#include "wiced_bt_trace.h"
+#include "wiced_bt_event.h"
+#include "wiced_bt_mesh_core.h"
+#include "sensor_motion_event.h"
+#include "sensor_motion_stack.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    sensor_motion_event_handler_t handler;
+    sensor_motion_event_t         queue[SENSOR_MOTION_EVENT_QUEUE_SIZE];
+    uint8_t                       head;             // index of the oldest pending event
+    uint8_t                       num_pending;      // number of the pending events
+    uint32_t                      pending_mask;     // bit per event type which is pending
+    wiced_bool_t                  drain_scheduled;  // serialized drain is already requested
+} sensor_motion_event_queue_t;
+
+// Compilation fails if an event type does not have a bit in the pending mask
+typedef char sensor_motion_event_assert_mask[(SENSOR_MOTION_EVENT_MAX <= 8 * sizeof(((sensor_motion_event_queue_t *)0)->pending_mask)) ? 1 : -1];
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static int sensor_motion_event_drain(void *data);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static sensor_motion_event_queue_t event_queue;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+void sensor_motion_event_init(sensor_motion_event_handler_t handler)
+{
+    memset(&event_queue, 0, sizeof(event_queue));
+    event_queue.handler = handler;
+}
+
+/*
+ * Post an event to be processed from the application thread. If the event of the same
+ * type is already pending, only its repetition count is incremented.
+ * The function is short and does not call into the mesh stack, so it can be called from
+ * the GPIO interrupt and timer callbacks.
+ */
+wiced_bool_t sensor_motion_event_post(uint8_t type, void *p_arg)
+{
+    sensor_motion_event_t *p_event;
+    uint8_t i;
+
+    if (type >= SENSOR_MOTION_EVENT_MAX)
+        return WICED_FALSE;
+
+    if (event_queue.pending_mask & (1u << type))
+    {
+        for (i = 0; i < event_queue.num_pending; i++)
+        {
+            p_event = &event_queue.queue[(event_queue.head + i) % SENSOR_MOTION_EVENT_QUEUE_SIZE];
+            if (p_event->type == type)
+            {
+                if (p_event->count != 0xff)
+                    p_event->count++;
+                break;
+            }
+        }
+    }
+    else
+    {
+        if (event_queue.num_pending >= SENSOR_MOTION_EVENT_QUEUE_SIZE)
+        {
+            WICED_BT_TRACE("event queue full type:%d\n", type);
+            return WICED_FALSE;
+        }
+        p_event = &event_queue.queue[(event_queue.head + event_queue.num_pending) % SENSOR_MOTION_EVENT_QUEUE_SIZE];
+        p_event->type      = type;
+        p_event->count     = 1;
+        p_event->timestamp = wiced_bt_mesh_core_get_tick_count();
+        p_event->p_arg     = p_arg;
+        event_queue.num_pending++;
+        event_queue.pending_mask |= (1u << type);
+    }
+
+    // One serialized call drains all events pending at that time
+    if (!event_queue.drain_scheduled)
+    {
+        if (wiced_app_event_serialize(sensor_motion_event_drain, NULL) == WICED_SUCCESS)
+            event_queue.drain_scheduled = WICED_TRUE;
+        else
+            WICED_BT_TRACE("event serialize failed\n");
+    }
+    return WICED_TRUE;
+}
+
+/*
+ * Process all pending events in the order they were posted
+ */
+int sensor_motion_event_drain(void *data)
+{
+    sensor_motion_event_t event;
+
+    event_queue.drain_scheduled = WICED_FALSE;
+
+    while (event_queue.num_pending != 0)
+    {
+        event = event_queue.queue[event_queue.head];
+        event_queue.head = (event_queue.head + 1) % SENSOR_MOTION_EVENT_QUEUE_SIZE;
+        event_queue.num_pending--;
+        event_queue.pending_mask &= ~(1u << event.type);
+
+        if (event_queue.handler != NULL)
+            SENSOR_STACK_PROFILE(SENSOR_STACK_EVENT + event.type, event_queue.handler(&event));
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Deferred event queue of the motion sensor application.
+ *
+ * GPIO and timer callbacks only post an event with a time stamp. Events are
+ * processed later from the application thread in one batch. If an event of
+ * the same type is already pending, it is not queued again, instead the pending
+ * entry counts the repetition, so that a burst of PIR edges results in a single
+ * piece of work.
+ */
+#ifndef SENSOR_MOTION_EVENT_H__
+#define SENSOR_MOTION_EVENT_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Event types
+#define SENSOR_MOTION_EVENT_PRESENCE_DETECTED           0   // PIR sensor interrupt
+#define SENSOR_MOTION_EVENT_PRESENCE_TIMEOUT            1   // no PIR interrupt for the presence timeout
+#define SENSOR_MOTION_EVENT_PUBLISH_TIMER               2   // cadence timer expired
+#define SENSOR_MOTION_EVENT_PUBLISH_DEFERRED            3   // rate limiter allows deferred publication
+#define SENSOR_MOTION_EVENT_RELAY_ELECTION              4   // relay election timer expired
+#define SENSOR_MOTION_EVENT_CALIBRATION                 5   // PIR calibration observation window ended
+#define SENSOR_MOTION_EVENT_BUFFER_SAMPLE               6   // buffer pool sampling timer expired
+#define SENSOR_MOTION_EVENT_RULE                        7   // delayed presence rule is due
+#define SENSOR_MOTION_EVENT_MAX                         8
+
+// Maximum number of the events which can be pending at the same time. As events of the
+// same type are coalesced, there is no need to have more than one entry per event type.
+#define SENSOR_MOTION_EVENT_QUEUE_SIZE                  SENSOR_MOTION_EVENT_MAX
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint8_t  type;          // event type
+    uint8_t  count;         // number of times the event was posted while it was pending
+    uint32_t timestamp;     // tick count in ms when the event was posted first time
+    void     *p_arg;        // argument of the first post
+} sensor_motion_event_t;
+
+// Event handler is called from the application thread for each pending event
+typedef void (*sensor_motion_event_handler_t)(sensor_motion_event_t *p_event);
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_motion_event_init(sensor_motion_event_handler_t handler);
+wiced_bool_t sensor_motion_event_post(uint8_t type, void *p_arg);
+
+#endif // SENSOR_MOTION_EVENT_H__
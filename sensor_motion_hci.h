@@ -0,0 +1,147 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application specific WICED HCI commands and events of the motion sensor.
+ *
+ * All multi-octet fields are little endian.
+ */
+#ifndef SENSOR_MOTION_HCI_H__
+#define SENSOR_MOTION_HCI_H__
+
+#define HCI_CONTROL_GROUP_SENSOR_MOTION                         0xE0
+
+/*
+ * Commands
+ */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_CADENCE_STATS_GET     ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x01)    /* Read cadence statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_CADENCE_STATS_RESET   ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x02)    /* Reset cadence statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_CADENCE_BASELINE_SET  ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x03)    /* Save current rates as the baseline, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_NVRAM_STATS_GET       ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x04)    /* Read NVRAM wear and latency statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_NVRAM_STATS_RESET     ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x05)    /* Reset NVRAM statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_COMMISSIONING_GET     ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x06)    /* Read commissioning time measurement, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_RPR_STATS_GET         ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x07)    /* Read Remote Provisioning Server statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_RPR_STATS_RESET       ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x08)    /* Reset Remote Provisioning Server statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_CONNECTION_STATS_GET  ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x09)    /* Read GATT proxy connection statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_ZONE_SET              ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x0A)    /* Zone group address (2), TTL (1), app key index (2) */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_LPN_STATS_GET         ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x0B)    /* Read low power node sleep statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_LPN_STATS_RESET       ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x0C)    /* Reset low power node sleep statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_LATENCY_STATS_GET     ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x0D)    /* Read motion to publication latency statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_LATENCY_STATS_RESET   ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x0E)    /* Reset motion to publication latency statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_WORKLOAD_START        ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x0F)    /* Start synthetic motion: occupancy model (1), seed (4) */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_WORKLOAD_STOP         ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x10)    /* Stop synthetic motion, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_DFU_STATS_GET         ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x11)    /* Read firmware transfer statistics, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_CALIBRATION_START     ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x12)    /* Calibrate PIR in an empty room: window seconds (2), allowed triggers per window (1) */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_CALIBRATION_GET       ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x13)    /* Read PIR calibration state, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_STACK_STATS_GET       ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x14)    /* Read stack high-water marks, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_BUFFER_STATS_GET      ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x15)    /* Read buffer pool telemetry, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_BUFFER_STATS_RESET    ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x16)    /* Reset buffer pool telemetry, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_OCCUPANCY_GET         ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x17)    /* Read and clear the presence change log, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_RULE_SET              ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x18)    /* Index and type (1), delay in minutes (1), destination (2), app key index (2), value (2) */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_RULE_GET              ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x19)    /* Read presence rules, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_LPN_POLL_SET          ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x1A)    /* Max sleep in ms (4), poll timeout in 100 ms (4), receive delay in ms (1), 0 keeps the profile */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_OTA_DELTA_START       ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x1B)    /* Start to receive a delta OTA image, no parameters */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_OTA_DELTA_DATA        ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x1C)    /* Next chunk of the delta written by tools/ota_delta.py */
+#define HCI_CONTROL_SENSOR_MOTION_COMMAND_OTA_DELTA_FINISH      ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x1D)    /* End of the delta, the device restarts with the new image if it is rebuilt */
+
+/*
+ * Events
+ */
+/* Cadence statistics: elapsed ms (4), evaluations (4), publishes (4), timer re-arms (4),
+ * evaluations per hour (4), publishes per hour (4), re-arms per hour (4), regression flags (1) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_CADENCE_STATS           ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x81)
+
+/* NVRAM statistics: elapsed ms (4), writes (4), skipped writes (4), deletes (4), bytes written (4),
+ * measured stall ms (4), modelled stall us (4), modelled erases per sector (4 each), projected erases per year (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_NVRAM_STATS             ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x82)
+
+/* Commissioning: in progress (1), ms from power up to provisioned (4), ms from power up to the first publication (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_COMMISSIONING           ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x83)
+
+/* Remote Provisioning Server: session active (1), sessions (4), scans (4), PDUs forwarded (4), retransmissions (4),
+ * last or current session duration ms (4), total duration of completed sessions ms (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_RPR_STATS               ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x84)
+
+/* GATT proxy connection: connected (1), connections (4), total connected ms (4), estimated charge while connected uA*s (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_CONNECTION_STATS        ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x85)
+
+/* Low power node: chip (1), elapsed ms (4), ePDS sleeps (4), sleeps suspended by a connection (4),
+ * HID-Off failures (4), wakes by motion (4), requested sleep ms (4), requested sleep per mille of the elapsed time (2),
+ * expected and worst case downlink latency ms (4 + 4), max sleep ms (4), poll timeout in 100 ms (4), receive delay ms (1),
+ * number of sleep buckets (1), and for each bucket the upper bound in ms (4) and number of sleeps (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_LPN_STATS               ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x86)
+
+/* Motion to publication latency: elapsed ms (4), samples (4), presence not published (4), 50th percentile ms (4),
+ * 95th percentile ms (4), max ms (4), samples in each bucket up to 50, 100, 200, 300, 500, 1000, 2000 ms and above (4 each) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_LATENCY_STATS           ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x87)
+
+/* Firmware transfer: transfer active (1), transfers (4), BLOB Transfer messages (4), last or current transfer duration ms (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_DFU_STATS               ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x88)
+
+/* PIR calibration: state (1) 0 idle, 1 running, 2 done, 3 no setting within the budget, step (1), sensitivity (1),
+ * pulse count (1), triggers in the last window (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_CALIBRATION             ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x89)
+
+/* Stack high-water marks: profiled depth (2), number of callbacks (1), and for each callback the high-water mark (2)
+ * and the headroom within the profiled depth (2). Callbacks are listed in the order of sensor_motion_stack.h */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_STACK_STATS             ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x8A)
+
+/* Buffer pools: samples (4), publications (4), failed publications (4), zone publications without an event (4),
+ * number of pools (1), and for each pool the buffer size (2), number of buffers (2) and lowest number of free buffers (2) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_BUFFER_STATS            ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x8B)
+
+/* Presence change log: time known (1), uncertainty in 10 ms steps (1), TAI-UTC delta (2), time zone offset (1),
+ * changes dropped (4), number of changes (1), and for each change the TAI seconds (5), 1/256 s (1) and presence (1) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_OCCUPANCY               ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x8C)
+
+/* Presence rules: messages sent (4), messages not sent (4), pending delayed rules bit mask (1), number of rules (1),
+ * and each rule in the format of the rule set command */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_RULES                   ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x8D)
+
+/* Delta OTA image, sent at the start, when the delta is rejected and at the end: status (1) as SENSOR_DELTA_STATUS
+ * of sensor_motion_delta.h, delta bytes received (4), new image bytes written to the upgrade partition (4) */
+#define HCI_CONTROL_SENSOR_MOTION_EVENT_OTA_DELTA               ((HCI_CONTROL_GROUP_SENSOR_MOTION << 8) | 0x8E)
+
+/* Chip field of the low power node statistics event */
+#define SENSOR_MOTION_CHIP_UNKNOWN                              0x00
+#define SENSOR_MOTION_CHIP_20819                                0x01
+#define SENSOR_MOTION_CHIP_20820                                0x02
+#define SENSOR_MOTION_CHIP_20835                                0x03
+
+/* Regression flags of the cadence statistics event, set when the rate exceeds the baseline */
+#define SENSOR_MOTION_REGRESSION_EVALUATIONS                    0x01
+#define SENSOR_MOTION_REGRESSION_PUBLISHES                      0x02
+#define SENSOR_MOTION_REGRESSION_TIMER_REARMS                   0x04
+
+#endif // SENSOR_MOTION_HCI_H__
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Motion to publication latency histogram.
+ */
+#include <string.h>
+#include "sensor_motion_latency.h"
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+// Upper bounds of the buckets in ms, the last bucket takes everything longer
+static const uint32_t sensor_latency_bounds[SENSOR_LATENCY_BUCKETS] =
+{
+    50, 100, 200, 300, 500, 1000, 2000, SENSOR_LATENCY_UNBOUNDED
+};
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+void sensor_latency_reset(sensor_latency_t *p_latency)
+{
+    memset(p_latency, 0, sizeof(sensor_latency_t));
+}
+
+/*
+ * Count one latency in ms
+ */
+void sensor_latency_record(sensor_latency_t *p_latency, uint32_t latency)
+{
+    uint8_t bucket = 0;
+
+    while (latency > sensor_latency_bounds[bucket])
+        bucket++;
+
+    p_latency->buckets[bucket]++;
+    p_latency->samples++;
+    if (latency > p_latency->max)
+        p_latency->max = latency;
+}
+
+uint32_t sensor_latency_bucket_bound(uint8_t bucket)
+{
+    return (bucket < SENSOR_LATENCY_BUCKETS) ? sensor_latency_bounds[bucket] : SENSOR_LATENCY_UNBOUNDED;
+}
+
+/*
+ * Returns the upper bound of the bucket which contains the percentile, or the longest measured
+ * latency if the percentile falls in the last bucket. Returns 0 if nothing has been measured.
+ */
+uint32_t sensor_latency_percentile(sensor_latency_t *p_latency, uint8_t percent)
+{
+    uint32_t rank;
+    uint32_t count = 0;
+    uint8_t  bucket;
+
+    if (p_latency->samples == 0)
+        return 0;
+
+    // smallest number of samples which covers the percentile
+    rank = (uint32_t)(((uint64_t)p_latency->samples * percent + 99) / 100);
+    if (rank == 0)
+        rank = 1;
+
+    for (bucket = 0; bucket < SENSOR_LATENCY_BUCKETS - 1; bucket++)
+    {
+        count += p_latency->buckets[bucket];
+        if (count >= rank)
+            return (sensor_latency_bounds[bucket] < p_latency->max) ? sensor_latency_bounds[bucket] : p_latency->max;
+    }
+    return p_latency->max;
+}
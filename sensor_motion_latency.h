@@ -0,0 +1,73 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Motion to publication latency histogram.
+ *
+ * Latencies are counted in fixed buckets, so that the percentiles can be estimated on the
+ * device with a few words of RAM. A percentile is reported as the upper bound of the bucket
+ * it falls in.
+ */
+#ifndef SENSOR_MOTION_LATENCY_H__
+#define SENSOR_MOTION_LATENCY_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_LATENCY_BUCKETS          8
+
+// Upper bound of the last bucket, the latencies which do not fit the other buckets
+#define SENSOR_LATENCY_UNBOUNDED        0xFFFFFFFF
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t samples;                           // number of measured latencies
+    uint32_t max;                               // longest measured latency in ms
+    uint32_t buckets[SENSOR_LATENCY_BUCKETS];   // number of latencies in each bucket
+} sensor_latency_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void     sensor_latency_reset(sensor_latency_t *p_latency);
+void     sensor_latency_record(sensor_latency_t *p_latency, uint32_t latency);
+uint32_t sensor_latency_bucket_bound(uint8_t bucket);
+uint32_t sensor_latency_percentile(sensor_latency_t *p_latency, uint8_t percent);
+
+#endif // SENSOR_MOTION_LATENCY_H__
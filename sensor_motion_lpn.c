@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Low Power Node poll settings and sleep of the motion sensor.
+ */
+#include "sensor_motion_lpn.h"
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Maximum sleep in effect
+ */
+uint32_t sensor_lpn_max_sleep(const sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile)
+{
+    return (p_poll->max_sleep != 0) ? p_poll->max_sleep : p_profile->lpn_max_sleep;
+}
+
+/*
+ * Poll timeout in effect
+ */
+uint32_t sensor_lpn_poll_timeout(const sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile)
+{
+    return (p_poll->poll_timeout != 0) ? p_poll->poll_timeout : p_profile->lpn_poll_timeout;
+}
+
+/*
+ * Check the poll settings against the profile. A receive delay below the minimum is raised to it.
+ * Returns WICED_FALSE if the poll timeout is out of range or does not exceed the maximum sleep.
+ */
+wiced_bool_t sensor_lpn_poll_check(sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile)
+{
+    uint32_t poll_timeout = sensor_lpn_poll_timeout(p_poll, p_profile);
+
+    if ((p_poll->receive_delay != 0) && (p_poll->receive_delay < SENSOR_LPN_RECEIVE_DELAY_MIN))
+        p_poll->receive_delay = SENSOR_LPN_RECEIVE_DELAY_MIN;
+
+    return (poll_timeout >= SENSOR_LPN_POLL_TIMEOUT_MIN) && (poll_timeout <= SENSOR_LPN_POLL_TIMEOUT_MAX) &&
+           (poll_timeout > sensor_lpn_max_sleep(p_poll, p_profile) / 100);
+}
+
+/*
+ * Sleep duration out of the one allowed by the mesh core. Sleep is limited by the profile, one minute
+ * in the balanced profile. If presence is detected we cannot sleep for more than the cadence timer,
+ * otherwise we can sleep until the next LPN poll. The device wakes when the next delayed rule is
+ * due, rule_due is the time until then, 0 if no rule is pending.
+ */
+uint32_t sensor_lpn_sleep_duration(const sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile, uint32_t max_sleep_duration,
+                                   uint32_t cadence_timeout, wiced_bool_t presence_detected, uint32_t rule_due)
+{
+    uint32_t max_sleep = sensor_lpn_max_sleep(p_poll, p_profile);
+
+    if (max_sleep_duration > max_sleep)
+        max_sleep_duration = max_sleep;
+
+    if (presence_detected && (cadence_timeout != 0) && (cadence_timeout < max_sleep_duration))
+        max_sleep_duration = cadence_timeout;
+
+    if ((rule_due != 0) && (rule_due < max_sleep_duration))
+        max_sleep_duration = rule_due;
+
+    return max_sleep_duration;
+}
+
+/*
+ * HID-Off or ePDS for the sleep duration
+ */
+wiced_bool_t sensor_lpn_hid_off(uint32_t sleep_duration)
+{
+    return sleep_duration >= SENSOR_LPN_HID_OFF_MIN_SLEEP;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Low Power Node poll settings and sleep of the motion sensor.
+ *
+ * The poll settings replace the maximum sleep, poll timeout and receive delay of the performance
+ * profile, a value of 0 keeps the value of the profile. The settings are rejected if the poll
+ * timeout is out of the range of the Mesh Profile specification, or if it does not exceed the
+ * maximum sleep, as the Friend would then terminate the friendship between two polls.
+ *
+ * The sleep allowed by the mesh core is limited by the maximum sleep, while presence is detected
+ * by the cadence timer, and by the next delayed presence rule, which has to fire on time even if
+ * the device is in HID-Off. Sleeps of 30 minutes and longer are done in HID-Off, the
+ * shorter ones in ePDS. The application and tools/lpn_sim.c make the same decisions.
+ */
+#ifndef SENSOR_MOTION_LPN_H__
+#define SENSOR_MOTION_LPN_H__
+
+#include "wiced_bt_types.h"
+#include "sensor_motion_profile.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Receive delay range allowed by the Mesh Profile specification
+#define SENSOR_LPN_RECEIVE_DELAY_MIN    10
+
+// Poll timeout range allowed by the Mesh Profile specification in 100ms units
+#define SENSOR_LPN_POLL_TIMEOUT_MIN     0x00000A
+#define SENSOR_LPN_POLL_TIMEOUT_MAX     0x34BBFF
+
+// If the sleep is 30 minutes or longer HID-Off saves more power than ePDS
+#define SENSOR_LPN_HID_OFF_MIN_SLEEP    1800000
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// Poll settings which replace the ones of the profile, 0 keeps the value of the profile
+typedef struct
+{
+    uint32_t max_sleep;             // maximum sleep in ms
+    uint32_t poll_timeout;          // poll timeout in 100ms units, applied at start up
+    uint8_t  receive_delay;         // receive delay in ms, applied at start up
+} sensor_lpn_poll_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+uint32_t     sensor_lpn_max_sleep(const sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile);
+uint32_t     sensor_lpn_poll_timeout(const sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile);
+wiced_bool_t sensor_lpn_poll_check(sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile);
+uint32_t     sensor_lpn_sleep_duration(const sensor_lpn_poll_t *p_poll, const sensor_profile_t *p_profile, uint32_t max_sleep_duration,
+                                       uint32_t cadence_timeout, wiced_bool_t presence_detected, uint32_t rule_due);
+wiced_bool_t sensor_lpn_hid_off(uint32_t sleep_duration);
+
+#endif // SENSOR_MOTION_LPN_H__
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * NVRAM access with wear and latency accounting.
+ */
+#include <string.h>
+#include "wiced_bt_trace.h"
+#include "wiced_hal_nvram.h"
+#include "wiced_bt_mesh_core.h"
+#include "sensor_motion_nvram.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Largest record which is compared with the stored data before it is written
+#define SENSOR_MOTION_NVRAM_MAX_COMPARE_LEN             32
+
+#define SENSOR_MOTION_NVRAM_MS_PER_YEAR                 (365ULL * 24 * 3600 * 1000)
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static void sensor_motion_nvram_account(uint16_t record_length);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static sensor_motion_nvram_stats_t nvram_stats;
+static uint32_t                    nvram_sector_used;   // bytes used in the current sector
+static uint8_t                     nvram_sector;        // index of the current sector
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Write data to the NVRAM unless the same data is already stored
+ */
+uint16_t sensor_motion_nvram_write(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    uint8_t  stored[SENSOR_MOTION_NVRAM_MAX_COMPARE_LEN];
+    uint32_t start_time;
+    uint16_t written;
+
+    if ((data_length <= sizeof(stored)) &&
+        (wiced_hal_read_nvram(vs_id, data_length, stored, p_status) == data_length) &&
+        (memcmp(stored, p_data, data_length) == 0))
+    {
+        WICED_BT_TRACE("NVRAM id:%x unchanged, write skipped\n", vs_id);
+        nvram_stats.writes_skipped++;
+        *p_status = WICED_SUCCESS;
+        return data_length;
+    }
+
+    start_time = wiced_bt_mesh_core_get_tick_count();
+    written = wiced_hal_write_nvram(vs_id, data_length, p_data, p_status);
+    nvram_stats.stall_ms += wiced_bt_mesh_core_get_tick_count() - start_time;
+    nvram_stats.writes++;
+
+    sensor_motion_nvram_account(data_length);
+    return written;
+}
+
+/*
+ * Delete data from the NVRAM. Delete is stored as an empty record.
+ */
+void sensor_motion_nvram_delete(uint16_t vs_id)
+{
+    wiced_result_t result;
+    uint32_t       start_time = wiced_bt_mesh_core_get_tick_count();
+
+    wiced_hal_delete_nvram(vs_id, &result);
+    nvram_stats.stall_ms += wiced_bt_mesh_core_get_tick_count() - start_time;
+    nvram_stats.deletes++;
+
+    sensor_motion_nvram_account(0);
+}
+
+/*
+ * Account record in the flash model. The record is appended to the current sector.
+ * If it does not fit, the next sector is erased and used.
+ */
+void sensor_motion_nvram_account(uint16_t record_length)
+{
+    uint32_t length = record_length + SENSOR_MOTION_NVRAM_RECORD_OVERHEAD;
+
+    if (nvram_sector_used + length > SENSOR_MOTION_NVRAM_SECTOR_SIZE)
+    {
+        nvram_sector = (nvram_sector + 1) % SENSOR_MOTION_NVRAM_NUM_SECTORS;
+        nvram_stats.sector_erases[nvram_sector]++;
+        nvram_stats.model_stall_us += SENSOR_MOTION_NVRAM_ERASE_TIME_US;
+        nvram_sector_used = 0;
+    }
+    nvram_sector_used             += length;
+    nvram_stats.bytes_written     += length;
+    nvram_stats.model_stall_us    += length * SENSOR_MOTION_NVRAM_PROGRAM_TIME_US_PER_BYTE;
+}
+
+void sensor_motion_nvram_stats_reset(void)
+{
+    memset(&nvram_stats, 0, sizeof(nvram_stats));
+    nvram_stats.start_time = wiced_bt_mesh_core_get_tick_count();
+}
+
+void sensor_motion_nvram_get_stats(sensor_motion_nvram_stats_t *p_stats)
+{
+    *p_stats = nvram_stats;
+}
+
+/*
+ * Projected number of sector erase cycles per year at the current rate of writes
+ */
+uint32_t sensor_motion_nvram_erases_per_year(void)
+{
+    uint32_t elapsed = wiced_bt_mesh_core_get_tick_count() - nvram_stats.start_time;
+
+    if (elapsed == 0)
+        return 0;
+
+    // Use written bytes rather than counted erases, so that short runs give a projection too
+    return (uint32_t)((uint64_t)nvram_stats.bytes_written * SENSOR_MOTION_NVRAM_MS_PER_YEAR / elapsed / SENSOR_MOTION_NVRAM_SECTOR_SIZE);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * NVRAM access with wear and latency accounting.
+ *
+ * The application writes NVRAM through these functions. A write of the data which is
+ * already stored is skipped. Every write is accounted in a model of the flash where the
+ * volatile section NVRAM is stored: records are appended to a sector, and when the
+ * sector is full the data is compacted into the next one which has to be erased first.
+ * The model gives estimated erase cycles per sector and the time the CPU is stalled by
+ * flash operations, so that the cost of the reconfiguration can be measured on a device.
+ */
+#ifndef SENSOR_MOTION_NVRAM_H__
+#define SENSOR_MOTION_NVRAM_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_result.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_MOTION_NVRAM_SECTOR_SIZE                 4096    // size of the flash sector in bytes
+#define SENSOR_MOTION_NVRAM_NUM_SECTORS                 2       // sectors used by the volatile section NVRAM
+#define SENSOR_MOTION_NVRAM_RECORD_OVERHEAD             8       // header stored with each record
+#define SENSOR_MOTION_NVRAM_ERASE_TIME_US               40000   // typical sector erase time
+#define SENSOR_MOTION_NVRAM_PROGRAM_TIME_US_PER_BYTE    3       // typical page program time per byte
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t start_time;                                        // tick count when statistics were reset
+    uint32_t writes;                                            // number of NVRAM writes
+    uint32_t writes_skipped;                                    // number of writes skipped because data did not change
+    uint32_t deletes;                                           // number of NVRAM deletes
+    uint32_t bytes_written;                                     // bytes written including record overhead
+    uint32_t stall_ms;                                          // measured time spent in NVRAM writes and deletes
+    uint32_t model_stall_us;                                    // modelled time spent in flash program and erase
+    uint32_t sector_erases[SENSOR_MOTION_NVRAM_NUM_SECTORS];    // modelled erase cycles per sector
+} sensor_motion_nvram_stats_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+uint16_t sensor_motion_nvram_write(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+void     sensor_motion_nvram_delete(uint16_t vs_id);
+void     sensor_motion_nvram_stats_reset(void);
+void     sensor_motion_nvram_get_stats(sensor_motion_nvram_stats_t *p_stats);
+uint32_t sensor_motion_nvram_erases_per_year(void);
+
+#endif // SENSOR_MOTION_NVRAM_H__
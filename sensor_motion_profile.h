@@ -0,0 +1,77 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Performance profiles of the motion sensor.
+ *
+ * A profile trades the latency of the presence reports for battery life. It sets the blind time
+ * of the PIR sensor, the min interval of the cadence and the friendship parameters of the Low
+ * Power Node. The table is shared by the application, which selects the profile with the profile
+ * setting, and by the host tools which model the application.
+ */
+#ifndef SENSOR_MOTION_PROFILE_H__
+#define SENSOR_MOTION_PROFILE_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Performance profiles selected with the profile setting of the motion sensor
+#define SENSOR_PROFILE_LOW_LATENCY      0
+#define SENSOR_PROFILE_BALANCED         1
+#define SENSOR_PROFILE_MAX_BATTERY      2
+#define SENSOR_PROFILE_MAX              3
+
+// After presence is detected, interrupts are disabled for 7 seconds in the balanced profile
+#define SENSOR_PROFILE_BLIND_TIME       7
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// Latency and power trade-offs of a performance profile
+typedef struct
+{
+    uint8_t  blind_time;            // seconds the PIR does not interrupt after presence is detected, presence times out after twice that
+    uint32_t min_interval;          // cadence min interval in ms
+    uint32_t lpn_max_sleep;         // maximum LPN sleep in ms, the Friend queues messages for that time
+    uint32_t lpn_poll_timeout;      // poll timeout in 100ms units requested from the Friend, applied at start up
+} sensor_profile_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+extern const sensor_profile_t sensor_profiles[SENSOR_PROFILE_MAX];
+
+#endif // SENSOR_MOTION_PROFILE_H__
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Publication decisions of the motion sensor.
+ */
+#include "sensor_motion_cadence.h"
+#include "sensor_motion_publish.h"
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Min interval between publications. Configured cadence value is extended while a firmware image is
+ * transferred, and relaxed while a GATT proxy connection is up.
+ */
+uint32_t sensor_publish_min_interval(const sensor_publish_config_t *p_config)
+{
+    uint32_t min_interval = p_config->p_cadence->min_interval;
+
+    if (p_config->dfu_transfer && (min_interval < SENSOR_PUBLISH_DFU_MIN_INTERVAL))
+        return SENSOR_PUBLISH_DFU_MIN_INTERVAL;
+    if (p_config->proxy_connected && (min_interval > SENSOR_PUBLISH_CONNECTED_MIN_INTERVAL))
+        return SENSOR_PUBLISH_CONNECTED_MIN_INTERVAL;
+    return min_interval;
+}
+
+/*
+ * Rate limiter earns a token every min interval
+ */
+uint32_t sensor_publish_rate_limit_interval(const sensor_publish_config_t *p_config)
+{
+    uint32_t interval = sensor_publish_min_interval(p_config);
+
+    return (interval > SENSOR_PUBLISH_RATE_LIMIT_MIN_INTERVAL) ? interval : SENSOR_PUBLISH_RATE_LIMIT_MIN_INTERVAL;
+}
+
+/*
+ * Timeout of the cadence timer depending on the publication period, fast cadence divisor and minimum
+ * interval, 0 if the timer is not running. The fast publish period is updated if the timer runs.
+ */
+uint32_t sensor_publish_timer_timeout(const sensor_publish_config_t *p_config, uint32_t *p_fast_publish_period)
+{
+    const wiced_bt_mesh_sensor_config_cadence_t *p_cadence = p_config->p_cadence;
+    // If there are no specific cadence settings, publish every publish period.
+    uint32_t timeout = p_config->publish_period;
+    uint32_t min_interval;
+
+    if (timeout == 0)
+        return 0;
+
+    // If fast cadence period divisor is set, we need to check data more
+    // often than publication period.  Publish if measurement is in specified range
+    if (p_cadence->fast_cadence_period_divisor > 1)
+    {
+        timeout = p_config->publish_period / p_cadence->fast_cadence_period_divisor;
+        *p_fast_publish_period = timeout;
+    }
+    else
+    {
+        *p_fast_publish_period = 0;
+    }
+    // should not send data more often than min_interval
+    min_interval = sensor_publish_min_interval(p_config);
+    if ((min_interval != 0) && (min_interval > timeout) && ((p_cadence->trigger_delta_up != 0) || (p_cadence->trigger_delta_down != 0)))
+        timeout = min_interval;
+    return timeout;
+}
+
+/*
+ * Expiration of the cadence timer. Returns WICED_TRUE if the value shall be published to the gateway
+ * because the publish period expired, or the value has changed more than specified in the triggers,
+ * or the value is in the range of fast cadence values and the fast cadence interval expired.
+ */
+wiced_bool_t sensor_publish_on_timer(const sensor_publish_config_t *p_config, uint32_t elapsed, uint32_t fast_publish_period,
+                                     int32_t current, int32_t published)
+{
+    sensor_cadence_timing_t timing;
+
+    timing.elapsed             = elapsed;
+    timing.publish_period      = p_config->publish_period;
+    timing.fast_publish_period = fast_publish_period;
+    timing.min_interval        = sensor_publish_min_interval(p_config);
+
+    return SENSOR_CADENCE_PUB_NEEDED(SENSOR_PUBLISH_VALUE_TYPE, p_config->p_cadence,
+                                     (SENSOR_CADENCE_VALUE_T(SENSOR_PUBLISH_VALUE_TYPE))current,
+                                     (SENSOR_CADENCE_VALUE_T(SENSOR_PUBLISH_VALUE_TYPE))published, &timing);
+}
+
+/*
+ * Change of the sensor value, elapsed is the time since the last publication to the gateway.
+ * Returns the destinations of the publication with the SENSOR_PUBLISH_EVALUATED and
+ * SENSOR_PUBLISH_RESTART_TIMER flags.
+ */
+uint8_t sensor_publish_on_change(const sensor_publish_config_t *p_config, uint32_t elapsed, int32_t current, int32_t published)
+{
+    const wiced_bt_mesh_sensor_config_cadence_t *p_cadence = p_config->p_cadence;
+    uint8_t decision = 0;
+
+    // The change goes to the zone group as it happens, the lights of the zone react to the edges.
+    // The publication to the gateway follows its own cadence, whether a zone is configured or not.
+    if (p_config->zone)
+        decision |= SENSOR_PUBLISH_ZONE;
+
+    // If sensor is configured for periodic publication, the publication to the gateway follows the period
+    if (p_config->publish_period != 0)
+        return decision;
+
+    decision |= SENSOR_PUBLISH_EVALUATED;
+
+    // When periodic publishing is disabled, however, the behavior triggered by a change in
+    // the Sensor Data state shall depend on whether the Sensor Cadence state has been configured.
+    // If Cadence is not configured we should publish on every change. The rate limiter makes sure
+    // that the value is not published too often even if the sensor misbehaves.
+    if ((p_cadence->fast_cadence_period_divisor == 1) && (p_cadence->trigger_delta_up == 0) && (p_cadence->trigger_delta_down == 0))
+        return decision | SENSOR_PUBLISH_GATEWAY;
+
+    if (elapsed < sensor_publish_min_interval(p_config))
+        return decision;
+
+    // If cadence is configured, we will publish if conditions are satisfied
+    if (SENSOR_CADENCE_TRIGGER(SENSOR_PUBLISH_VALUE_TYPE, p_cadence,
+                               (SENSOR_CADENCE_VALUE_T(SENSOR_PUBLISH_VALUE_TYPE))current,
+                               (SENSOR_CADENCE_VALUE_T(SENSOR_PUBLISH_VALUE_TYPE))published))
+        decision |= SENSOR_PUBLISH_GATEWAY | SENSOR_PUBLISH_RESTART_TIMER;
+    return decision;
+}
+
+/*
+ * Take the next pending destination, the zone first because the lights wait for it. Each message
+ * takes a token. Returns 0 if nothing is pending, or if the rate limiter refuses, then p_wait is set
+ * to the time until the next token.
+ */
+uint8_t sensor_publish_next(uint8_t *p_pending, sensor_rate_limit_t *p_limit, uint32_t interval, uint32_t now, uint32_t *p_wait)
+{
+    uint8_t dst;
+
+    *p_wait = 0;
+    if (*p_pending == 0)
+        return 0;
+
+    if (!sensor_rate_limit_take(p_limit, interval, now))
+    {
+        *p_wait = sensor_rate_limit_wait(p_limit, interval, now);
+        return 0;
+    }
+    dst = (*p_pending & SENSOR_PUBLISH_ZONE) ? SENSOR_PUBLISH_ZONE : SENSOR_PUBLISH_GATEWAY;
+    *p_pending &= ~dst;
+    return dst;
+}
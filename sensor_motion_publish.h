@@ -0,0 +1,107 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Publication decisions of the motion sensor.
+ *
+ * Decides when the Sensor Status is published and to which destination, from the cadence, the
+ * publish period, the zone group and the state of the device. Presence changes go to the zone
+ * group as they happen, the reports of the cadence go to the publication address of the Sensor
+ * Server model, for example the gateway. Every message takes a token from the rate limiter, the
+ * messages refused are kept pending per destination and sent when the next token is earned.
+ *
+ * The functions only decide, the caller keeps the published value and time, the pending
+ * destinations and the rate limiter, runs the timers and sends the messages. The application and
+ * the host model of the application, tools/host/sensor_sim.c, make the same decisions.
+ */
+#ifndef SENSOR_MOTION_PUBLISH_H__
+#define SENSOR_MOTION_PUBLISH_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_mesh_models.h"
+#include "sensor_motion_rate_limit.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Value type tag of the cadence evaluation of the published property, see sensor_motion_cadence.h
+#ifndef SENSOR_PUBLISH_VALUE_TYPE
+#define SENSOR_PUBLISH_VALUE_TYPE               boolean
+#endif
+
+// Destinations of the publication
+#define SENSOR_PUBLISH_GATEWAY                  0x01
+#define SENSOR_PUBLISH_ZONE                     0x02
+
+// Decision of a value change in addition to the destinations: the cadence was evaluated, and the
+// cadence timer shall be restarted after the publication
+#define SENSOR_PUBLISH_EVALUATED                0x40
+#define SENSOR_PUBLISH_RESTART_TIMER            0x80
+#define SENSOR_PUBLISH_DST_MASK                 (SENSOR_PUBLISH_GATEWAY | SENSOR_PUBLISH_ZONE)
+
+// Every publication takes a token from the rate limiter. A token is earned every min interval, but
+// not less than every 100 ms even if min interval is not configured, and up to 3 tokens can be saved.
+#define SENSOR_PUBLISH_RATE_LIMIT_MIN_INTERVAL  100
+#define SENSOR_PUBLISH_RATE_LIMIT_BURST         3
+
+// While a GATT proxy connection is up, the value can be published as often as every 100 ms
+#define SENSOR_PUBLISH_CONNECTED_MIN_INTERVAL   100
+
+// Min interval between publications in ms while a firmware image is transferred to the device
+#define SENSOR_PUBLISH_DFU_MIN_INTERVAL         2000
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    const wiced_bt_mesh_sensor_config_cadence_t *p_cadence;
+    uint32_t     publish_period;        // publish period of the Sensor Server model in ms, 0 if not configured
+    wiced_bool_t zone;                  // presence changes are sent to a zone group
+    wiced_bool_t proxy_connected;       // a GATT proxy client is connected
+    wiced_bool_t dfu_transfer;          // a firmware image is transferred to the device
+} sensor_publish_config_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+uint32_t     sensor_publish_min_interval(const sensor_publish_config_t *p_config);
+uint32_t     sensor_publish_rate_limit_interval(const sensor_publish_config_t *p_config);
+uint32_t     sensor_publish_timer_timeout(const sensor_publish_config_t *p_config, uint32_t *p_fast_publish_period);
+wiced_bool_t sensor_publish_on_timer(const sensor_publish_config_t *p_config, uint32_t elapsed, uint32_t fast_publish_period,
+                                     int32_t current, int32_t published);
+uint8_t      sensor_publish_on_change(const sensor_publish_config_t *p_config, uint32_t elapsed, int32_t current, int32_t published);
+uint8_t      sensor_publish_next(uint8_t *p_pending, sensor_rate_limit_t *p_limit, uint32_t interval, uint32_t now, uint32_t *p_wait);
+
+#endif // SENSOR_MOTION_PUBLISH_H__
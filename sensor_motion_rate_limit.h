@@ -0,0 +1,64 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Token bucket publication rate limiter.
+ *
+ * A token is earned every interval, and up to burst tokens can be saved. Each publication
+ * takes one token. When no token is available, the caller defers the publication and sends
+ * the latest value when the next token is available, so that the final state is always sent.
+ */
+#ifndef SENSOR_MOTION_RATE_LIMIT_H__
+#define SENSOR_MOTION_RATE_LIMIT_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t credit;            // saved time in ms, one token is worth one interval
+    uint32_t last_time;         // tick count when the credit was updated
+    uint8_t  burst;             // maximum number of saved tokens
+} sensor_rate_limit_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_rate_limit_init(sensor_rate_limit_t *p_limit, uint8_t burst, uint32_t interval, uint32_t now);
+wiced_bool_t sensor_rate_limit_take(sensor_rate_limit_t *p_limit, uint32_t interval, uint32_t now);
+uint32_t     sensor_rate_limit_wait(sensor_rate_limit_t *p_limit, uint32_t interval, uint32_t now);
+
+#endif // SENSOR_MOTION_RATE_LIMIT_H__
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Relay self-election.
+ */
+#include "wiced_bt_trace.h"
+#include "wiced_bt_mesh_models.h"
+#include "sensor_motion_relay.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_RELAY_OPCODE_SENSOR_STATUS               0x52
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint16_t addr;                  // unicast address of the neighbour, 0 if the entry is free
+    uint32_t last_heard;            // tick count when the neighbour was heard directly
+} sensor_relay_neighbour_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t sensor_relay_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+static void         sensor_relay_neighbour_heard(uint16_t addr, uint32_t now);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static wiced_bt_mesh_core_received_msg_handler_t relay_model_handler = NULL;
+static sensor_relay_neighbour_t                  relay_neighbours[SENSOR_RELAY_MAX_NEIGHBOURS];
+static uint8_t                                   relay_direct_ttl;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Install the handler in front of the Sensor Server model. Direct TTL is the TTL the neighbours
+ * send the presence changes with.
+ */
+void sensor_relay_init(wiced_bt_mesh_core_config_model_t *p_models, uint8_t models_num, uint8_t direct_ttl)
+{
+    uint8_t i;
+
+    relay_direct_ttl = direct_ttl;
+
+    for (i = 0; i < models_num; i++)
+    {
+        if ((p_models[i].company_id != MESH_COMPANY_ID_BT_SIG) || (p_models[i].model_id != WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV))
+            continue;
+
+        if ((p_models[i].p_message_handler == NULL) || (p_models[i].p_message_handler == sensor_relay_message_handler))
+            break;
+
+        relay_model_handler = p_models[i].p_message_handler;
+        p_models[i].p_message_handler = sensor_relay_message_handler;
+        return;
+    }
+    WICED_BT_TRACE("relay election not installed\n");
+}
+
+void sensor_relay_set_direct_ttl(uint8_t direct_ttl)
+{
+    relay_direct_ttl = direct_ttl;
+}
+
+/*
+ * Note the neighbours which send presence changes and pass the message to the model
+ */
+wiced_bool_t sensor_relay_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    if ((p_event != NULL) && (p_event->opcode == SENSOR_RELAY_OPCODE_SENSOR_STATUS) &&
+        (relay_direct_ttl != 0) && (p_event->ttl == relay_direct_ttl))
+    {
+        sensor_relay_neighbour_heard(p_event->src, wiced_bt_mesh_core_get_tick_count());
+    }
+    return relay_model_handler(p_event, p_data, data_len);
+}
+
+/*
+ * Refresh the neighbour, or take a free or the oldest entry for it
+ */
+void sensor_relay_neighbour_heard(uint16_t addr, uint32_t now)
+{
+    sensor_relay_neighbour_t *p_entry = &relay_neighbours[0];
+    uint8_t i;
+
+    for (i = 0; i < SENSOR_RELAY_MAX_NEIGHBOURS; i++)
+    {
+        if (relay_neighbours[i].addr == addr)
+        {
+            p_entry = &relay_neighbours[i];
+            break;
+        }
+        if ((relay_neighbours[i].addr == 0) ||
+            ((p_entry->addr != 0) && (now - relay_neighbours[i].last_heard > now - p_entry->last_heard)))
+            p_entry = &relay_neighbours[i];
+    }
+    p_entry->addr       = addr;
+    p_entry->last_heard = now;
+}
+
+/*
+ * Number of direct neighbours heard recently. Old entries are freed.
+ */
+uint8_t sensor_relay_neighbours(uint32_t now)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    for (i = 0; i < SENSOR_RELAY_MAX_NEIGHBOURS; i++)
+    {
+        if ((relay_neighbours[i].addr != 0) && (now - relay_neighbours[i].last_heard >= SENSOR_RELAY_NEIGHBOUR_TIMEOUT))
+            relay_neighbours[i].addr = 0;
+        if (relay_neighbours[i].addr != 0)
+            count++;
+    }
+    return count;
+}
+
+/*
+ * Returns the relay state the node should have, given the current one
+ */
+wiced_bool_t sensor_relay_elect(wiced_bool_t relay, uint16_t own_addr, uint32_t now)
+{
+    uint8_t neighbours = sensor_relay_neighbours(now);
+    uint8_t lower = 0;
+    uint8_t i;
+
+    // neighbours with lower addresses keep relaying
+    for (i = 0; i < SENSOR_RELAY_MAX_NEIGHBOURS; i++)
+    {
+        if ((relay_neighbours[i].addr != 0) && (relay_neighbours[i].addr < own_addr))
+            lower++;
+    }
+    WICED_BT_TRACE("relay election neighbours:%d lower:%d relay:%d\n", neighbours, lower, relay);
+
+    if (lower < SENSOR_RELAY_KEEP_RELAYS)
+        return WICED_TRUE;
+    if (relay)
+        return (neighbours >= SENSOR_RELAY_DENSE_NEIGHBOURS) ? WICED_FALSE : WICED_TRUE;
+    return (neighbours < SENSOR_RELAY_SPARSE_NEIGHBOURS) ? WICED_TRUE : WICED_FALSE;
+}
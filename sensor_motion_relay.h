@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Relay self-election.
+ *
+ * In a dense cluster of mains powered sensors every node relays every message, although a few
+ * relays would cover the area. Sensors of a zone send presence changes to the zone group with
+ * a small TTL. If the Sensor Server is subscribed to the zone group, the presence changes of
+ * the neighbours are seen before they are passed to the model, and the ones received with the
+ * TTL they were sent with have not been relayed, so the sender is in the direct radio range.
+ *
+ * When enough direct neighbours are heard, a node stops relaying unless it is one of the nodes
+ * with the lowest addresses among them. A node enables relaying again when the number of direct
+ * neighbours drops, or when it becomes one of the lowest addresses. Thresholds are apart, so that
+ * the decision does not flip on a single lost message.
+ *
+ * The election relies on every node of the zone running it with the same rules. A node cannot
+ * tell whether its neighbours with the lower addresses actually relay, their Relay state may
+ * have been disabled by a Config Client, so the coverage is not guaranteed in mixed installations.
+ */
+#ifndef SENSOR_MOTION_RELAY_H__
+#define SENSOR_MOTION_RELAY_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_mesh_core.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_RELAY_MAX_NEIGHBOURS                     16
+
+// Neighbour which has not been heard for this time in ms is forgotten
+#define SENSOR_RELAY_NEIGHBOUR_TIMEOUT                  (6 * 3600 * 1000)
+
+// Relay is disabled when at least this number of direct neighbours is heard ...
+#define SENSOR_RELAY_DENSE_NEIGHBOURS                   4
+// ... and enabled again when fewer than this number is heard
+#define SENSOR_RELAY_SPARSE_NEIGHBOURS                  2
+// Number of nodes with the lowest addresses in the neighbourhood which always relay
+#define SENSOR_RELAY_KEEP_RELAYS                        2
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_relay_init(wiced_bt_mesh_core_config_model_t *p_models, uint8_t models_num, uint8_t direct_ttl);
+void         sensor_relay_set_direct_ttl(uint8_t direct_ttl);
+wiced_bool_t sensor_relay_elect(wiced_bool_t relay, uint16_t own_addr, uint32_t now);
+uint8_t      sensor_relay_neighbours(uint32_t now);
+
+#endif // SENSOR_MOTION_RELAY_H__
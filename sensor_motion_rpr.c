@@ -0,0 +1,177 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Remote Provisioning Server instrumentation and tuning.
+ */
+#ifdef REMOTE_PROVISION_SERVER_SUPPORTED
+
+#include <string.h>
+#include "wiced_bt_trace.h"
+#include "wiced_bt_cfg.h"
+#include "wiced_bt_mesh_models.h"
+#include "sensor_motion_rpr.h"
+
+extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Remote Provisioning Server model opcodes received from the Remote Provisioning Client
+#define RPR_OPCODE_SCAN_START                           0x8052
+#define RPR_OPCODE_EXTENDED_SCAN_START                  0x8056
+#define RPR_OPCODE_LINK_OPEN                            0x8059
+#define RPR_OPCODE_LINK_CLOSE                           0x805A
+#define RPR_OPCODE_PDU_SEND                             0x805D
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t sensor_motion_rpr_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+static void         sensor_motion_rpr_session_end(void);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static wiced_bt_mesh_core_received_msg_handler_t rpr_model_handler = NULL;
+static sensor_motion_rpr_stats_t                 rpr_stats;
+static uint32_t                                  rpr_session_start;
+static uint8_t                                   rpr_last_outbound_pdu_number;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Install the counting handler in front of the Remote Provisioning Server model and
+ * apply the configured scan parameters
+ */
+void sensor_motion_rpr_init(wiced_bt_mesh_core_config_model_t *p_models, uint8_t models_num)
+{
+    uint8_t i;
+
+#if (RPR_SCAN_INTERVAL != 0) && (RPR_SCAN_WINDOW != 0)
+    wiced_bt_cfg_settings.ble_scan_cfg.high_duty_scan_interval = RPR_SCAN_INTERVAL;
+    wiced_bt_cfg_settings.ble_scan_cfg.high_duty_scan_window   = RPR_SCAN_WINDOW;
+    wiced_bt_cfg_settings.ble_scan_cfg.low_duty_scan_interval  = RPR_SCAN_INTERVAL;
+    wiced_bt_cfg_settings.ble_scan_cfg.low_duty_scan_window    = RPR_SCAN_WINDOW;
+#endif
+
+    for (i = 0; i < models_num; i++)
+    {
+        if ((p_models[i].company_id != MESH_COMPANY_ID_BT_SIG) || (p_models[i].model_id != WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_SRV))
+            continue;
+
+        // Model handled by the mesh core itself cannot be instrumented
+        if ((p_models[i].p_message_handler == NULL) || (p_models[i].p_message_handler == sensor_motion_rpr_message_handler))
+            break;
+
+        rpr_model_handler = p_models[i].p_message_handler;
+        p_models[i].p_message_handler = sensor_motion_rpr_message_handler;
+        WICED_BT_TRACE("rpr instrumentation installed\n");
+        return;
+    }
+    WICED_BT_TRACE("rpr instrumentation not installed\n");
+}
+
+/*
+ * Count Remote Provisioning Client messages and pass them to the model
+ */
+wiced_bool_t sensor_motion_rpr_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    if (p_event != NULL)
+    {
+        switch (p_event->opcode)
+        {
+        case RPR_OPCODE_SCAN_START:
+        case RPR_OPCODE_EXTENDED_SCAN_START:
+            rpr_stats.scans++;
+            break;
+
+        case RPR_OPCODE_LINK_OPEN:
+            if (rpr_stats.session_active)
+                sensor_motion_rpr_session_end();
+            rpr_stats.sessions++;
+            rpr_stats.session_active = WICED_TRUE;
+            rpr_stats.session_duration = 0;
+            rpr_session_start = wiced_bt_mesh_core_get_tick_count();
+            rpr_last_outbound_pdu_number = 0;
+            WICED_BT_TRACE("rpr link open session:%d\n", rpr_stats.sessions);
+            break;
+
+        case RPR_OPCODE_LINK_CLOSE:
+            if (rpr_stats.session_active)
+                sensor_motion_rpr_session_end();
+            break;
+
+        case RPR_OPCODE_PDU_SEND:
+            // First octet is the outbound PDU number. Client resends the PDU with the same number
+            // if it did not receive the outbound report.
+            if (data_len != 0)
+            {
+                if (p_data[0] == rpr_last_outbound_pdu_number)
+                    rpr_stats.retransmissions++;
+                else
+                    rpr_stats.pdus_forwarded++;
+                rpr_last_outbound_pdu_number = p_data[0];
+            }
+            break;
+        }
+    }
+    return rpr_model_handler(p_event, p_data, data_len);
+}
+
+void sensor_motion_rpr_session_end(void)
+{
+    rpr_stats.session_duration = wiced_bt_mesh_core_get_tick_count() - rpr_session_start;
+    rpr_stats.total_duration  += rpr_stats.session_duration;
+    rpr_stats.session_active   = WICED_FALSE;
+    WICED_BT_TRACE("rpr link closed duration:%dms pdus:%d retrans:%d\n", rpr_stats.session_duration, rpr_stats.pdus_forwarded, rpr_stats.retransmissions);
+}
+
+void sensor_motion_rpr_get_stats(sensor_motion_rpr_stats_t *p_stats)
+{
+    *p_stats = rpr_stats;
+    if (rpr_stats.session_active)
+        p_stats->session_duration = wiced_bt_mesh_core_get_tick_count() - rpr_session_start;
+}
+
+void sensor_motion_rpr_stats_reset(void)
+{
+    wiced_bool_t session_active = rpr_stats.session_active;
+
+    memset(&rpr_stats, 0, sizeof(rpr_stats));
+    rpr_stats.session_active = session_active;
+}
+
+#endif // REMOTE_PROVISION_SERVER_SUPPORTED
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Remote Provisioning Server instrumentation and tuning.
+ *
+ * When the device is built as a Remote Provisioning Server (REMOTE_PROVISION_SRV=1), the
+ * messages of the Remote Provisioning Server model are counted per provisioning session
+ * before they are passed to the model, and the scan parameters used to find unprovisioned
+ * devices can be configured at build time.
+ */
+#ifndef SENSOR_MOTION_RPR_H__
+#define SENSOR_MOTION_RPR_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_mesh_core.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Scan interval and window in 0.625 ms slots used while looking for unprovisioned devices.
+// Value 0 keeps the platform configuration.
+#ifndef RPR_SCAN_INTERVAL
+#define RPR_SCAN_INTERVAL                               0
+#endif
+#ifndef RPR_SCAN_WINDOW
+#define RPR_SCAN_WINDOW                                 0
+#endif
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t     sessions;                  // number of links opened by the Remote Provisioning Client
+    uint32_t     scans;                     // number of scans started by the Remote Provisioning Client
+    uint32_t     pdus_forwarded;            // provisioning PDUs received from the client to be sent to the device
+    uint32_t     retransmissions;           // provisioning PDUs received again with the same outbound PDU number
+    uint32_t     session_duration;          // duration of the last session, or of the current session so far, in ms
+    uint32_t     total_duration;            // duration of all completed sessions in ms
+    wiced_bool_t session_active;            // link is currently open
+} sensor_motion_rpr_stats_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void sensor_motion_rpr_init(wiced_bt_mesh_core_config_model_t *p_models, uint8_t models_num);
+void sensor_motion_rpr_get_stats(sensor_motion_rpr_stats_t *p_stats);
+void sensor_motion_rpr_stats_reset(void);
+
+#endif // SENSOR_MOTION_RPR_H__
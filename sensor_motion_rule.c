@@ -0,0 +1,191 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Presence rules for local actuation.
+ */
+#include <string.h>
+#include "sensor_motion_rule.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_RULE_MINUTE_MS               60000
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+void sensor_rule_init(sensor_rule_engine_t *p_engine)
+{
+    memset(p_engine, 0, sizeof(sensor_rule_engine_t));
+}
+
+/*
+ * Decode a rule received in a Sensor Setting or HCI command. The first byte carries the index
+ * of the rule in bits 4-7 and the type in bits 0-3, followed by the delay, destination,
+ * application key index and value, little endian.
+ */
+wiced_bool_t sensor_rule_decode(uint8_t *p_data, uint8_t len, uint8_t *p_index, sensor_rule_t *p_rule)
+{
+    if (len < SENSOR_RULE_ENCODED_LEN)
+        return WICED_FALSE;
+
+    *p_index             = p_data[0] >> 4;
+    p_rule->type         = p_data[0] & 0x0f;
+    p_rule->delay        = p_data[1];
+    p_rule->dst          = p_data[2] | (p_data[3] << 8);
+    p_rule->app_key_idx  = p_data[4] | (p_data[5] << 8);
+    p_rule->value        = (int16_t)(p_data[6] | (p_data[7] << 8));
+    return WICED_TRUE;
+}
+
+/*
+ * Encode a rule of the table in the format of the Sensor Setting and HCI command
+ */
+void sensor_rule_encode(uint8_t index, const sensor_rule_t *p_rule, uint8_t *p_data)
+{
+    p_data[0] = (uint8_t)((index << 4) | p_rule->type);
+    p_data[1] = p_rule->delay;
+    p_data[2] = (uint8_t)p_rule->dst;
+    p_data[3] = (uint8_t)(p_rule->dst >> 8);
+    p_data[4] = (uint8_t)p_rule->app_key_idx;
+    p_data[5] = (uint8_t)(p_rule->app_key_idx >> 8);
+    p_data[6] = (uint8_t)p_rule->value;
+    p_data[7] = (uint8_t)((uint16_t)p_rule->value >> 8);
+}
+
+/*
+ * Replace a rule of the table. A rule with no trigger or destination removes the rule.
+ */
+wiced_bool_t sensor_rule_set(sensor_rule_engine_t *p_engine, uint8_t index, const sensor_rule_t *p_rule)
+{
+    if ((index >= SENSOR_RULE_MAX) || (SENSOR_RULE_TRIGGER(p_rule) > SENSOR_RULE_TRIGGER_VACANT) ||
+        (SENSOR_RULE_ACTION(p_rule) > SENSOR_RULE_ACTION_LEVEL))
+        return WICED_FALSE;
+
+    if ((SENSOR_RULE_TRIGGER(p_rule) == SENSOR_RULE_TRIGGER_NONE) || (p_rule->dst == 0))
+        memset(&p_engine->rules[index], 0, sizeof(sensor_rule_t));
+    else
+        p_engine->rules[index] = *p_rule;
+
+    p_engine->pending &= ~(1 << index);
+    return WICED_TRUE;
+}
+
+/*
+ * Presence changed. Delayed rules of the opposite transition are cancelled, rules of this
+ * transition fire now or are armed. Returns the time in ms until the next delayed rule is due,
+ * or 0 if none is pending.
+ */
+uint32_t sensor_rule_transition(sensor_rule_engine_t *p_engine, uint8_t trigger, uint32_t now, sensor_rule_action_t *p_action)
+{
+    uint8_t i;
+    sensor_rule_t *p_rule;
+
+    for (i = 0; i < SENSOR_RULE_MAX; i++)
+    {
+        p_rule = &p_engine->rules[i];
+        if (SENSOR_RULE_TRIGGER(p_rule) == SENSOR_RULE_TRIGGER_NONE)
+            continue;
+
+        if (SENSOR_RULE_TRIGGER(p_rule) != trigger)
+        {
+            p_engine->pending &= ~(1 << i);
+        }
+        else if (p_rule->delay == 0)
+        {
+            p_action(p_rule);
+        }
+        else
+        {
+            p_engine->due[i] = now + (uint32_t)p_rule->delay * SENSOR_RULE_MINUTE_MS;
+            p_engine->pending |= (1 << i);
+        }
+    }
+    return sensor_rule_next_due(p_engine, now);
+}
+
+/*
+ * Fire the delayed rules which are due. Returns the time in ms until the next delayed rule is
+ * due, or 0 if none is pending.
+ */
+uint32_t sensor_rule_expired(sensor_rule_engine_t *p_engine, uint32_t now, sensor_rule_action_t *p_action)
+{
+    uint8_t i;
+
+    for (i = 0; i < SENSOR_RULE_MAX; i++)
+    {
+        if ((p_engine->pending & (1 << i)) && ((int32_t)(now - p_engine->due[i]) >= 0))
+        {
+            p_engine->pending &= ~(1 << i);
+            p_action(&p_engine->rules[i]);
+        }
+    }
+    return sensor_rule_next_due(p_engine, now);
+}
+
+/*
+ * Time in ms until the next delayed rule is due, 1 if one is overdue, or 0 if none is pending.
+ * Due times are compared with the tick count modulo 2^32.
+ */
+uint32_t sensor_rule_next_due(sensor_rule_engine_t *p_engine, uint32_t now)
+{
+    uint8_t  i;
+    uint32_t next = 0;
+    int32_t  remaining;
+
+    for (i = 0; i < SENSOR_RULE_MAX; i++)
+    {
+        if (!(p_engine->pending & (1 << i)))
+            continue;
+
+        remaining = (int32_t)(p_engine->due[i] - now);
+        if (remaining <= 0)
+            remaining = 1;
+        if ((next == 0) || ((uint32_t)remaining < next))
+            next = (uint32_t)remaining;
+    }
+    return next;
+}
+
+/*
+ * The tick count restarted, tick of the old count is 0 of the new one
+ */
+void sensor_rule_rebase(sensor_rule_engine_t *p_engine, uint32_t tick)
+{
+    uint8_t i;
+
+    for (i = 0; i < SENSOR_RULE_MAX; i++)
+        p_engine->due[i] -= tick;
+}
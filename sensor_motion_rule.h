@@ -0,0 +1,105 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Presence rules for local actuation.
+ *
+ * A rule sends a Generic OnOff or Generic Level Set to a group when the room becomes occupied
+ * or vacant, immediately or after a number of minutes. A delayed rule is cancelled by the
+ * opposite transition, so "vacant for 10 minutes" fires only if presence is not detected again.
+ * Rules are kept in a fixed table of 8 byte entries which is stored in the NVRAM as is.
+ * Delayed rules waiting to fire are due at a tick count, which restarts on the wake from HID-Off.
+ * The application saves them with the presence change log and moves them to the new tick count
+ * with sensor_rule_rebase.
+ */
+#ifndef SENSOR_MOTION_RULE_H__
+#define SENSOR_MOTION_RULE_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_RULE_MAX                     4
+
+// Transition which triggers the rule, a rule with no trigger is not used
+#define SENSOR_RULE_TRIGGER_NONE            0
+#define SENSOR_RULE_TRIGGER_OCCUPIED        1
+#define SENSOR_RULE_TRIGGER_VACANT          2
+
+// Message sent by the rule
+#define SENSOR_RULE_ACTION_ONOFF            0
+#define SENSOR_RULE_ACTION_LEVEL            1
+
+#define SENSOR_RULE_TYPE(trigger, action)   ((uint8_t)(((action) << 2) | (trigger)))
+#define SENSOR_RULE_TRIGGER(p_rule)         ((p_rule)->type & 0x03)
+#define SENSOR_RULE_ACTION(p_rule)          (((p_rule)->type >> 2) & 0x03)
+
+// Length of a rule in the Sensor Setting and HCI command
+#define SENSOR_RULE_ENCODED_LEN             8
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint8_t  type;                  // trigger and action, see SENSOR_RULE_TYPE
+    uint8_t  delay;                 // minutes from the transition to the action
+    uint16_t dst;                   // group or unicast address the message is sent to
+    uint16_t app_key_idx;           // application key used to send the message
+    int16_t  value;                 // OnOff state or Level
+} sensor_rule_t;
+
+typedef struct
+{
+    sensor_rule_t rules[SENSOR_RULE_MAX];
+    uint32_t      due[SENSOR_RULE_MAX];     // tick count when a delayed rule fires
+    uint8_t       pending;                  // bit mask of the delayed rules waiting to fire
+} sensor_rule_engine_t;
+
+typedef void (sensor_rule_action_t)(const sensor_rule_t *p_rule);
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_rule_init(sensor_rule_engine_t *p_engine);
+wiced_bool_t sensor_rule_decode(uint8_t *p_data, uint8_t len, uint8_t *p_index, sensor_rule_t *p_rule);
+void         sensor_rule_encode(uint8_t index, const sensor_rule_t *p_rule, uint8_t *p_data);
+wiced_bool_t sensor_rule_set(sensor_rule_engine_t *p_engine, uint8_t index, const sensor_rule_t *p_rule);
+uint32_t     sensor_rule_transition(sensor_rule_engine_t *p_engine, uint8_t trigger, uint32_t now, sensor_rule_action_t *p_action);
+uint32_t     sensor_rule_expired(sensor_rule_engine_t *p_engine, uint32_t now, sensor_rule_action_t *p_action);
+uint32_t     sensor_rule_next_due(sensor_rule_engine_t *p_engine, uint32_t now);
+void         sensor_rule_rebase(sensor_rule_engine_t *p_engine, uint32_t tick);
+
+#endif // SENSOR_MOTION_RULE_H__
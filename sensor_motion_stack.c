@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Stack usage profiling.
+ */
+#ifdef STACK_PROFILE
+
+#include "sensor_motion_stack.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_STACK_PATTERN                            0xA5A5A5A5
+#define SENSOR_STACK_PAINT_WORDS                        (STACK_PROFILE_DEPTH / sizeof(uint32_t))
+
+// Words skipped below the painting function's local variable, so that the function does not
+// overwrite its own frame
+#define SENSOR_STACK_GUARD_WORDS                        4
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static uint32_t *sensor_stack_top;                      // first word below the painted area's top
+static uint16_t sensor_stack_max[SENSOR_STACK_NUM];     // high-water mark of each callback in bytes
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Paint the stack below the caller. The function must not be inlined, its frame is where the
+ * frame of the profiled callback will be.
+ */
+__attribute__((noinline)) void sensor_stack_paint(void)
+{
+    volatile uint32_t marker = 0;
+    uint32_t *p;
+    uint32_t i;
+
+    sensor_stack_top = (uint32_t *)&marker - SENSOR_STACK_GUARD_WORDS;
+    p = sensor_stack_top;
+    for (i = 0; i < SENSOR_STACK_PAINT_WORDS; i++)
+        *--p = SENSOR_STACK_PATTERN;
+}
+
+/*
+ * Find the deepest word overwritten by the callback and update its high-water mark
+ */
+void sensor_stack_record(uint8_t id)
+{
+    uint32_t *p = sensor_stack_top - SENSOR_STACK_PAINT_WORDS;
+    uint16_t used;
+
+    while ((p < sensor_stack_top) && (*p == SENSOR_STACK_PATTERN))
+        p++;
+
+    used = (uint16_t)((sensor_stack_top - p) * sizeof(uint32_t));
+    if ((id < SENSOR_STACK_NUM) && (used > sensor_stack_max[id]))
+        sensor_stack_max[id] = used;
+}
+
+/*
+ * Returns the deepest stack use of the callback in bytes. If it equals STACK_PROFILE_DEPTH the
+ * callback has used the whole painted area and possibly more.
+ */
+uint16_t sensor_stack_high_water(uint8_t id)
+{
+    return (id < SENSOR_STACK_NUM) ? sensor_stack_max[id] : 0;
+}
+
+#endif // STACK_PROFILE
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Stack usage profiling.
+ *
+ * When the device is built with STACK_PROFILE=1, the free stack below the caller is painted
+ * with a pattern before an application callback is called, and the deepest overwritten word
+ * is found when the callback returns. The high-water mark of each callback is kept and can
+ * be read over WICED HCI with the headroom left within the painted depth.
+ *
+ * The painted depth (STACK_PROFILE_DEPTH) has to be less than the free stack of the
+ * application thread at the callbacks, otherwise painting overwrites the memory below the
+ * stack. It is the stack budget the callbacks are checked against.
+ */
+#ifndef SENSOR_MOTION_STACK_H__
+#define SENSOR_MOTION_STACK_H__
+
+#include "wiced_bt_types.h"
+#include "sensor_motion_event.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Depth in bytes painted below the caller of a callback
+#ifndef STACK_PROFILE_DEPTH
+#define STACK_PROFILE_DEPTH                             1024
+#endif
+
+// Profiled callbacks. Events of the event queue are profiled per event type.
+#define SENSOR_STACK_APP_INIT                           0
+#define SENSOR_STACK_REPORT_HANDLER                     1
+#define SENSOR_STACK_CONFIG_CHANGE_HANDLER              2
+#define SENSOR_STACK_HCI_COMMAND                        3
+#define SENSOR_STACK_EVENT                              4
+#define SENSOR_STACK_NUM                                (SENSOR_STACK_EVENT + SENSOR_MOTION_EVENT_MAX)
+
+#ifdef STACK_PROFILE
+#define SENSOR_STACK_PROFILE(id, call)                  do { sensor_stack_paint(); call; sensor_stack_record(id); } while (0)
+#else
+#define SENSOR_STACK_PROFILE(id, call)                  call
+#endif
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void     sensor_stack_paint(void);
+void     sensor_stack_record(uint8_t id);
+uint16_t sensor_stack_high_water(uint8_t id);
+
+#endif // SENSOR_MOTION_STACK_H__
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Mapping of the mesh core tick count to TAI time.
+ */
+#include <string.h>
+#include "sensor_motion_time.h"
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+void sensor_time_map_reset(sensor_time_map_t *p_map)
+{
+    memset(p_map, 0, sizeof(sensor_time_map_t));
+}
+
+/*
+ * Anchor the mapping to the time received at the tick count. Returns WICED_FALSE and keeps the
+ * previous mapping if the Time Server does not know the time.
+ */
+wiced_bool_t sensor_time_map_update(sensor_time_map_t *p_map, uint64_t tai_seconds, uint8_t subsecond, uint8_t uncertainty,
+                                    int16_t tai_utc_delta, int8_t time_zone_offset, uint32_t tick)
+{
+    if (tai_seconds == SENSOR_TIME_TAI_UNKNOWN)
+        return WICED_FALSE;
+
+    p_map->synchronized     = WICED_TRUE;
+    p_map->tai_seconds      = tai_seconds;
+    p_map->subsecond        = subsecond;
+    p_map->uncertainty      = uncertainty;
+    p_map->tai_utc_delta    = tai_utc_delta;
+    p_map->time_zone_offset = time_zone_offset;
+    p_map->anchor_tick      = tick;
+    return WICED_TRUE;
+}
+
+/*
+ * TAI time at the tick count in milliseconds. The event may be older than the anchor, the tick
+ * counts are compared as a signed difference, which is valid up to 24 days around the anchor.
+ */
+static int64_t sensor_time_tick_to_ms(sensor_time_map_t *p_map, uint32_t tick)
+{
+    int64_t tai_ms;
+
+    tai_ms = (int64_t)p_map->tai_seconds * 1000 + ((uint32_t)p_map->subsecond * 1000) / 256;
+    tai_ms += (int32_t)(tick - p_map->anchor_tick);
+    return tai_ms;
+}
+
+/*
+ * Converts the tick count of an event to TAI seconds and 1/256 of a second. Returns WICED_FALSE
+ * if the time is not known yet.
+ */
+wiced_bool_t sensor_time_tick_to_tai(sensor_time_map_t *p_map, uint32_t tick, uint64_t *p_tai_seconds, uint8_t *p_subsecond)
+{
+    int64_t tai_ms;
+
+    if (!p_map->synchronized)
+        return WICED_FALSE;
+
+    tai_ms = sensor_time_tick_to_ms(p_map, tick);
+
+    *p_tai_seconds = (uint64_t)(tai_ms / 1000);
+    *p_subsecond   = (uint8_t)(((tai_ms % 1000) * 256) / 1000);
+    return WICED_TRUE;
+}
+
+/*
+ * Moves the anchor to a tick count which restarted from 0 at the restart tick of the previous
+ * count, for example after a HID-Off sleep of a known duration.
+ */
+void sensor_time_map_rebase(sensor_time_map_t *p_map, uint32_t restart_tick)
+{
+    p_map->anchor_tick -= restart_tick;
+}
+
+/*
+ * Milliseconds by which the TAI time of the tick count in the second mapping is ahead of the
+ * first one. Both mappings have to be synchronized.
+ */
+int32_t sensor_time_map_offset(sensor_time_map_t *p_from, sensor_time_map_t *p_to, uint32_t tick)
+{
+    return (int32_t)(sensor_time_tick_to_ms(p_to, tick) - sensor_time_tick_to_ms(p_from, tick));
+}
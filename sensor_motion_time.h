@@ -0,0 +1,78 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Mapping of the mesh core tick count to TAI time.
+ *
+ * The tick count is relative to the power up, it restarts after a HID-Off sleep. The mapping
+ * keeps the TAI time received in the last Mesh Time Status together with the tick count when it
+ * was received, so that events stamped with the tick count can be placed on the wall clock
+ * later, including events recorded before the time was known.
+ */
+#ifndef SENSOR_MOTION_TIME_H__
+#define SENSOR_MOTION_TIME_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// TAI seconds value of a Time Status which does not know the time
+#define SENSOR_TIME_TAI_UNKNOWN         0
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    wiced_bool_t synchronized;      // mapping has been received since power up
+    uint64_t     tai_seconds;       // TAI time at the anchor tick, seconds
+    uint8_t      subsecond;         // TAI time at the anchor tick, 1/256 of a second
+    uint8_t      uncertainty;       // uncertainty reported by the Time Server, 10 ms steps
+    int16_t      tai_utc_delta;     // current difference between TAI and UTC, seconds
+    int8_t       time_zone_offset;  // current local time zone offset, 15 minute steps
+    uint32_t     anchor_tick;       // tick count when the time was received
+} sensor_time_map_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_time_map_reset(sensor_time_map_t *p_map);
+wiced_bool_t sensor_time_map_update(sensor_time_map_t *p_map, uint64_t tai_seconds, uint8_t subsecond, uint8_t uncertainty,
+                                    int16_t tai_utc_delta, int8_t time_zone_offset, uint32_t tick);
+wiced_bool_t sensor_time_tick_to_tai(sensor_time_map_t *p_map, uint32_t tick, uint64_t *p_tai_seconds, uint8_t *p_subsecond);
+void         sensor_time_map_rebase(sensor_time_map_t *p_map, uint32_t restart_tick);
+int32_t      sensor_time_map_offset(sensor_time_map_t *p_from, sensor_time_map_t *p_to, uint32_t tick);
+
+#endif // SENSOR_MOTION_TIME_H__
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Synthetic occupancy workload.
+ */
+#ifdef SYNTHETIC_MOTION
+
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "wiced_bt_mesh_core.h"
+#include "sensor_motion_event.h"
+#include "sensor_motion_workload.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    wiced_timer_t                   timer;
+    const sensor_workload_model_t   *p_model;
+    uint32_t                        random;         // xorshift state, never 0
+    uint32_t                        dwell_left;     // remaining occupancy in ms, 0 when the area is empty
+    uint32_t                        blind_time;     // ms after an interrupt when motion does not interrupt
+    uint32_t                        interrupt_time; // tick count of the last interrupt
+    wiced_bool_t                    interrupted;    // at least one interrupt since the start
+    uint32_t                        interrupts;     // number of motion interrupts generated
+    uint32_t                        suppressed;     // number of motions in the blind time
+} sensor_workload_state_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static uint32_t sensor_workload_random(void);
+static uint32_t sensor_workload_exponential(uint32_t mean);
+static void     sensor_workload_timer_callback(TIMER_PARAM_TYPE arg);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static const sensor_workload_model_t sensor_workload_models[SENSOR_WORKLOAD_MODEL_MAX] =
+{
+    // arrival,  dwell,    motion
+    { 1200000,   2700000,  30000 },     // office: every 20 min somebody sits down for 45 min and moves every 30 s
+    { 120000,    8000,     1000 },      // corridor: walk-through every 2 min, 8 s in the field of view
+    { 3600000,   1800000,  5000 },      // meeting room: meeting every hour for 30 min
+    { 14400000,  900000,   3000 },      // cleaning: 15 min round every 4 hours
+};
+
+static sensor_workload_state_t sensor_workload;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+void sensor_workload_init(void)
+{
+    wiced_init_timer(&sensor_workload.timer, sensor_workload_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+}
+
+/*
+ * Blind time of the PIR sensor in ms. Applies to the running model too.
+ */
+void sensor_workload_set_blind_time(uint32_t blind_time)
+{
+    sensor_workload.blind_time = blind_time;
+}
+
+/*
+ * Start generating interrupts with the model. The area is empty at the start.
+ */
+wiced_bool_t sensor_workload_start(uint8_t model, uint32_t seed)
+{
+    if (model >= SENSOR_WORKLOAD_MODEL_MAX)
+        return WICED_FALSE;
+
+    wiced_stop_timer(&sensor_workload.timer);
+
+    sensor_workload.p_model    = &sensor_workload_models[model];
+    sensor_workload.random     = (seed != 0) ? seed : 1;
+    sensor_workload.dwell_left  = 0;
+    sensor_workload.interrupted = WICED_FALSE;
+    sensor_workload.interrupts  = 0;
+    sensor_workload.suppressed  = 0;
+
+    WICED_BT_TRACE("workload start model:%d seed:%d\n", model, seed);
+    wiced_start_timer(&sensor_workload.timer, sensor_workload_exponential(sensor_workload.p_model->mean_arrival));
+    return WICED_TRUE;
+}
+
+void sensor_workload_stop(void)
+{
+    WICED_BT_TRACE("workload stop interrupts:%d suppressed:%d\n", sensor_workload.interrupts, sensor_workload.suppressed);
+    wiced_stop_timer(&sensor_workload.timer);
+    sensor_workload.p_model = NULL;
+}
+
+/*
+ * xorshift32 pseudo random generator
+ */
+uint32_t sensor_workload_random(void)
+{
+    uint32_t x = sensor_workload.random;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sensor_workload.random = x;
+    return x;
+}
+
+/*
+ * Exponentially distributed value with the given mean, -mean * ln(U) with U uniform in (0, 1].
+ * The logarithm is calculated from the position of the most significant bit of a 32 bit random
+ * number and linear interpolation between the powers of two. The mean is about 4% longer than
+ * requested, which is good enough for a workload.
+ */
+uint32_t sensor_workload_exponential(uint32_t mean)
+{
+    uint32_t r = sensor_workload_random();
+    uint32_t msb = 31;
+    uint32_t log2_r;
+    uint32_t delay;
+
+    while ((r & (1UL << msb)) == 0)
+        msb--;
+
+    // log2(r) and -log2(U) = 32 - log2(r) in 1/256 units
+    log2_r = (msb << 8) | (((r << (31 - msb)) >> 23) & 0xFF);
+
+    // ln(2) is about 177/256
+    delay = (uint32_t)((uint64_t)mean * ((32 << 8) - log2_r) * 177 / (256 * 256));
+    return (delay != 0) ? delay : 1;
+}
+
+/*
+ * Start an occupancy, generate the next motion of the occupancy or end it. The motion interrupts
+ * unless it is in the blind time after the last interrupt.
+ */
+void sensor_workload_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    const sensor_workload_model_t *p_model = sensor_workload.p_model;
+    uint32_t now = wiced_bt_mesh_core_get_tick_count();
+    uint32_t delay;
+
+    if (p_model == NULL)
+        return;
+
+    if (sensor_workload.dwell_left == 0)
+    {
+        // somebody comes in, the first movement is seen immediately
+        sensor_workload.dwell_left = sensor_workload_exponential(p_model->mean_dwell);
+    }
+    if (sensor_workload.interrupted && (now - sensor_workload.interrupt_time < sensor_workload.blind_time))
+    {
+        sensor_workload.suppressed++;
+    }
+    else
+    {
+        sensor_workload.interrupted    = WICED_TRUE;
+        sensor_workload.interrupt_time = now;
+        sensor_workload.interrupts++;
+        sensor_motion_event_post(SENSOR_MOTION_EVENT_PRESENCE_DETECTED, NULL);
+    }
+
+    delay = sensor_workload_exponential(p_model->mean_motion);
+    if (delay < sensor_workload.dwell_left)
+    {
+        sensor_workload.dwell_left -= delay;
+    }
+    else
+    {
+        // no more movement before the area becomes empty, wait for the next arrival
+        delay = sensor_workload.dwell_left + sensor_workload_exponential(p_model->mean_arrival);
+        sensor_workload.dwell_left = 0;
+    }
+    wiced_start_timer(&sensor_workload.timer, delay);
+}
+
+#endif // SYNTHETIC_MOTION
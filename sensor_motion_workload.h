@@ -0,0 +1,80 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Synthetic occupancy workload.
+ *
+ * When the device is built with SYNTHETIC_MOTION=1, PIR interrupts can be generated from
+ * an occupancy model instead of the sensor. Occupancy periods start with exponentially
+ * distributed inter-arrival times (Poisson arrivals), last for an exponentially distributed
+ * dwell time, and produce motion interrupts with exponentially distributed intervals during
+ * the occupancy. The interrupts are posted to the event queue exactly as the PIR interrupt
+ * handler does. Motion during the blind time after an interrupt does not interrupt, as with
+ * the PIR sensor, the application sets the blind time of the sensor configuration. The same model and seed always produce the same sequence of intervals, so
+ * that cadence and presence timing runs can be repeated.
+ */
+#ifndef SENSOR_MOTION_WORKLOAD_H__
+#define SENSOR_MOTION_WORKLOAD_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Occupancy models
+#define SENSOR_WORKLOAD_MODEL_OFFICE            0   // long seated periods with little motion
+#define SENSOR_WORKLOAD_MODEL_CORRIDOR          1   // frequent short walk-throughs
+#define SENSOR_WORKLOAD_MODEL_MEETING_ROOM      2   // scheduled meetings with a lot of motion
+#define SENSOR_WORKLOAD_MODEL_CLEANING          3   // rare after-hours cleaning rounds
+#define SENSOR_WORKLOAD_MODEL_MAX               4
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t mean_arrival;          // mean time between the occupancy periods in ms
+    uint32_t mean_dwell;            // mean duration of the occupancy in ms
+    uint32_t mean_motion;           // mean time between the motion interrupts during the occupancy in ms
+} sensor_workload_model_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         sensor_workload_init(void);
+void         sensor_workload_set_blind_time(uint32_t blind_time);
+wiced_bool_t sensor_workload_start(uint8_t model, uint32_t seed);
+void         sensor_workload_stop(void);
+
+#endif // SENSOR_MOTION_WORKLOAD_H__
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Host microbenchmark of the Sensor Cadence evaluation.
+ *
+ * The cadence is evaluated every time the publication timer of the sensor expires, which can be
+ * every 100 ms with a fast cadence. The application evaluates it with the implementation specialized
+ * for the value type of the property (SENSOR_CADENCE_PUB_NEEDED). This tool runs the specialized
+ * boolean implementation of sensor_motion_cadence.c and a copy of the generic 32 bit implementation
+ * the application used before, with the same cadence configurations and the same stream of values,
+ * checks that both take the same decisions and reports the time per evaluation of each.
+ *
+ * Usage: cadence_bench [evaluations per configuration]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sensor_motion_cadence.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define CADENCE_BENCH_DEFAULT_EVALUATIONS   10000000
+#define CADENCE_BENCH_STREAM_LEN            4096        // power of 2, values are reused cyclically
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    const char                              *name;
+    wiced_bt_mesh_sensor_config_cadence_t   cadence;
+    uint32_t                                publish_period;
+    uint32_t                                fast_publish_period;
+} cadence_bench_config_t;
+
+typedef struct
+{
+    uint8_t                 current;
+    uint8_t                 published;
+    sensor_cadence_timing_t timing;
+} cadence_bench_input_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t cadence_bench_generic(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence, int32_t current_value,
+                                          int32_t pub_value, const sensor_cadence_timing_t *p_timing) __attribute__((noinline));
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static const cadence_bench_config_t cadence_bench_configs[] =
+{
+    // name               divisor, percentage, down, up, min interval, low, high      period, fast period
+    { "period only",      { 0,  WICED_FALSE, 0,    0,    1000,  0, 0 },               60000,  0 },
+    { "native triggers",  { 0,  WICED_FALSE, 1,    1,    1000,  0, 0 },               60000,  0 },
+    { "percent triggers", { 0,  WICED_TRUE,  5000, 5000, 1000,  0, 0 },               60000,  0 },
+    { "fast cadence",     { 16, WICED_FALSE, 1,    1,    1000,  0, 1 },               60000,  3750 },
+    { "no min interval",  { 16, WICED_TRUE,  100,  100,  0,     1, 1 },               60000,  3750 },
+};
+
+static cadence_bench_input_t cadence_bench_stream[CADENCE_BENCH_STREAM_LEN];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Generic evaluation on 32 bit signed values, as done by the application before the evaluation was
+ * specialized per value type. The only change is the guard of the percentage delta down when the
+ * current value is 0, which divided by zero in the original.
+ */
+wiced_bool_t cadence_bench_generic(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence, int32_t current_value,
+                                   int32_t pub_value, const sensor_cadence_timing_t *p_timing)
+{
+    wiced_bool_t pub_needed = WICED_FALSE;
+
+    if ((p_timing->min_interval != 0) && (p_timing->elapsed < p_timing->min_interval))
+        return WICED_FALSE;
+
+    if ((p_timing->publish_period != 0) && (p_timing->elapsed >= p_timing->publish_period))
+        pub_needed = WICED_TRUE;
+
+    if (!pub_needed && ((p_cadence->trigger_delta_up != 0) || (p_cadence->trigger_delta_down != 0)))
+    {
+        if (!p_cadence->trigger_type_percentage)
+        {
+            if (((p_cadence->trigger_delta_up != 0)   && (current_value >= (int32_t)(pub_value + p_cadence->trigger_delta_up)))
+             || ((p_cadence->trigger_delta_down != 0) && (current_value <= (int32_t)(pub_value - p_cadence->trigger_delta_down))))
+                pub_needed = WICED_TRUE;
+        }
+        else
+        {
+            if ((p_cadence->trigger_delta_up != 0) && (current_value > pub_value))
+            {
+                if (((uint32_t)(current_value - pub_value) * 10000 / current_value) > p_cadence->trigger_delta_up)
+                    pub_needed = WICED_TRUE;
+            }
+            else if ((p_cadence->trigger_delta_down != 0) && (current_value < pub_value))
+            {
+                if ((current_value == 0) ||
+                    (((uint32_t)(pub_value - current_value) * 10000 / current_value) > p_cadence->trigger_delta_down))
+                    pub_needed = WICED_TRUE;
+            }
+        }
+    }
+    if (!pub_needed && (p_timing->fast_publish_period != 0) && (p_timing->elapsed >= p_timing->fast_publish_period))
+    {
+        if (p_cadence->fast_cadence_high > p_cadence->fast_cadence_low)
+        {
+            if ((current_value > p_cadence->fast_cadence_low) && (current_value <= p_cadence->fast_cadence_high))
+                pub_needed = WICED_TRUE;
+        }
+        else if (p_cadence->fast_cadence_high < p_cadence->fast_cadence_low)
+        {
+            if ((current_value >= p_cadence->fast_cadence_low) || (current_value < p_cadence->fast_cadence_high))
+                pub_needed = WICED_TRUE;
+        }
+        else if (current_value == p_cadence->fast_cadence_low)
+        {
+            pub_needed = WICED_TRUE;
+        }
+    }
+    return pub_needed;
+}
+
+/*
+ * Presence values and times since the last publication, evaluated at the timer expirations
+ */
+static void cadence_bench_stream_init(const cadence_bench_config_t *p_config)
+{
+    uint32_t random = 2463534242u;
+    uint32_t i;
+
+    for (i = 0; i < CADENCE_BENCH_STREAM_LEN; i++)
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+
+        cadence_bench_stream[i].current                    = random & 1;
+        cadence_bench_stream[i].published                  = (random >> 1) & 1;
+        cadence_bench_stream[i].timing.elapsed             = (random >> 8) % (2 * p_config->publish_period);
+        cadence_bench_stream[i].timing.publish_period      = p_config->publish_period;
+        cadence_bench_stream[i].timing.fast_publish_period = p_config->fast_publish_period;
+        cadence_bench_stream[i].timing.min_interval        = p_config->cadence.min_interval;
+    }
+}
+
+static double cadence_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t evaluations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : CADENCE_BENCH_DEFAULT_EVALUATIONS;
+    uint32_t mismatches = 0;
+    size_t   c;
+    uint32_t i;
+
+    printf("%-18s %12s %12s %12s %8s\n", "configuration", "generic ns", "boolean ns", "publishes", "speedup");
+
+    for (c = 0; c < sizeof(cadence_bench_configs) / sizeof(cadence_bench_configs[0]); c++)
+    {
+        const cadence_bench_config_t          *p_config  = &cadence_bench_configs[c];
+        const wiced_bt_mesh_sensor_config_cadence_t *p_cadence = &p_config->cadence;
+        volatile uint32_t generic_publishes = 0;
+        volatile uint32_t boolean_publishes = 0;
+        double            start, generic_ns, boolean_ns;
+
+        cadence_bench_stream_init(p_config);
+
+        for (i = 0; i < CADENCE_BENCH_STREAM_LEN; i++)
+        {
+            cadence_bench_input_t *p_in = &cadence_bench_stream[i];
+
+            if (cadence_bench_generic(p_cadence, p_in->current, p_in->published, &p_in->timing) !=
+                SENSOR_CADENCE_PUB_NEEDED(boolean, p_cadence, p_in->current, p_in->published, &p_in->timing))
+                mismatches++;
+        }
+
+        start = cadence_bench_now_ns();
+        for (i = 0; i < evaluations; i++)
+        {
+            cadence_bench_input_t *p_in = &cadence_bench_stream[i & (CADENCE_BENCH_STREAM_LEN - 1)];
+
+            generic_publishes += cadence_bench_generic(p_cadence, p_in->current, p_in->published, &p_in->timing);
+        }
+        generic_ns = (cadence_bench_now_ns() - start) / evaluations;
+
+        start = cadence_bench_now_ns();
+        for (i = 0; i < evaluations; i++)
+        {
+            cadence_bench_input_t *p_in = &cadence_bench_stream[i & (CADENCE_BENCH_STREAM_LEN - 1)];
+
+            boolean_publishes += SENSOR_CADENCE_PUB_NEEDED(boolean, p_cadence, p_in->current, p_in->published, &p_in->timing);
+        }
+        boolean_ns = (cadence_bench_now_ns() - start) / evaluations;
+
+        printf("%-18s %12.2f %12.2f %12u %7.2fx\n", p_config->name, generic_ns, boolean_ns,
+               (unsigned)boolean_publishes, generic_ns / boolean_ns);
+        if (generic_publishes != boolean_publishes)
+            mismatches++;
+    }
+    if (mismatches != 0)
+    {
+        printf("FAIL: %u decisions of the specialized implementation differ from the generic one\n", (unsigned)mismatches);
+        return 1;
+    }
+    return 0;
+}
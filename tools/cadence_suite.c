@@ -0,0 +1,305 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Cadence regression suite.
+ *
+ * Runs the presence detection and publication path of the application (tools/host/sensor_sim.c)
+ * over a grid of cadence configurations, each with a day of motion generated by every occupancy
+ * model of sensor_motion_workload.c. For each configuration and workload the suite counts the
+ * cadence evaluations, the publications and the cadence timer restarts, the same statistics the
+ * device reports with the HCI cadence statistics command, and measures how many evaluations per
+ * second the host runs. The counts are saved to a baseline file, a later run compared with the
+ * baseline flags every count which exceeds the baseline by more than 25% and fails.
+ *
+ * Usage: cadence_suite [-d hours] [-s seed] [-w baseline file] [-b baseline file] [-v]
+ *   -d  simulated time of each run in hours, 24 by default
+ *   -s  seed of the workloads
+ *   -w  write the counts to the baseline file
+ *   -b  compare the counts with the baseline file
+ *   -v  print the counts of every configuration
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sensor_motion_workload.h"
+#include "sensor_motion_profile.h"
+#include "host_sim.h"
+#include "host_trace.h"
+#include "sensor_sim.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define CADENCE_SUITE_MS_PER_HOUR               3600000
+#define CADENCE_SUITE_DEFAULT_HOURS             24
+#define CADENCE_SUITE_DEFAULT_SEED              0x2545F491
+#define CADENCE_SUITE_BLIND_TIME                (SENSOR_PROFILE_BLIND_TIME * 1000)
+
+// Same margin as MESH_SENSOR_STATS_REGRESSION_MARGIN_PERCENT of the device
+#define CADENCE_SUITE_REGRESSION_MARGIN_PERCENT 25
+
+#define CADENCE_SUITE_NUM_PERIODS               3
+#define CADENCE_SUITE_NUM_DIVISORS              2
+#define CADENCE_SUITE_NUM_MIN_INTERVALS         3
+#define CADENCE_SUITE_NUM_TRIGGERS              2
+#define CADENCE_SUITE_NUM_ZONES                 2
+#define CADENCE_SUITE_NUM_CONFIGS               (CADENCE_SUITE_NUM_PERIODS * CADENCE_SUITE_NUM_DIVISORS * CADENCE_SUITE_NUM_MIN_INTERVALS * \
+                                                 CADENCE_SUITE_NUM_TRIGGERS * CADENCE_SUITE_NUM_ZONES)
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t evaluations;
+    uint32_t publishes;
+    uint32_t timer_rearms;
+} cadence_suite_counts_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static const uint32_t cadence_suite_periods[CADENCE_SUITE_NUM_PERIODS]             = { 0, 10000, 60000 };
+static const uint16_t cadence_suite_divisors[CADENCE_SUITE_NUM_DIVISORS]           = { 1, 4 };
+static const uint32_t cadence_suite_min_intervals[CADENCE_SUITE_NUM_MIN_INTERVALS] = { 0, 1 << 10, 1 << 13 };
+static const uint32_t cadence_suite_triggers[CADENCE_SUITE_NUM_TRIGGERS]           = { 0, 1 };
+
+static cadence_suite_counts_t cadence_suite_counts[CADENCE_SUITE_NUM_CONFIGS][SENSOR_WORKLOAD_MODEL_MAX];
+static cadence_suite_counts_t cadence_suite_baseline[CADENCE_SUITE_NUM_CONFIGS][SENSOR_WORKLOAD_MODEL_MAX];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Configuration of the grid index. The fast cadence range is the occupied value, so that a
+ * divisor makes the sensor report presence more often than vacancy.
+ */
+static void cadence_suite_config(uint32_t index, sensor_sim_config_t *p_config)
+{
+    memset(p_config, 0, sizeof(*p_config));
+
+    p_config->zone                                = (index % CADENCE_SUITE_NUM_ZONES) != 0;
+    index /= CADENCE_SUITE_NUM_ZONES;
+    p_config->cadence.trigger_delta_up            = cadence_suite_triggers[index % CADENCE_SUITE_NUM_TRIGGERS];
+    p_config->cadence.trigger_delta_down          = cadence_suite_triggers[index % CADENCE_SUITE_NUM_TRIGGERS];
+    index /= CADENCE_SUITE_NUM_TRIGGERS;
+    p_config->cadence.min_interval                = cadence_suite_min_intervals[index % CADENCE_SUITE_NUM_MIN_INTERVALS];
+    index /= CADENCE_SUITE_NUM_MIN_INTERVALS;
+    p_config->cadence.fast_cadence_period_divisor = cadence_suite_divisors[index % CADENCE_SUITE_NUM_DIVISORS];
+    index /= CADENCE_SUITE_NUM_DIVISORS;
+    p_config->publish_period                      = cadence_suite_periods[index];
+
+    p_config->cadence.fast_cadence_low  = 1;
+    p_config->cadence.fast_cadence_high = 1;
+    p_config->blind_time                = CADENCE_SUITE_BLIND_TIME;
+}
+
+static wiced_bool_t cadence_suite_read_baseline(const char *p_file_name)
+{
+    FILE         *p_file = fopen(p_file_name, "r");
+    char         line[128];
+    char         model[32];
+    unsigned     config, evaluations, publishes, rearms;
+    uint8_t      m;
+
+    if (p_file == NULL)
+        return WICED_FALSE;
+
+    memset(cadence_suite_baseline, 0, sizeof(cadence_suite_baseline));
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        if ((line[0] == '#') || (sscanf(line, "%u %31s %u %u %u", &config, model, &evaluations, &publishes, &rearms) != 5))
+            continue;
+        for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+        {
+            if ((config < CADENCE_SUITE_NUM_CONFIGS) && (strcmp(model, host_trace_model_name(m)) == 0))
+            {
+                cadence_suite_baseline[config][m].evaluations  = evaluations;
+                cadence_suite_baseline[config][m].publishes    = publishes;
+                cadence_suite_baseline[config][m].timer_rearms = rearms;
+            }
+        }
+    }
+    fclose(p_file);
+    return WICED_TRUE;
+}
+
+static wiced_bool_t cadence_suite_write_baseline(const char *p_file_name, uint32_t hours, uint32_t seed)
+{
+    FILE     *p_file = fopen(p_file_name, "w");
+    uint32_t c;
+    uint8_t  m;
+
+    if (p_file == NULL)
+        return WICED_FALSE;
+
+    fprintf(p_file, "# cadence_suite -d %u -s %u\n", (unsigned)hours, (unsigned)seed);
+    fprintf(p_file, "# config workload evaluations publishes timer_rearms\n");
+    for (c = 0; c < CADENCE_SUITE_NUM_CONFIGS; c++)
+        for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+            fprintf(p_file, "%u %s %u %u %u\n", (unsigned)c, host_trace_model_name(m), (unsigned)cadence_suite_counts[c][m].evaluations,
+                    (unsigned)cadence_suite_counts[c][m].publishes, (unsigned)cadence_suite_counts[c][m].timer_rearms);
+    fclose(p_file);
+    return WICED_TRUE;
+}
+
+static wiced_bool_t cadence_suite_exceeds(uint32_t count, uint32_t baseline)
+{
+    return (uint64_t)count * 100 > (uint64_t)baseline * (100 + CADENCE_SUITE_REGRESSION_MARGIN_PERCENT);
+}
+
+static double cadence_suite_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    const char          *p_baseline = NULL;
+    const char          *p_write = NULL;
+    uint32_t            hours = CADENCE_SUITE_DEFAULT_HOURS;
+    uint32_t            seed = CADENCE_SUITE_DEFAULT_SEED;
+    wiced_bool_t        verbose = WICED_FALSE;
+    host_trace_t        traces[SENSOR_WORKLOAD_MODEL_MAX];
+    sensor_sim_config_t config;
+    sensor_sim_stats_t  stats;
+    uint64_t            total_evaluations = 0;
+    uint32_t            regressions = 0;
+    double              run_time = 0, start;
+    uint32_t            c;
+    uint8_t             m;
+    int                 opt;
+
+    while ((opt = getopt(argc, argv, "d:s:w:b:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd': hours = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w': p_write = optarg; break;
+        case 'b': p_baseline = optarg; break;
+        case 'v': verbose = WICED_TRUE; break;
+        default:
+            fprintf(stderr, "usage: %s [-d hours] [-s seed] [-w baseline] [-b baseline] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((hours == 0) || (hours > 1000))
+    {
+        fprintf(stderr, "hours shall be 1 to 1000\n");
+        return 2;
+    }
+    if ((p_baseline != NULL) && !cadence_suite_read_baseline(p_baseline))
+    {
+        fprintf(stderr, "cannot read %s\n", p_baseline);
+        return 2;
+    }
+
+    for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+    {
+        if (!host_trace_generate(&traces[m], m, seed, 0, hours * CADENCE_SUITE_MS_PER_HOUR))
+        {
+            fprintf(stderr, "cannot generate %s workload\n", host_trace_model_name(m));
+            return 2;
+        }
+    }
+
+    if (verbose)
+        printf("%6s %7s %4s %6s %4s %4s %-9s %11s %9s %9s %8s\n",
+               "config", "period", "div", "min", "trig", "zone", "workload", "evaluations", "publishes", "rearms", "p95 ms");
+
+    for (c = 0; c < CADENCE_SUITE_NUM_CONFIGS; c++)
+    {
+        cadence_suite_config(c, &config);
+        for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+        {
+            host_sim_reset();
+            start = cadence_suite_now();
+            sensor_sim_start(&config);
+            sensor_sim_run_trace(traces[m].p_edges, traces[m].num_edges, traces[m].duration);
+            run_time += cadence_suite_now() - start;
+            sensor_sim_get_stats(&stats);
+
+            cadence_suite_counts[c][m].evaluations  = stats.evaluations;
+            cadence_suite_counts[c][m].publishes    = stats.publishes;
+            cadence_suite_counts[c][m].timer_rearms = stats.timer_rearms;
+            total_evaluations += stats.evaluations;
+
+            if (verbose)
+                printf("%6u %7u %4u %6u %4u %4u %-9s %11u %9u %9u %8u\n", (unsigned)c, (unsigned)config.publish_period,
+                       (unsigned)config.cadence.fast_cadence_period_divisor, (unsigned)config.cadence.min_interval,
+                       (unsigned)config.cadence.trigger_delta_up, (unsigned)config.zone, host_trace_model_name(m),
+                       (unsigned)stats.evaluations, (unsigned)stats.publishes, (unsigned)stats.timer_rearms,
+                       (unsigned)sensor_latency_percentile(&stats.latency, 95));
+
+            if (p_baseline == NULL)
+                continue;
+            if (cadence_suite_exceeds(stats.evaluations, cadence_suite_baseline[c][m].evaluations) ||
+                cadence_suite_exceeds(stats.publishes, cadence_suite_baseline[c][m].publishes) ||
+                cadence_suite_exceeds(stats.timer_rearms, cadence_suite_baseline[c][m].timer_rearms))
+            {
+                printf("REGRESSION config %u %s: evaluations %u/%u publishes %u/%u rearms %u/%u\n", (unsigned)c, host_trace_model_name(m),
+                       (unsigned)stats.evaluations, (unsigned)cadence_suite_baseline[c][m].evaluations,
+                       (unsigned)stats.publishes, (unsigned)cadence_suite_baseline[c][m].publishes,
+                       (unsigned)stats.timer_rearms, (unsigned)cadence_suite_baseline[c][m].timer_rearms);
+                regressions++;
+            }
+        }
+    }
+
+    printf("%u configurations x %u workloads, %u hours each: %llu evaluations, %.0f evaluations/s\n",
+           (unsigned)CADENCE_SUITE_NUM_CONFIGS, (unsigned)SENSOR_WORKLOAD_MODEL_MAX, (unsigned)hours,
+           (unsigned long long)total_evaluations, (run_time > 0) ? total_evaluations / run_time : 0.0);
+
+    for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+        host_trace_free(&traces[m]);
+
+    if ((p_write != NULL) && !cadence_suite_write_baseline(p_write, hours, seed))
+    {
+        fprintf(stderr, "cannot write %s\n", p_write);
+        return 2;
+    }
+    if (regressions != 0)
+    {
+        printf("FAIL: %u regressions against %s\n", (unsigned)regressions, p_baseline);
+        return 1;
+    }
+    return 0;
+}
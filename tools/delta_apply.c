@@ -0,0 +1,218 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Delta OTA image round trip check.
+ *
+ * Applies a delta written by ota_delta.py to the old image with the patch applier of the
+ * application, sensor_motion_delta.c, and compares the rebuilt image with the new image bit for
+ * bit. The delta is passed to the applier in chunks of several sizes, from single bytes to the
+ * whole delta at once, as it would arrive from the transport. The applier then has to reject a
+ * delta with a wrong CRC-32, a truncated delta, a new image larger than the upgrade
+ * partition, a copy outside of the old image, a bad magic and a failed flash write. The tool fails
+ * if an image is not rebuilt bit for bit or if a bad delta is accepted.
+ *
+ * Usage: delta_apply old.bin delta new.bin
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sensor_motion_delta.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Chunk sizes of the delta passed to the applier, 0 passes the whole delta at once
+static const uint32_t delta_apply_chunks[] = { 1, 7, 20, 255, 1000, 0 };
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint8_t  *p_data;
+    uint32_t len;
+} delta_apply_file_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static int          delta_apply_load(const char *p_name, delta_apply_file_t *p_file);
+static uint8_t      delta_apply_run(const uint8_t *p_delta, uint32_t delta_len, uint32_t chunk, uint32_t old_len, uint32_t max_len);
+static int          delta_apply_expect(const char *p_name, uint8_t status, uint8_t expected);
+static wiced_bool_t delta_apply_read_old(uint32_t offset, uint8_t *p_data, uint32_t len);
+static wiced_bool_t delta_apply_write_new(uint32_t offset, uint8_t *p_data, uint32_t len);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static delta_apply_file_t delta_apply_old;
+static uint8_t            *delta_apply_image;        // upgrade partition
+static uint32_t           delta_apply_image_size;
+static uint32_t           delta_apply_writes;
+static uint32_t           delta_apply_write_offset;  // next offset expected, writes are sequential
+static uint32_t           delta_apply_fail_write;    // write which fails, 0 for none
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+int main(int argc, char *argv[])
+{
+    delta_apply_file_t delta, new_image;
+    uint8_t *p_bad;
+    uint8_t status;
+    unsigned i;
+    int failures = 0;
+
+    if (argc != 4)
+    {
+        fprintf(stderr, "usage: delta_apply old.bin delta new.bin\n");
+        return 2;
+    }
+    if (delta_apply_load(argv[1], &delta_apply_old) || delta_apply_load(argv[2], &delta) || delta_apply_load(argv[3], &new_image))
+        return 2;
+
+    delta_apply_image_size = new_image.len + SENSOR_DELTA_BUFFER_SIZE;
+    delta_apply_image      = malloc(delta_apply_image_size);
+    p_bad                  = malloc(delta.len);
+
+    printf("old image    %8u bytes\n", delta_apply_old.len);
+    printf("new image    %8u bytes\n", new_image.len);
+    printf("delta        %8u bytes, applier RAM %u bytes\n", delta.len, (unsigned)sizeof(sensor_delta_t));
+
+    for (i = 0; i < sizeof(delta_apply_chunks) / sizeof(delta_apply_chunks[0]); i++)
+    {
+        memset(delta_apply_image, 0xFF, delta_apply_image_size);
+        status = delta_apply_run(delta.p_data, delta.len, delta_apply_chunks[i], delta_apply_old.len, new_image.len);
+        if ((status != SENSOR_DELTA_STATUS_OK) || (delta_apply_write_offset != new_image.len) ||
+            (memcmp(delta_apply_image, new_image.p_data, new_image.len) != 0))
+        {
+            printf("FAIL: chunks of %u bytes, status %u, %u bytes written\n", delta_apply_chunks[i], status, delta_apply_write_offset);
+            failures++;
+            continue;
+        }
+        printf("chunk %5u  new image rebuilt bit for bit, %u writes\n", delta_apply_chunks[i], delta_apply_writes);
+    }
+
+    // the image is rebuilt but does not match the CRC-32 of the header
+    memcpy(p_bad, delta.p_data, delta.len);
+    p_bad[8] ^= 0x01;
+    failures += delta_apply_expect("CRC mismatch", delta_apply_run(p_bad, delta.len, 64, delta_apply_old.len, new_image.len), SENSOR_DELTA_STATUS_CRC);
+    failures += delta_apply_expect("truncated delta", delta_apply_run(delta.p_data, delta.len - 1, 64, delta_apply_old.len, new_image.len), SENSOR_DELTA_STATUS_INCOMPLETE);
+    failures += delta_apply_expect("partition too small", delta_apply_run(delta.p_data, delta.len, 64, delta_apply_old.len, new_image.len - 1), SENSOR_DELTA_STATUS_SIZE);
+    failures += delta_apply_expect("old image too short", delta_apply_run(delta.p_data, delta.len, 64, delta_apply_old.len / 2, new_image.len), SENSOR_DELTA_STATUS_RANGE);
+    memcpy(p_bad, delta.p_data, delta.len);
+    p_bad[0] ^= 0x01;
+    failures += delta_apply_expect("bad magic", delta_apply_run(p_bad, delta.len, 64, delta_apply_old.len, new_image.len), SENSOR_DELTA_STATUS_FORMAT);
+    delta_apply_fail_write = 3;
+    failures += delta_apply_expect("write failure", delta_apply_run(delta.p_data, delta.len, 64, delta_apply_old.len, new_image.len), SENSOR_DELTA_STATUS_FLASH);
+    delta_apply_fail_write = 0;
+
+    free(p_bad);
+    free(delta_apply_image);
+    return (failures != 0) ? 1 : 0;
+}
+
+int delta_apply_load(const char *p_name, delta_apply_file_t *p_file)
+{
+    FILE *f = fopen(p_name, "rb");
+    long len;
+
+    if (f == NULL)
+    {
+        perror(p_name);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    p_file->p_data = malloc((len != 0) ? len : 1);
+    p_file->len    = (uint32_t)fread(p_file->p_data, 1, len, f);
+    fclose(f);
+    return 0;
+}
+
+/*
+ * Apply the delta in chunks of the size and return the status at the end
+ */
+uint8_t delta_apply_run(const uint8_t *p_delta, uint32_t delta_len, uint32_t chunk, uint32_t old_len, uint32_t max_len)
+{
+    static sensor_delta_t delta;
+    uint32_t offset, n;
+    uint8_t status = SENSOR_DELTA_STATUS_OK;
+
+    delta_apply_writes       = 0;
+    delta_apply_write_offset = 0;
+    sensor_delta_init(&delta, delta_apply_read_old, delta_apply_write_new, old_len, max_len);
+    for (offset = 0; (offset < delta_len) && (status == SENSOR_DELTA_STATUS_OK); offset += n)
+    {
+        n = ((chunk == 0) || (chunk > delta_len - offset)) ? delta_len - offset : chunk;
+        status = sensor_delta_process(&delta, &p_delta[offset], n);
+    }
+    return sensor_delta_finish(&delta);
+}
+
+int delta_apply_expect(const char *p_name, uint8_t status, uint8_t expected)
+{
+    if (status != expected)
+    {
+        printf("FAIL: %s accepted with status %u, expected %u\n", p_name, status, expected);
+        return 1;
+    }
+    printf("%-20s rejected, status %u\n", p_name, status);
+    return 0;
+}
+
+wiced_bool_t delta_apply_read_old(uint32_t offset, uint8_t *p_data, uint32_t len)
+{
+    if ((offset > delta_apply_old.len) || (len > delta_apply_old.len - offset))
+        return WICED_FALSE;
+    memcpy(p_data, &delta_apply_old.p_data[offset], len);
+    return WICED_TRUE;
+}
+
+wiced_bool_t delta_apply_write_new(uint32_t offset, uint8_t *p_data, uint32_t len)
+{
+    delta_apply_writes++;
+    if ((delta_apply_fail_write != 0) && (delta_apply_writes == delta_apply_fail_write))
+        return WICED_FALSE;
+    if ((offset != delta_apply_write_offset) || (len > SENSOR_DELTA_BUFFER_SIZE) || (len > delta_apply_image_size - offset))
+    {
+        printf("FAIL: write of %u bytes at %u, expected at %u\n", len, offset, delta_apply_write_offset);
+        return WICED_FALSE;
+    }
+    memcpy(&delta_apply_image[offset], p_data, len);
+    delta_apply_write_offset += len;
+    return WICED_TRUE;
+}
@@ -0,0 +1,571 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Mesh firmware distribution simulation.
+ *
+ * Estimates the time a distributor takes to send a firmware image to a group of sensors with the
+ * BLOB Transfer procedure, to the group address at once (multicast) or to one sensor after the
+ * other, for several image sizes and numbers of sensors. The image is sent in blocks of chunks,
+ * every chunk is a segmented message. Segments to the group are repeated and not acknowledged,
+ * after each block every sensor reports the chunks it missed and the missing chunks are sent to
+ * the group again. Segments to a single sensor are acknowledged and the lost ones are sent again.
+ * Every request is answered by every sensor it is addressed to, a request without a response is
+ * sent again to that sensor.
+ *
+ * The sensors keep publishing during the transfer. The publications of every sensor are taken
+ * from the host model of the application (tools/host/sensor_sim.c) run over an hour of an
+ * occupancy model, with a different seed for each sensor, and repeat every hour. The sensor
+ * model behaves as during a transfer, with the min interval extended to 2 seconds, or with -u as
+ * without a transfer, to show the effect of the throttling. The sensors publish every 10 seconds,
+ * with a fast cadence while the area is occupied, and send presence changes to a zone group. A PDU
+ * on air at the time a sensor publishes is lost for all receivers, in addition every PDU is lost for each receiver with the
+ * given probability. All sensors are in range of the distributor, relaying is not modelled. The
+ * timing constants are estimates of the advertising bearer, not measurements.
+ *
+ * The tool fails if a transfer does not complete, or if the multicast transfer to more than one
+ * sensor does not take less time than sending the image to each sensor in turn.
+ *
+ * Usage: dfu_sim [-i image KB] [-n sensors] [-l loss percent] [-m model] [-p profile] [-s seed] [-u]
+ *   -i  image size, the sizes of the table by default
+ *   -n  number of sensors, the numbers of the table by default
+ *   -m  office, corridor, meeting or cleaning, office by default
+ *   -p  profile of the sensors, 0 low latency (default), 1 balanced, 2 max battery
+ *   -u  the sensors do not throttle the publications during the transfer
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sensor_motion_workload.h"
+#include "sensor_motion_profile.h"
+#include "host_sim.h"
+#include "host_trace.h"
+#include "sensor_sim.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define DFU_SIM_DEFAULT_SEED            0x2545F491
+#define DFU_SIM_DEFAULT_LOSS            2           // percent of the PDUs lost for a receiver
+#define DFU_SIM_MAX_NODES               1000
+#define DFU_SIM_MAX_IMAGE_SIZE          1024        // KB
+#define DFU_SIM_TRAFFIC_WINDOW          3600000     // ms of sensor traffic simulated, repeated during longer transfers
+
+// BLOB Transfer parameters of the distributor
+#define DFU_SIM_BLOCK_SIZE              4096        // block size log 12
+#define DFU_SIM_CHUNK_SIZE              256
+#define DFU_SIM_CHUNKS_PER_BLOCK        (DFU_SIM_BLOCK_SIZE / DFU_SIM_CHUNK_SIZE)
+// BLOB Chunk Transfer access PDU is opcode, chunk number and data, the upper transport adds a 4 byte MIC
+// and the lower transport carries 12 bytes in every segment
+#define DFU_SIM_CHUNK_SEGMENTS          ((1 + 2 + DFU_SIM_CHUNK_SIZE + 4 + 11) / 12)
+// Firmware Update Start, BLOB Transfer Start, Firmware Update Get and Firmware Update Apply
+#define DFU_SIM_TRANSFER_REQUESTS       4
+
+// Timing of the advertising bearer, estimates
+#define DFU_SIM_PDU_TIME                20          // ms between two PDUs of the distributor
+#define DFU_SIM_COLLISION_TIME          5           // ms of an advertising event, PDUs closer than that collide
+#define DFU_SIM_GROUP_REPEATS           3           // transmissions of each segment to a group address
+#define DFU_SIM_RESPONSE_DELAY          200         // ms until the responses to a request are sent
+#define DFU_SIM_ACK_DELAY               150         // ms until the segment acknowledgment is sent
+#define DFU_SIM_BLOCK_WRITE_TIME        100         // ms a sensor takes to write a block to the flash
+#define DFU_SIM_MAX_ATTEMPTS            100         // attempts of a request, or rounds of a block, before the transfer fails
+
+#define DFU_SIM_NUM_SIZES               3
+#define DFU_SIM_NUM_NODE_COUNTS         4
+
+// Cadence of the sensors: fast cadence while occupied, presence changes are sent to a zone group as well
+#define DFU_SIM_PUBLISH_PERIOD          10000
+#define DFU_SIM_FAST_CADENCE_DIVISOR    16
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// Publications of all sensors in the traffic window, sorted
+typedef struct
+{
+    uint32_t *p_times;
+    uint32_t num_times;
+    uint32_t max_times;
+    uint32_t start;                 // time of the start of the run of the current sensor
+    uint32_t phase;                 // offset of the publications of the current sensor in the window
+} dfu_sim_traffic_t;
+
+typedef struct
+{
+    uint32_t publishes;             // publications per sensor per hour
+    uint32_t latency;               // 95th percentile of the motion to publication latency in ms
+} dfu_sim_traffic_stats_t;
+
+typedef struct
+{
+    uint64_t     time;              // ms since the start of the transfer
+    uint32_t     pdus;              // PDUs sent by the distributor and the sensors
+    uint32_t     collisions;        // PDUs on air at the time of a publication
+    wiced_bool_t failed;            // a request or a block exceeded the attempts
+    uint32_t     num_nodes;
+    uint32_t     loss;              // probability of a PDU loss for a receiver, in 1/65536
+    uint32_t     random;
+} dfu_sim_transfer_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static const uint32_t dfu_sim_sizes[DFU_SIM_NUM_SIZES]             = { 64, 128, 256 };
+static const uint32_t dfu_sim_node_counts[DFU_SIM_NUM_NODE_COUNTS] = { 1, 10, 50, 100 };
+
+static dfu_sim_traffic_t dfu_sim_traffic;
+
+// chunks of the current block each sensor is missing, one bit per chunk
+static uint32_t dfu_sim_missing[DFU_SIM_MAX_NODES];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+static int dfu_sim_model(const char *p_name)
+{
+    uint8_t m;
+
+    for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+        if (strcmp(p_name, host_trace_model_name(m)) == 0)
+            return m;
+    return -1;
+}
+
+static int dfu_sim_compare_times(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a, b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+static void dfu_sim_publish_cback(uint32_t time)
+{
+    uint32_t *p_times;
+
+    if (dfu_sim_traffic.num_times == dfu_sim_traffic.max_times)
+    {
+        dfu_sim_traffic.max_times = dfu_sim_traffic.max_times ? 2 * dfu_sim_traffic.max_times : 1024;
+        p_times = realloc(dfu_sim_traffic.p_times, dfu_sim_traffic.max_times * sizeof(uint32_t));
+        if (p_times == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+        dfu_sim_traffic.p_times = p_times;
+    }
+    dfu_sim_traffic.p_times[dfu_sim_traffic.num_times++] = (time - dfu_sim_traffic.start + dfu_sim_traffic.phase) % DFU_SIM_TRAFFIC_WINDOW;
+}
+
+/*
+ * Run the host model of the application for every sensor over the traffic window and collect the
+ * publications. Each sensor gets its own seed, so that the sensors see different motion, and its
+ * own phase, as the sensors are not provisioned at the same time and their periodic publications
+ * are not aligned.
+ */
+static wiced_bool_t dfu_sim_generate_traffic(uint32_t num_nodes, uint8_t model, uint8_t profile, uint32_t seed, wiced_bool_t throttle,
+                                             dfu_sim_traffic_stats_t *p_stats)
+{
+    sensor_sim_config_t config;
+    sensor_sim_stats_t  stats;
+    sensor_latency_t    latency;
+    host_trace_t        trace;
+    uint32_t            n;
+    uint8_t             b;
+
+    memset(&config, 0, sizeof(config));
+    config.cadence.fast_cadence_period_divisor = DFU_SIM_FAST_CADENCE_DIVISOR;
+    config.cadence.fast_cadence_low            = 1;
+    config.cadence.fast_cadence_high           = 1;
+    config.cadence.trigger_delta_up            = 1;
+    config.cadence.trigger_delta_down          = 1;
+    config.publish_period                      = DFU_SIM_PUBLISH_PERIOD;
+    config.zone                                = WICED_TRUE;
+    config.dfu_transfer                        = throttle;
+    config.p_publish_cback                     = dfu_sim_publish_cback;
+    sensor_sim_profile(&config, profile);
+
+    dfu_sim_traffic.num_times = 0;
+    sensor_latency_reset(&latency);
+
+    for (n = 0; n < num_nodes; n++)
+    {
+        if (!host_trace_generate(&trace, model, seed + n, 0, DFU_SIM_TRAFFIC_WINDOW))
+            return WICED_FALSE;
+
+        host_sim_reset();
+        dfu_sim_traffic.start = host_sim_now();
+        dfu_sim_traffic.phase = (uint32_t)((seed + n) * 2654435761u) % DFU_SIM_TRAFFIC_WINDOW;
+        sensor_sim_start(&config);
+        sensor_sim_run_trace(trace.p_edges, trace.num_edges, trace.duration);
+        sensor_sim_get_stats(&stats);
+        host_trace_free(&trace);
+
+        for (b = 0; b < SENSOR_LATENCY_BUCKETS; b++)
+            latency.buckets[b] += stats.latency.buckets[b];
+        latency.samples += stats.latency.samples;
+        if (stats.latency.max > latency.max)
+            latency.max = stats.latency.max;
+    }
+    qsort(dfu_sim_traffic.p_times, dfu_sim_traffic.num_times, sizeof(uint32_t), dfu_sim_compare_times);
+
+    p_stats->publishes = dfu_sim_traffic.num_times / num_nodes;
+    p_stats->latency   = sensor_latency_percentile(&latency, 95);
+    return WICED_TRUE;
+}
+
+static uint32_t dfu_sim_random(dfu_sim_transfer_t *p_transfer)
+{
+    p_transfer->random ^= p_transfer->random << 13;
+    p_transfer->random ^= p_transfer->random >> 17;
+    p_transfer->random ^= p_transfer->random << 5;
+    return p_transfer->random;
+}
+
+/*
+ * Receiver lost a PDU which was not lost to a collision
+ */
+static wiced_bool_t dfu_sim_lost(dfu_sim_transfer_t *p_transfer)
+{
+    return (dfu_sim_random(p_transfer) & 0xFFFF) < p_transfer->loss;
+}
+
+/*
+ * Send a PDU at the current time, returns WICED_FALSE if a sensor publishes while it is on air
+ */
+static wiced_bool_t dfu_sim_send_pdu(dfu_sim_transfer_t *p_transfer)
+{
+    uint32_t position = (uint32_t)(p_transfer->time % DFU_SIM_TRAFFIC_WINDOW);
+    uint32_t low = 0, high = dfu_sim_traffic.num_times, middle;
+    wiced_bool_t collision;
+
+    // first publication not before the start of the collision window
+    while (low < high)
+    {
+        middle = (low + high) / 2;
+        if (dfu_sim_traffic.p_times[middle] + DFU_SIM_COLLISION_TIME <= position)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    collision = (low < dfu_sim_traffic.num_times) && (dfu_sim_traffic.p_times[low] < position + DFU_SIM_COLLISION_TIME);
+
+    p_transfer->time += DFU_SIM_PDU_TIME;
+    p_transfer->pdus++;
+    if (collision)
+        p_transfer->collisions++;
+    return !collision;
+}
+
+/*
+ * Acknowledged request to one sensor, sent again until the response is received
+ */
+static void dfu_sim_request(dfu_sim_transfer_t *p_transfer)
+{
+    uint32_t attempt;
+
+    for (attempt = 0; attempt < DFU_SIM_MAX_ATTEMPTS; attempt++)
+    {
+        wiced_bool_t received = dfu_sim_send_pdu(p_transfer) && !dfu_sim_lost(p_transfer);
+
+        p_transfer->time += DFU_SIM_RESPONSE_DELAY;
+        if (received && dfu_sim_send_pdu(p_transfer) && !dfu_sim_lost(p_transfer))
+            return;
+    }
+    p_transfer->failed = WICED_TRUE;
+}
+
+/*
+ * Acknowledged request to the group, every sensor responds. Sensors which did not receive the
+ * request or whose response is lost get the request again, addressed to the sensor.
+ */
+static void dfu_sim_group_request(dfu_sim_transfer_t *p_transfer)
+{
+    static uint8_t received[DFU_SIM_MAX_NODES];
+    uint32_t       n;
+    uint8_t        r;
+
+    memset(received, 0, p_transfer->num_nodes);
+    for (r = 0; r < DFU_SIM_GROUP_REPEATS; r++)
+    {
+        wiced_bool_t on_air = dfu_sim_send_pdu(p_transfer);
+
+        for (n = 0; n < p_transfer->num_nodes; n++)
+            if (on_air && !dfu_sim_lost(p_transfer))
+                received[n] = 1;
+    }
+    p_transfer->time += DFU_SIM_RESPONSE_DELAY;
+    for (n = 0; n < p_transfer->num_nodes; n++)
+    {
+        if (!received[n] || !dfu_sim_send_pdu(p_transfer) || dfu_sim_lost(p_transfer))
+            dfu_sim_request(p_transfer);
+    }
+}
+
+/*
+ * Chunk to the group. A sensor receives the chunk if it receives every segment at least once.
+ */
+static void dfu_sim_group_chunk(dfu_sim_transfer_t *p_transfer, uint8_t chunk)
+{
+    static uint32_t segments[DFU_SIM_MAX_NODES];
+    uint32_t        all_segments = (1 << DFU_SIM_CHUNK_SEGMENTS) - 1;
+    uint32_t        n;
+    uint8_t         s, r;
+
+    memset(segments, 0, p_transfer->num_nodes * sizeof(uint32_t));
+    for (s = 0; s < DFU_SIM_CHUNK_SEGMENTS; s++)
+    {
+        for (r = 0; r < DFU_SIM_GROUP_REPEATS; r++)
+        {
+            if (!dfu_sim_send_pdu(p_transfer))
+                continue;
+            for (n = 0; n < p_transfer->num_nodes; n++)
+                if (!dfu_sim_lost(p_transfer))
+                    segments[n] |= 1 << s;
+        }
+    }
+    for (n = 0; n < p_transfer->num_nodes; n++)
+        if (segments[n] == all_segments)
+            dfu_sim_missing[n] &= ~(1 << chunk);
+}
+
+/*
+ * Chunk to one sensor. The sensor acknowledges the segments it received, the others are sent again.
+ */
+static void dfu_sim_chunk(dfu_sim_transfer_t *p_transfer)
+{
+    uint32_t all_segments = (1 << DFU_SIM_CHUNK_SEGMENTS) - 1;
+    uint32_t received = 0, acknowledged = 0;
+    uint32_t attempt;
+    uint8_t  s;
+
+    for (attempt = 0; attempt < DFU_SIM_MAX_ATTEMPTS; attempt++)
+    {
+        for (s = 0; s < DFU_SIM_CHUNK_SEGMENTS; s++)
+            if (!(acknowledged & (1 << s)) && dfu_sim_send_pdu(p_transfer) && !dfu_sim_lost(p_transfer))
+                received |= 1 << s;
+
+        p_transfer->time += DFU_SIM_ACK_DELAY;
+        if (dfu_sim_send_pdu(p_transfer) && !dfu_sim_lost(p_transfer))
+            acknowledged = received;
+        if (acknowledged == all_segments)
+            return;
+    }
+    p_transfer->failed = WICED_TRUE;
+}
+
+/*
+ * Multicast transfer: blocks are sent to the group, the chunks any sensor missed are sent again
+ * after each block.
+ */
+static void dfu_sim_multicast(dfu_sim_transfer_t *p_transfer, uint32_t image_size)
+{
+    uint32_t blocks = (image_size + DFU_SIM_BLOCK_SIZE - 1) / DFU_SIM_BLOCK_SIZE;
+    uint32_t block, chunks, missing, round, n;
+    uint8_t  c, r;
+
+    for (r = 0; r < DFU_SIM_TRANSFER_REQUESTS / 2; r++)
+        dfu_sim_group_request(p_transfer);
+
+    for (block = 0; (block < blocks) && !p_transfer->failed; block++)
+    {
+        chunks = (image_size - block * DFU_SIM_BLOCK_SIZE + DFU_SIM_CHUNK_SIZE - 1) / DFU_SIM_CHUNK_SIZE;
+        if (chunks > DFU_SIM_CHUNKS_PER_BLOCK)
+            chunks = DFU_SIM_CHUNKS_PER_BLOCK;
+        for (n = 0; n < p_transfer->num_nodes; n++)
+            dfu_sim_missing[n] = (1 << chunks) - 1;
+
+        // BLOB Block Start
+        dfu_sim_group_request(p_transfer);
+        missing = (1 << chunks) - 1;
+        for (round = 0; missing != 0; round++)
+        {
+            if (round == DFU_SIM_MAX_ATTEMPTS)
+            {
+                p_transfer->failed = WICED_TRUE;
+                return;
+            }
+            for (c = 0; c < chunks; c++)
+                if (missing & (1 << c))
+                    dfu_sim_group_chunk(p_transfer, c);
+
+            // BLOB Block Get, the sensors report the chunks they missed
+            dfu_sim_group_request(p_transfer);
+            missing = 0;
+            for (n = 0; n < p_transfer->num_nodes; n++)
+                missing |= dfu_sim_missing[n];
+        }
+        p_transfer->time += DFU_SIM_BLOCK_WRITE_TIME;
+    }
+
+    for (r = 0; r < DFU_SIM_TRANSFER_REQUESTS / 2; r++)
+        dfu_sim_group_request(p_transfer);
+}
+
+/*
+ * Image is sent to one sensor after the other
+ */
+static void dfu_sim_unicast(dfu_sim_transfer_t *p_transfer, uint32_t image_size)
+{
+    uint32_t blocks = (image_size + DFU_SIM_BLOCK_SIZE - 1) / DFU_SIM_BLOCK_SIZE;
+    uint32_t block, chunks, n;
+    uint8_t  c, r;
+
+    for (n = 0; (n < p_transfer->num_nodes) && !p_transfer->failed; n++)
+    {
+        for (r = 0; r < DFU_SIM_TRANSFER_REQUESTS / 2; r++)
+            dfu_sim_request(p_transfer);
+
+        for (block = 0; (block < blocks) && !p_transfer->failed; block++)
+        {
+            chunks = (image_size - block * DFU_SIM_BLOCK_SIZE + DFU_SIM_CHUNK_SIZE - 1) / DFU_SIM_CHUNK_SIZE;
+            if (chunks > DFU_SIM_CHUNKS_PER_BLOCK)
+                chunks = DFU_SIM_CHUNKS_PER_BLOCK;
+
+            // BLOB Block Start, the chunks are acknowledged, and BLOB Block Get
+            dfu_sim_request(p_transfer);
+            for (c = 0; c < chunks; c++)
+                dfu_sim_chunk(p_transfer);
+            dfu_sim_request(p_transfer);
+            p_transfer->time += DFU_SIM_BLOCK_WRITE_TIME;
+        }
+
+        for (r = 0; r < DFU_SIM_TRANSFER_REQUESTS / 2; r++)
+            dfu_sim_request(p_transfer);
+    }
+}
+
+static void dfu_sim_transfer(dfu_sim_transfer_t *p_transfer, wiced_bool_t multicast, uint32_t image_size, uint32_t num_nodes,
+                             uint32_t loss, uint32_t seed)
+{
+    memset(p_transfer, 0, sizeof(*p_transfer));
+    p_transfer->num_nodes = num_nodes;
+    p_transfer->loss      = loss * 65536 / 100;
+    p_transfer->random    = seed;
+
+    if (multicast)
+        dfu_sim_multicast(p_transfer, image_size);
+    else
+        dfu_sim_unicast(p_transfer, image_size);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t                sizes[DFU_SIM_NUM_SIZES], node_counts[DFU_SIM_NUM_NODE_COUNTS];
+    uint32_t                num_sizes = DFU_SIM_NUM_SIZES, num_node_counts = DFU_SIM_NUM_NODE_COUNTS;
+    uint32_t                loss = DFU_SIM_DEFAULT_LOSS;
+    uint32_t                seed = DFU_SIM_DEFAULT_SEED;
+    int                     model = SENSOR_WORKLOAD_MODEL_OFFICE;
+    uint32_t                profile = 0;
+    wiced_bool_t            throttle = WICED_TRUE;
+    dfu_sim_traffic_stats_t traffic;
+    dfu_sim_transfer_t      multicast, unicast;
+    uint32_t                i, j;
+    int                     result = 0;
+    int                     opt;
+
+    memcpy(sizes, dfu_sim_sizes, sizeof(sizes));
+    memcpy(node_counts, dfu_sim_node_counts, sizeof(node_counts));
+
+    while ((opt = getopt(argc, argv, "i:n:l:m:p:s:u")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i': sizes[0] = (uint32_t)strtoul(optarg, NULL, 0); num_sizes = 1; break;
+        case 'n': node_counts[0] = (uint32_t)strtoul(optarg, NULL, 0); num_node_counts = 1; break;
+        case 'l': loss = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'm': model = dfu_sim_model(optarg); break;
+        case 'p': profile = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'u': throttle = WICED_FALSE; break;
+        default:
+            fprintf(stderr, "usage: %s [-i image KB] [-n sensors] [-l loss percent] [-m model] [-p profile] [-s seed] [-u]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (model < 0)
+    {
+        fprintf(stderr, "model shall be office, corridor, meeting or cleaning\n");
+        return 2;
+    }
+    if (profile >= SENSOR_PROFILE_MAX)
+    {
+        fprintf(stderr, "profile shall be 0 to 2\n");
+        return 2;
+    }
+    if ((node_counts[0] == 0) || (node_counts[0] > DFU_SIM_MAX_NODES) || (sizes[0] == 0) || (sizes[0] > DFU_SIM_MAX_IMAGE_SIZE) ||
+        (loss >= 50))
+    {
+        fprintf(stderr, "sensors shall be 1 to %u, image size 1 to %u KB and loss below 50%%\n", DFU_SIM_MAX_NODES, DFU_SIM_MAX_IMAGE_SIZE);
+        return 2;
+    }
+
+    printf("%s workload, profile %u, publish period %u ms, fast cadence divisor %u and zone, publications %s during the transfer, loss %u%%\n",
+           host_trace_model_name((uint8_t)model), (unsigned)profile, DFU_SIM_PUBLISH_PERIOD, DFU_SIM_FAST_CADENCE_DIVISOR,
+           throttle ? "throttled" : "not throttled", (unsigned)loss);
+    printf("%6s %7s %9s %10s %11s %12s %11s %12s\n",
+           "image", "sensors", "pub/h", "p95 ms", "multicast s", "collisions", "one by one s", "collisions");
+
+    for (j = 0; j < num_node_counts; j++)
+    {
+        if (!dfu_sim_generate_traffic(node_counts[j], (uint8_t)model, (uint8_t)profile, seed, throttle, &traffic))
+        {
+            fprintf(stderr, "cannot generate the sensor traffic\n");
+            return 2;
+        }
+        for (i = 0; i < num_sizes; i++)
+        {
+            dfu_sim_transfer(&multicast, WICED_TRUE, sizes[i] * 1024, node_counts[j], loss, seed);
+            dfu_sim_transfer(&unicast, WICED_FALSE, sizes[i] * 1024, node_counts[j], loss, seed);
+
+            printf("%4uKB %7u %9u %10u %11.1f %11.1f%% %12.1f %11.1f%%\n", (unsigned)sizes[i], (unsigned)node_counts[j],
+                   (unsigned)traffic.publishes, (unsigned)traffic.latency,
+                   multicast.time / 1000.0, multicast.pdus ? 100.0 * multicast.collisions / multicast.pdus : 0.0,
+                   unicast.time / 1000.0, unicast.pdus ? 100.0 * unicast.collisions / unicast.pdus : 0.0);
+
+            if (multicast.failed || unicast.failed)
+            {
+                printf("FAIL: the transfer of %uKB to %u sensors did not complete\n", (unsigned)sizes[i], (unsigned)node_counts[j]);
+                result = 1;
+            }
+            else if ((node_counts[j] > 1) && (multicast.time >= unicast.time))
+            {
+                printf("FAIL: multicast to %u sensors is not faster than one by one\n", (unsigned)node_counts[j]);
+                result = 1;
+            }
+        }
+    }
+    free(dfu_sim_traffic.p_times);
+    return result;
+}
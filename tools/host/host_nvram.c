@@ -0,0 +1,228 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Volatile section NVRAM of the host tools with a flash latency and wear model.
+ */
+#include <string.h>
+#include "wiced_hal_nvram.h"
+#include "host_sim.h"
+#include "host_nvram.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint16_t vs_id;
+    uint16_t length;
+    uint8_t  data[HOST_NVRAM_MAX_RECORD_LEN];
+} host_nvram_record_t;
+
+typedef struct
+{
+    host_nvram_flash_t  flash;
+    host_nvram_stats_t  stats;
+    host_nvram_record_t records[HOST_NVRAM_MAX_RECORDS];
+    uint8_t             num_records;
+    uint8_t             sector;             // active sector
+    uint32_t            sector_used;        // bytes used in the active sector
+    uint32_t            stall_us;           // stall not yet applied to the clock, less than 1 ms
+} host_nvram_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static host_nvram_record_t *host_nvram_find(uint16_t vs_id);
+static wiced_bool_t         host_nvram_append(uint16_t length);
+static void                 host_nvram_stall(uint32_t duration_us);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static host_nvram_t host_nvram;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Erase the NVRAM and use the flash parameters
+ */
+wiced_bool_t host_nvram_init(const host_nvram_flash_t *p_flash)
+{
+    if ((p_flash->num_sectors < 2) || (p_flash->num_sectors > HOST_NVRAM_MAX_SECTORS) ||
+        (p_flash->sector_size < (uint32_t)p_flash->record_overhead + HOST_NVRAM_MAX_RECORD_LEN))
+        return WICED_FALSE;
+
+    memset(&host_nvram, 0, sizeof(host_nvram));
+    host_nvram.flash = *p_flash;
+    return WICED_TRUE;
+}
+
+void host_nvram_stats_reset(void)
+{
+    memset(&host_nvram.stats, 0, sizeof(host_nvram.stats));
+}
+
+void host_nvram_get_stats(host_nvram_stats_t *p_stats)
+{
+    *p_stats = host_nvram.stats;
+}
+
+/*
+ * Bytes which are copied when the active sector changes
+ */
+uint32_t host_nvram_live_bytes(void)
+{
+    uint32_t bytes = 0;
+    uint8_t  i;
+
+    for (i = 0; i < host_nvram.num_records; i++)
+        bytes += host_nvram.flash.record_overhead + host_nvram.records[i].length;
+    return bytes;
+}
+
+uint16_t wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    host_nvram_record_t *p_record = host_nvram_find(vs_id);
+
+    *p_status = WICED_BADARG;
+    if ((data_length == 0) || (data_length > HOST_NVRAM_MAX_RECORD_LEN))
+        return 0;
+    if ((p_record == NULL) && (host_nvram.num_records >= HOST_NVRAM_MAX_RECORDS))
+        return 0;
+
+    *p_status = WICED_ERROR;
+    if (!host_nvram_append(data_length))
+        return 0;
+
+    if (p_record == NULL)
+    {
+        p_record = &host_nvram.records[host_nvram.num_records++];
+        p_record->vs_id = vs_id;
+    }
+    p_record->length = data_length;
+    memcpy(p_record->data, p_data, data_length);
+
+    host_nvram.stats.writes++;
+    *p_status = WICED_SUCCESS;
+    return data_length;
+}
+
+uint16_t wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    host_nvram_record_t *p_record = host_nvram_find(vs_id);
+    uint16_t            length;
+
+    host_nvram.stats.reads++;
+    if (p_record == NULL)
+    {
+        *p_status = WICED_BADARG;
+        return 0;
+    }
+    length = (data_length < p_record->length) ? data_length : p_record->length;
+    memcpy(p_data, p_record->data, length);
+    *p_status = WICED_SUCCESS;
+    return length;
+}
+
+/*
+ * Delete is stored as a record without data, the record is dropped at the next compaction
+ */
+void wiced_hal_delete_nvram(uint16_t vs_id, wiced_result_t *p_status)
+{
+    host_nvram_record_t *p_record = host_nvram_find(vs_id);
+
+    if (p_record == NULL)
+    {
+        *p_status = WICED_BADARG;
+        return;
+    }
+    *p_record = host_nvram.records[--host_nvram.num_records];
+
+    host_nvram_append(0);
+    host_nvram.stats.deletes++;
+    *p_status = WICED_SUCCESS;
+}
+
+host_nvram_record_t *host_nvram_find(uint16_t vs_id)
+{
+    uint8_t i;
+
+    for (i = 0; i < host_nvram.num_records; i++)
+        if (host_nvram.records[i].vs_id == vs_id)
+            return &host_nvram.records[i];
+    return NULL;
+}
+
+/*
+ * Program a record to the active sector. If it does not fit, erase the next sector and copy the live
+ * records first, including the old version of the record being written. The write fails if the live
+ * records fill the sector.
+ */
+wiced_bool_t host_nvram_append(uint16_t length)
+{
+    const host_nvram_flash_t *p_flash = &host_nvram.flash;
+    uint32_t record_length = p_flash->record_overhead + length;
+    uint32_t live;
+
+    if (host_nvram.sector_used + record_length > p_flash->sector_size)
+    {
+        live = host_nvram_live_bytes();
+        if (live + record_length > p_flash->sector_size)
+            return WICED_FALSE;
+
+        host_nvram.sector = (host_nvram.sector + 1) % p_flash->num_sectors;
+        host_nvram.stats.sector_erases[host_nvram.sector]++;
+        host_nvram.stats.compactions++;
+        host_nvram.stats.bytes_programmed += live;
+        host_nvram_stall(p_flash->erase_time_us + live * p_flash->program_time_us_per_byte);
+        host_nvram.sector_used = live;
+    }
+    host_nvram.sector_used            += record_length;
+    host_nvram.stats.bytes_programmed += record_length;
+    host_nvram_stall(record_length * p_flash->program_time_us_per_byte);
+    return WICED_TRUE;
+}
+
+/*
+ * CPU is stalled by the flash operation, the clock moves in whole ms
+ */
+void host_nvram_stall(uint32_t duration_us)
+{
+    host_nvram.stats.stall_us += duration_us;
+    host_nvram.stall_us       += duration_us;
+    host_sim_stall(host_nvram.stall_us / 1000);
+    host_nvram.stall_us %= 1000;
+}
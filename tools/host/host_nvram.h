@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Volatile section NVRAM of the host tools with a flash latency and wear model.
+ *
+ * wiced_hal_write_nvram, wiced_hal_read_nvram and wiced_hal_delete_nvram keep the records in
+ * memory and account them the way the flash stores them: each write or delete appends a record
+ * with a header to the active sector. When the active sector is full, the next sector is erased
+ * and the live records are copied to it before the new record is appended. The time spent in
+ * erase and program operations stalls the simulated clock of host_sim.c, so the application
+ * modules measure it as they would on the device, and erase cycles are counted per sector.
+ */
+#ifndef HOST_NVRAM_H__
+#define HOST_NVRAM_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define HOST_NVRAM_MAX_SECTORS          8
+#define HOST_NVRAM_MAX_RECORDS          64
+#define HOST_NVRAM_MAX_RECORD_LEN       512
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t sector_size;                   // bytes per sector
+    uint8_t  num_sectors;                   // sectors used by the volatile section
+    uint16_t record_overhead;               // header bytes stored with each record
+    uint32_t erase_time_us;                 // sector erase time
+    uint32_t program_time_us_per_byte;      // program time per byte
+} host_nvram_flash_t;
+
+typedef struct
+{
+    uint32_t writes;                        // records written
+    uint32_t deletes;                       // records deleted
+    uint32_t reads;                         // records read
+    uint32_t compactions;                   // active sector changes
+    uint32_t bytes_programmed;              // bytes programmed including the headers and the copied records
+    uint64_t stall_us;                      // time spent in erase and program operations
+    uint32_t sector_erases[HOST_NVRAM_MAX_SECTORS];
+} host_nvram_stats_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+wiced_bool_t host_nvram_init(const host_nvram_flash_t *p_flash);
+void         host_nvram_stats_reset(void);
+void         host_nvram_get_stats(host_nvram_stats_t *p_stats);
+uint32_t     host_nvram_live_bytes(void);
+
+#endif // HOST_NVRAM_H__
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Simulated clock, timers and application thread for the host tools.
+ */
+#include <string.h>
+#include "wiced_timer.h"
+#include "wiced_bt_event.h"
+#include "wiced_bt_mesh_core.h"
+#include "host_sim.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Serialized calls which can be pending at the same time
+#define HOST_SIM_SERIALIZE_QUEUE_SIZE       16
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    int     (*fn)(void *);
+    void    *data;
+} host_sim_serialized_t;
+
+typedef struct
+{
+    uint32_t                now;            // simulated tick count in ms
+    wiced_timer_t           *p_timers;      // running timers sorted by the due time
+    host_sim_serialized_t   queue[HOST_SIM_SERIALIZE_QUEUE_SIZE];
+    uint8_t                 head;
+    uint8_t                 num_queued;
+} host_sim_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static void host_sim_timer_insert(wiced_timer_t *p_timer);
+static void host_sim_timer_remove(wiced_timer_t *p_timer);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static host_sim_t host_sim;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Restart the clock from 0. Timers of the previous run are forgotten, the modules which own
+ * them shall be initialized again.
+ */
+void host_sim_reset(void)
+{
+    memset(&host_sim, 0, sizeof(host_sim));
+}
+
+uint32_t host_sim_now(void)
+{
+    return host_sim.now;
+}
+
+uint32_t wiced_bt_mesh_core_get_tick_count(void)
+{
+    return host_sim.now;
+}
+
+/*
+ * Run the pending serialized calls and the timers which expire up to the time, then move the clock
+ * to the time. A timer started with 0 timeout from a callback runs in the same call.
+ */
+void host_sim_run_until(uint32_t time)
+{
+    wiced_timer_t *p_timer;
+
+    host_sim_run_serialized();
+
+    while (((p_timer = host_sim.p_timers) != NULL) && ((int32_t)(p_timer->due - time) <= 0))
+    {
+        host_sim_timer_remove(p_timer);
+        if ((int32_t)(p_timer->due - host_sim.now) > 0)
+            host_sim.now = p_timer->due;
+
+        if ((p_timer->type == WICED_SECONDS_PERIODIC_TIMER) || (p_timer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER))
+        {
+            p_timer->due = host_sim.now + p_timer->period;
+            host_sim_timer_insert(p_timer);
+        }
+        p_timer->p_cback(p_timer->arg);
+        host_sim_run_serialized();
+    }
+    if ((int32_t)(time - host_sim.now) > 0)
+        host_sim.now = time;
+}
+
+/*
+ * CPU is busy, for example in a flash operation. The clock moves, timers which expire meanwhile
+ * run late.
+ */
+void host_sim_stall(uint32_t duration)
+{
+    host_sim.now += duration;
+}
+
+/*
+ * Run calls serialized to the application thread, including the ones they serialize
+ */
+void host_sim_run_serialized(void)
+{
+    host_sim_serialized_t call;
+
+    while (host_sim.num_queued != 0)
+    {
+        call = host_sim.queue[host_sim.head];
+        host_sim.head = (host_sim.head + 1) % HOST_SIM_SERIALIZE_QUEUE_SIZE;
+        host_sim.num_queued--;
+        call.fn(call.data);
+    }
+}
+
+/*
+ * Due time of the first timer to expire, if any timer is running
+ */
+wiced_bool_t host_sim_timer_due(uint32_t *p_due)
+{
+    if (host_sim.p_timers == NULL)
+        return WICED_FALSE;
+    *p_due = host_sim.p_timers->due;
+    return WICED_TRUE;
+}
+
+wiced_result_t wiced_app_event_serialize(int (*fn)(void *), void *data)
+{
+    host_sim_serialized_t *p_call;
+
+    if (host_sim.num_queued >= HOST_SIM_SERIALIZE_QUEUE_SIZE)
+        return WICED_ERROR;
+
+    p_call = &host_sim.queue[(host_sim.head + host_sim.num_queued) % HOST_SIM_SERIALIZE_QUEUE_SIZE];
+    p_call->fn   = fn;
+    p_call->data = data;
+    host_sim.num_queued++;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t *p_cb, TIMER_PARAM_TYPE cb_params, wiced_timer_type_t type)
+{
+    memset(p_timer, 0, sizeof(*p_timer));
+    p_timer->p_cback = p_cb;
+    p_timer->arg     = cb_params;
+    p_timer->type    = type;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout)
+{
+    if ((p_timer->type == WICED_SECONDS_TIMER) || (p_timer->type == WICED_SECONDS_PERIODIC_TIMER))
+        timeout *= 1000;
+
+    host_sim_timer_remove(p_timer);
+    p_timer->period = timeout;
+    p_timer->due    = host_sim.now + timeout;
+    host_sim_timer_insert(p_timer);
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer)
+{
+    host_sim_timer_remove(p_timer);
+    return WICED_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer)
+{
+    return p_timer->in_use;
+}
+
+/*
+ * Timers with the same due time expire in the order they were started
+ */
+void host_sim_timer_insert(wiced_timer_t *p_timer)
+{
+    wiced_timer_t **pp = &host_sim.p_timers;
+
+    while ((*pp != NULL) && ((int32_t)((*pp)->due - p_timer->due) <= 0))
+        pp = &(*pp)->p_next;
+
+    p_timer->p_next = *pp;
+    *pp = p_timer;
+    p_timer->in_use = WICED_TRUE;
+}
+
+void host_sim_timer_remove(wiced_timer_t *p_timer)
+{
+    wiced_timer_t **pp = &host_sim.p_timers;
+
+    if (!p_timer->in_use)
+        return;
+
+    while ((*pp != NULL) && (*pp != p_timer))
+        pp = &(*pp)->p_next;
+
+    if (*pp != NULL)
+        *pp = p_timer->p_next;
+    p_timer->p_next = NULL;
+    p_timer->in_use = WICED_FALSE;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Simulated clock, timers and application thread for the host tools.
+ *
+ * The tick count returned by wiced_bt_mesh_core_get_tick_count is a simulated clock in ms which
+ * only moves when a tool runs the simulation. Timers started by the application modules expire
+ * in the order of their due time, and calls serialized with wiced_app_event_serialize run before
+ * the clock moves again, so the modules see the same sequence of callbacks and events as on the
+ * device, without the real time passing.
+ */
+#ifndef HOST_SIM_H__
+#define HOST_SIM_H__
+
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void         host_sim_reset(void);
+uint32_t     host_sim_now(void);
+void         host_sim_run_until(uint32_t time);
+void         host_sim_stall(uint32_t duration);
+void         host_sim_run_serialized(void);
+wiced_bool_t host_sim_timer_due(uint32_t *p_due);
+
+#endif // HOST_SIM_H__
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Motion edge traces for the host tools.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "sensor_motion_event.h"
+#include "sensor_motion_workload.h"
+#include "host_sim.h"
+#include "host_trace.h"
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t host_trace_add(host_trace_t *p_trace, uint32_t time);
+static void         host_trace_capture(sensor_motion_event_t *p_event);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static const char *host_trace_model_names[SENSOR_WORKLOAD_MODEL_MAX] = { "office", "corridor", "meeting", "cleaning" };
+
+static host_trace_t *p_host_trace_capture;
+static wiced_bool_t host_trace_capture_failed;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Run the occupancy model for the duration and record the interrupts it posts. With 0 blind time
+ * every motion is recorded.
+ */
+wiced_bool_t host_trace_generate(host_trace_t *p_trace, uint8_t model, uint32_t seed, uint32_t blind_time, uint32_t duration)
+{
+    memset(p_trace, 0, sizeof(*p_trace));
+    if (model >= SENSOR_WORKLOAD_MODEL_MAX)
+        return WICED_FALSE;
+
+    snprintf(p_trace->name, sizeof(p_trace->name), "%s", host_trace_model_names[model]);
+    p_trace->duration = duration;
+
+    host_sim_reset();
+    p_host_trace_capture      = p_trace;
+    host_trace_capture_failed = WICED_FALSE;
+    sensor_motion_event_init(host_trace_capture);
+
+    sensor_workload_init();
+    sensor_workload_set_blind_time(blind_time);
+    sensor_workload_start(model, seed);
+    host_sim_run_until(duration);
+    sensor_workload_stop();
+
+    p_host_trace_capture = NULL;
+    if (host_trace_capture_failed)
+    {
+        host_trace_free(p_trace);
+        return WICED_FALSE;
+    }
+    return WICED_TRUE;
+}
+
+/*
+ * Read a trace file. Times which are not sorted are rejected.
+ */
+wiced_bool_t host_trace_load(host_trace_t *p_trace, const char *p_file_name)
+{
+    FILE          *p_file;
+    char          line[128];
+    unsigned long value;
+    char          *p_end;
+    wiced_bool_t  ok = WICED_TRUE;
+
+    memset(p_trace, 0, sizeof(*p_trace));
+    if ((p_file = fopen(p_file_name, "r")) == NULL)
+        return WICED_FALSE;
+
+    snprintf(p_trace->name, sizeof(p_trace->name), "%s", p_file_name);
+
+    while (ok && (fgets(line, sizeof(line), p_file) != NULL))
+    {
+        if (line[0] == '#')
+        {
+            if (sscanf(line, "# duration %lu", &value) == 1)
+                p_trace->duration = (uint32_t)value;
+            continue;
+        }
+        value = strtoul(line, &p_end, 0);
+        if (p_end == line)
+            continue;
+        if ((p_trace->num_edges != 0) && (value < p_trace->p_edges[p_trace->num_edges - 1]))
+            ok = WICED_FALSE;
+        else
+            ok = host_trace_add(p_trace, (uint32_t)value);
+    }
+    fclose(p_file);
+
+    if (!ok)
+    {
+        host_trace_free(p_trace);
+        return WICED_FALSE;
+    }
+    if ((p_trace->num_edges != 0) && (p_trace->duration <= p_trace->p_edges[p_trace->num_edges - 1]))
+        p_trace->duration = p_trace->p_edges[p_trace->num_edges - 1] + 1;
+    return WICED_TRUE;
+}
+
+void host_trace_write(const host_trace_t *p_trace, FILE *p_file)
+{
+    uint32_t i;
+
+    fprintf(p_file, "# %s\n", p_trace->name);
+    fprintf(p_file, "# duration %u\n", (unsigned)p_trace->duration);
+    for (i = 0; i < p_trace->num_edges; i++)
+        fprintf(p_file, "%u\n", (unsigned)p_trace->p_edges[i]);
+}
+
+void host_trace_free(host_trace_t *p_trace)
+{
+    free(p_trace->p_edges);
+    p_trace->p_edges   = NULL;
+    p_trace->num_edges = 0;
+    p_trace->max_edges = 0;
+}
+
+const char *host_trace_model_name(uint8_t model)
+{
+    return (model < SENSOR_WORKLOAD_MODEL_MAX) ? host_trace_model_names[model] : NULL;
+}
+
+wiced_bool_t host_trace_add(host_trace_t *p_trace, uint32_t time)
+{
+    uint32_t *p_edges;
+
+    if (p_trace->num_edges == p_trace->max_edges)
+    {
+        p_edges = realloc(p_trace->p_edges, (p_trace->max_edges ? 2 * p_trace->max_edges : 64) * sizeof(uint32_t));
+        if (p_edges == NULL)
+            return WICED_FALSE;
+        p_trace->p_edges   = p_edges;
+        p_trace->max_edges = p_trace->max_edges ? 2 * p_trace->max_edges : 64;
+    }
+    p_trace->p_edges[p_trace->num_edges++] = time;
+    return WICED_TRUE;
+}
+
+void host_trace_capture(sensor_motion_event_t *p_event)
+{
+    if ((p_event->type != SENSOR_MOTION_EVENT_PRESENCE_DETECTED) || (p_host_trace_capture == NULL))
+        return;
+    if (!host_trace_add(p_host_trace_capture, p_event->timestamp))
+        host_trace_capture_failed = WICED_TRUE;
+}
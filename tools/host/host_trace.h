@@ -0,0 +1,73 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Motion edge traces for the host tools.
+ *
+ * A trace is a list of times in ms from the start when the PIR sensor sees motion, and the duration
+ * of the recording. Traces are read from text files with one time per line, lines starting with #
+ * are comments, and "# duration <ms>" gives the duration. Traces can also be generated with the
+ * occupancy models of sensor_motion_workload.c, the same code which generates interrupts on a
+ * device built with SYNTHETIC_MOTION=1. A trace generated with a blind time has the interrupts of
+ * the PIR sensor, a trace generated without has every motion, so that the blind time can be
+ * applied later, as tools/host/sensor_sim.c does.
+ */
+#ifndef HOST_TRACE_H__
+#define HOST_TRACE_H__
+
+#include <stdio.h>
+#include "wiced_bt_types.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    char     name[64];          // file name or model name
+    uint32_t *p_edges;          // motion edges in ms from the start, sorted
+    uint32_t num_edges;
+    uint32_t max_edges;         // allocated length of p_edges
+    uint32_t duration;          // length of the trace in ms
+} host_trace_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+wiced_bool_t host_trace_generate(host_trace_t *p_trace, uint8_t model, uint32_t seed, uint32_t blind_time, uint32_t duration);
+wiced_bool_t host_trace_load(host_trace_t *p_trace, const char *p_file_name);
+void         host_trace_write(const host_trace_t *p_trace, FILE *p_file);
+void         host_trace_free(host_trace_t *p_trace);
+const char  *host_trace_model_name(uint8_t model);
+
+#endif // HOST_TRACE_H__
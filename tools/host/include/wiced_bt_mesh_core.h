@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Host build of the application modules: the tick count is the simulated clock of host_sim.c,
+ * and the part of the model configuration and of the received message the modules use.
+ */
+#ifndef WICED_BT_MESH_CORE_H
+#define WICED_BT_MESH_CORE_H
+
+#include "wiced_bt_types.h"
+
+#define MESH_COMPANY_ID_BT_SIG                              0x0000
+#define WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_SRV    0x0004
+
+typedef struct
+{
+    uint16_t     opcode;                        // opcode of the received message
+    uint16_t     src;                           // source address
+    uint16_t     dst;                           // destination address
+} wiced_bt_mesh_event_t;
+
+typedef wiced_bool_t (*wiced_bt_mesh_core_received_msg_handler_t)(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+typedef struct
+{
+    uint16_t     company_id;
+    uint16_t     model_id;
+    wiced_bt_mesh_core_received_msg_handler_t p_message_handler;
+} wiced_bt_mesh_core_config_model_t;
+
+uint32_t wiced_bt_mesh_core_get_tick_count(void);
+
+#endif // WICED_BT_MESH_CORE_H
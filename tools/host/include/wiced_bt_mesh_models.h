@@ -0,0 +1,54 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Host build of the application modules: Sensor Cadence state as defined by the mesh models library.
+ */
+#ifndef WICED_BT_MESH_MODELS_H
+#define WICED_BT_MESH_MODELS_H
+
+#include "wiced_bt_types.h"
+
+typedef struct
+{
+    uint16_t     fast_cadence_period_divisor;   // divisor for the publish period
+    wiced_bool_t trigger_type_percentage;       // trigger deltas are in 0.01% units rather than in property units
+    uint32_t     trigger_delta_down;            // decrease of the value which triggers a publication
+    uint32_t     trigger_delta_up;              // increase of the value which triggers a publication
+    uint32_t     min_interval;                  // minimum interval in ms between publications
+    int32_t      fast_cadence_low;              // low boundary of the fast cadence range
+    int32_t      fast_cadence_high;             // high boundary of the fast cadence range
+} wiced_bt_mesh_sensor_config_cadence_t;
+
+#endif // WICED_BT_MESH_MODELS_H
@@ -0,0 +1,357 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Host model of the presence detection and publication of the Sensor Motion app.
+ */
+#include <string.h>
+#include "wiced_timer.h"
+#include "wiced_bt_mesh_core.h"
+#include "sensor_motion_event.h"
+#include "sensor_motion_rate_limit.h"
+#include "sensor_motion_publish.h"
+#include "sensor_motion_profile.h"
+#include "host_sim.h"
+#include "sensor_sim.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SENSOR_SIM_MS_PER_DAY                   (24ULL * 3600 * 1000)
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    sensor_sim_config_t config;
+    sensor_sim_stats_t  stats;
+    uint32_t            start_time;
+
+    wiced_timer_t       cadence_timer;
+    wiced_timer_t       presence_timer;
+    wiced_timer_t       deferred_timer;
+    sensor_rate_limit_t rate_limit;
+
+    wiced_bool_t        presence_detected;
+    wiced_bool_t        interrupted;            // PIR has interrupted at least once
+    uint32_t            interrupt_time;         // time of the last interrupt, start of the blind time
+    wiced_bool_t        motion_pending;         // presence has been detected and not yet published
+    uint32_t            motion_time;
+    uint8_t             publish_pending;        // destinations of the deferred publications
+    int32_t             pub_value;
+    uint32_t            pub_time;
+    uint32_t            fast_publish_period;
+} sensor_sim_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static void     sensor_sim_event_handler(sensor_motion_event_t *p_event);
+static void     sensor_sim_cadence_timer_callback(TIMER_PARAM_TYPE arg);
+static void     sensor_sim_presence_timer_callback(TIMER_PARAM_TYPE arg);
+static void     sensor_sim_deferred_timer_callback(TIMER_PARAM_TYPE arg);
+static void     sensor_sim_publish_config(sensor_publish_config_t *p_config);
+static void     sensor_sim_restart_timer(void);
+static void     sensor_sim_timer_process(void);
+static void     sensor_sim_value_changed(void);
+static void     sensor_sim_publish(uint8_t dst);
+static void     sensor_sim_publish_send(uint8_t dst, uint32_t now);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static sensor_sim_t sensor_sim;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Start the model at the current simulated time with the configuration. The area is empty.
+ */
+void sensor_sim_start(const sensor_sim_config_t *p_config)
+{
+    uint32_t now = wiced_bt_mesh_core_get_tick_count();
+    sensor_publish_config_t config;
+
+    memset(&sensor_sim, 0, sizeof(sensor_sim));
+    sensor_sim.config     = *p_config;
+    sensor_sim.start_time = now;
+    sensor_latency_reset(&sensor_sim.stats.latency);
+
+    sensor_motion_event_init(sensor_sim_event_handler);
+    wiced_init_timer(&sensor_sim.cadence_timer, sensor_sim_cadence_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&sensor_sim.presence_timer, sensor_sim_presence_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&sensor_sim.deferred_timer, sensor_sim_deferred_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+    sensor_sim_publish_config(&config);
+    sensor_rate_limit_init(&sensor_sim.rate_limit, SENSOR_PUBLISH_RATE_LIMIT_BURST, sensor_publish_rate_limit_interval(&config), now);
+
+    // as after a cadence change, the first expiration publishes regardless of the last publication
+    sensor_sim.pub_time = now - sensor_sim.config.publish_period;
+    sensor_sim_restart_timer();
+}
+
+/*
+ * Apply a performance profile to the configuration as mesh_sensor_profile_set does
+ */
+void sensor_sim_profile(sensor_sim_config_t *p_config, uint8_t profile)
+{
+    p_config->blind_time           = sensor_profiles[profile].blind_time * 1000;
+    p_config->cadence.min_interval = sensor_profiles[profile].min_interval;
+}
+
+/*
+ * Motion edge seen by the PIR at the current time. The E93196 does not interrupt during the
+ * blind time after an interrupt, the interrupt handler posts the event as e93196_int_proc does.
+ */
+void sensor_sim_motion(void)
+{
+    uint32_t now = wiced_bt_mesh_core_get_tick_count();
+
+    sensor_sim.stats.edges++;
+    if (sensor_sim.interrupted && (now - sensor_sim.interrupt_time < sensor_sim.config.blind_time))
+        return;
+
+    sensor_sim.interrupted    = WICED_TRUE;
+    sensor_sim.interrupt_time = now;
+    sensor_sim.stats.interrupts++;
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PRESENCE_DETECTED, NULL);
+}
+
+/*
+ * Replay motion edges, in ms from the start, and run the model until the duration expires
+ */
+void sensor_sim_run_trace(const uint32_t *p_edges, uint32_t num_edges, uint32_t duration)
+{
+    uint32_t i;
+
+    for (i = 0; (i < num_edges) && (p_edges[i] <= duration); i++)
+    {
+        host_sim_run_until(sensor_sim.start_time + p_edges[i]);
+        sensor_sim_motion();
+    }
+    host_sim_run_until(sensor_sim.start_time + duration);
+}
+
+void sensor_sim_get_stats(sensor_sim_stats_t *p_stats)
+{
+    *p_stats = sensor_sim.stats;
+    p_stats->elapsed = wiced_bt_mesh_core_get_tick_count() - sensor_sim.start_time;
+}
+
+uint32_t sensor_sim_publishes_per_day(const sensor_sim_stats_t *p_stats)
+{
+    if (p_stats->elapsed == 0)
+        return 0;
+    return (uint32_t)((uint64_t)p_stats->publishes * SENSOR_SIM_MS_PER_DAY / p_stats->elapsed);
+}
+
+/*
+ * Same dispatch as mesh_sensor_event_handler for the events of the model
+ */
+void sensor_sim_event_handler(sensor_motion_event_t *p_event)
+{
+    switch (p_event->type)
+    {
+    case SENSOR_MOTION_EVENT_PRESENCE_DETECTED:
+        wiced_start_timer(&sensor_sim.presence_timer, 2 * sensor_sim.config.blind_time);
+        if (!sensor_sim.presence_detected)
+        {
+            sensor_sim.presence_detected = WICED_TRUE;
+            sensor_sim.motion_pending    = WICED_TRUE;
+            sensor_sim.motion_time       = p_event->timestamp;
+            sensor_sim.stats.presence_changes++;
+            sensor_sim_value_changed();
+        }
+        break;
+
+    case SENSOR_MOTION_EVENT_PRESENCE_TIMEOUT:
+        if (sensor_sim.presence_detected)
+        {
+            sensor_sim.presence_detected = WICED_FALSE;
+            if (sensor_sim.motion_pending)
+            {
+                sensor_sim.motion_pending = WICED_FALSE;
+                sensor_sim.stats.latency_missed++;
+            }
+            sensor_sim.stats.presence_changes++;
+            sensor_sim_value_changed();
+        }
+        break;
+
+    case SENSOR_MOTION_EVENT_PUBLISH_TIMER:
+        sensor_sim_timer_process();
+        break;
+
+    case SENSOR_MOTION_EVENT_PUBLISH_DEFERRED:
+        if (sensor_sim.publish_pending != 0)
+            sensor_sim_publish(0);
+        break;
+    }
+}
+
+void sensor_sim_cadence_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PUBLISH_TIMER, NULL);
+}
+
+void sensor_sim_presence_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PRESENCE_TIMEOUT, NULL);
+}
+
+void sensor_sim_deferred_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    sensor_motion_event_post(SENSOR_MOTION_EVENT_PUBLISH_DEFERRED, NULL);
+}
+
+/*
+ * mesh_sensor_publish_config
+ */
+void sensor_sim_publish_config(sensor_publish_config_t *p_config)
+{
+    p_config->p_cadence       = &sensor_sim.config.cadence;
+    p_config->publish_period  = sensor_sim.config.publish_period;
+    p_config->zone            = sensor_sim.config.zone;
+    p_config->proxy_connected = sensor_sim.config.proxy_connected;
+    p_config->dfu_transfer    = sensor_sim.config.dfu_transfer;
+}
+
+/*
+ * mesh_sensor_server_restart_timer
+ */
+void sensor_sim_restart_timer(void)
+{
+    sensor_publish_config_t config;
+    uint32_t timeout;
+
+    wiced_stop_timer(&sensor_sim.cadence_timer);
+
+    sensor_sim_publish_config(&config);
+    timeout = sensor_publish_timer_timeout(&config, &sensor_sim.fast_publish_period);
+    if (timeout == 0)
+        return;
+
+    wiced_start_timer(&sensor_sim.cadence_timer, timeout);
+    sensor_sim.stats.timer_rearms++;
+}
+
+/*
+ * mesh_sensor_publish_timer_process
+ */
+void sensor_sim_timer_process(void)
+{
+    sensor_publish_config_t config;
+
+    sensor_sim.stats.evaluations++;
+
+    sensor_sim_publish_config(&config);
+    if (sensor_publish_on_timer(&config, wiced_bt_mesh_core_get_tick_count() - sensor_sim.pub_time, sensor_sim.fast_publish_period,
+                                sensor_sim.presence_detected, sensor_sim.pub_value))
+        sensor_sim_publish(SENSOR_PUBLISH_GATEWAY);
+
+    sensor_sim_restart_timer();
+}
+
+/*
+ * mesh_sensor_value_changed
+ */
+void sensor_sim_value_changed(void)
+{
+    sensor_publish_config_t config;
+    uint8_t decision;
+
+    sensor_sim_publish_config(&config);
+    decision = sensor_publish_on_change(&config, wiced_bt_mesh_core_get_tick_count() - sensor_sim.pub_time,
+                                        sensor_sim.presence_detected, sensor_sim.pub_value);
+    if (decision & SENSOR_PUBLISH_EVALUATED)
+        sensor_sim.stats.evaluations++;
+
+    if (decision & SENSOR_PUBLISH_DST_MASK)
+        sensor_sim_publish(decision & SENSOR_PUBLISH_DST_MASK);
+    if (decision & SENSOR_PUBLISH_RESTART_TIMER)
+        sensor_sim_restart_timer();
+}
+
+/*
+ * mesh_sensor_publish
+ */
+void sensor_sim_publish(uint8_t dst)
+{
+    uint32_t now = wiced_bt_mesh_core_get_tick_count();
+    sensor_publish_config_t config;
+    uint32_t interval;
+    uint32_t wait;
+
+    sensor_sim_publish_config(&config);
+    interval = sensor_publish_rate_limit_interval(&config);
+
+    sensor_sim.publish_pending |= dst;
+    while ((dst = sensor_publish_next(&sensor_sim.publish_pending, &sensor_sim.rate_limit, interval, now, &wait)) != 0)
+        sensor_sim_publish_send(dst, now);
+
+    if (sensor_sim.publish_pending != 0)
+    {
+        sensor_sim.stats.deferred++;
+        wiced_start_timer(&sensor_sim.deferred_timer, wait);
+        return;
+    }
+    wiced_stop_timer(&sensor_sim.deferred_timer);
+}
+
+/*
+ * mesh_sensor_publish_send, the value is counted instead of sent. Only the publication to the
+ * gateway is the reference of the cadence.
+ */
+void sensor_sim_publish_send(uint8_t dst, uint32_t now)
+{
+    if (dst == SENSOR_PUBLISH_GATEWAY)
+    {
+        sensor_sim.pub_value = sensor_sim.presence_detected;
+        sensor_sim.pub_time  = now;
+    }
+    else
+    {
+        sensor_sim.stats.zone_publishes++;
+    }
+    sensor_sim.stats.publishes++;
+    if (sensor_sim.config.p_publish_cback != NULL)
+        sensor_sim.config.p_publish_cback(now);
+
+    if (sensor_sim.motion_pending && sensor_sim.presence_detected)
+    {
+        sensor_sim.motion_pending = WICED_FALSE;
+        sensor_latency_record(&sensor_sim.stats.latency, now - sensor_sim.motion_time);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Host model of the presence detection and publication of the Sensor Motion app.
+ *
+ * The model follows mesh_sensor_presence_detected, mesh_sensor_presence_timeout,
+ * mesh_sensor_value_changed, mesh_sensor_publish_timer_process and mesh_sensor_publish of
+ * sensor_motion.c with the same event queue, publication decisions, cadence evaluation, rate
+ * limiter and latency histogram modules as the device. The PIR sensor is replaced by motion edges
+ * passed to sensor_sim_motion, which are suppressed during the blind time after an interrupt as the
+ * E93196 does. Publications to the zone group and to the gateway are counted instead of sent, and
+ * passed to the publish callback of the configuration if there is one. With proxy_connected or
+ * dfu_transfer set the model behaves as the device while a GATT proxy client is connected or a
+ * firmware image is transferred, sensor_sim_profile applies a performance profile.
+ */
+#ifndef SENSOR_SIM_H__
+#define SENSOR_SIM_H__
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_mesh_models.h"
+#include "sensor_motion_latency.h"
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef void (*sensor_sim_publish_cback_t)(uint32_t time);
+
+typedef struct
+{
+    wiced_bt_mesh_sensor_config_cadence_t   cadence;
+    uint32_t                                publish_period;     // publish period of the Sensor Server model in ms, 0 if not configured
+    uint32_t                                blind_time;         // PIR blind time in ms, presence times out after twice that
+    wiced_bool_t                            zone;               // presence changes are sent to a zone group
+    wiced_bool_t                            proxy_connected;    // a GATT proxy client is connected
+    wiced_bool_t                            dfu_transfer;       // a firmware image is being transferred to the device
+    sensor_sim_publish_cback_t              p_publish_cback;    // called with the time of every publication, or NULL
+} sensor_sim_config_t;
+
+typedef struct
+{
+    uint32_t         elapsed;           // simulated time since the start in ms
+    uint32_t         edges;             // motion edges seen by the PIR
+    uint32_t         interrupts;        // edges which interrupted, the others were in the blind time
+    uint32_t         presence_changes;  // changes of the Presence Detected value
+    uint32_t         evaluations;       // cadence evaluations
+    uint32_t         publishes;         // publications of the value
+    uint32_t         zone_publishes;    // publications of the value to the zone group
+    uint32_t         timer_rearms;      // cadence timer restarts
+    uint32_t         deferred;          // publications refused by the rate limiter
+    uint32_t         latency_missed;    // presence periods which ended before they were published
+    sensor_latency_t latency;           // motion to publication latency
+} sensor_sim_stats_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+void     sensor_sim_start(const sensor_sim_config_t *p_config);
+void     sensor_sim_profile(sensor_sim_config_t *p_config, uint8_t profile);
+void     sensor_sim_motion(void);
+void     sensor_sim_run_trace(const uint32_t *p_edges, uint32_t num_edges, uint32_t duration);
+void     sensor_sim_get_stats(sensor_sim_stats_t *p_stats);
+uint32_t sensor_sim_publishes_per_day(const sensor_sim_stats_t *p_stats);
+
+#endif // SENSOR_SIM_H__
@@ -0,0 +1,677 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Low Power Node polling simulation.
+ *
+ * Models the friendship of the sensor built with LOW_POWER_NODE=1 with a Friend node, to choose
+ * the maximum sleep, poll timeout and receive delay which keep remote configuration usable
+ * without draining the battery. Messages to the sensor wait in the Friend queue until the sensor
+ * polls. The sensor polls when its sleep ends, and polls again at once while the Friend reports
+ * more data. The Friend answers each poll within its receive window after the receive delay,
+ * with the oldest queued PDU or with a Friend Update if the queue is empty. The queue holds as
+ * many PDUs as fit in cache_buf_len, the oldest PDU is discarded when a new one does not fit.
+ *
+ * Two kinds of downlink traffic go through the queue. Messages to a group the sensor subscribes
+ * to arrive at random times. Configuration sessions, at random times, send a sequence of
+ * acknowledged messages, some of them segmented, and send the next message when the status of
+ * the previous one is received. A configuration client waits for the poll timeout before it
+ * sends a message again. Each poll or response is lost with the given probability, a lost poll
+ * is repeated after the receive window. If the sensor does not get a response for the poll
+ * timeout the Friend terminates the friendship, the queue is lost and the sensor establishes a
+ * new friendship.
+ *
+ * The tool reports the polls, the radio-on time of the polls and of the responses of the sensor,
+ * the distribution of the downlink latency, from the first transmission of a message to its
+ * reception by the sensor, the duration of the configuration sessions, the PDUs the Friend
+ * discarded and the friendships lost. The publications of the sensor are not included, see
+ * cadence_suite. The radio timing constants are estimates. The profiles, the check of the poll
+ * settings and the sleep duration are the ones of the application, sensor_motion_profile.c and
+ * sensor_motion_lpn.c. The tool fails if a message is not accounted for.
+ *
+ * Usage: lpn_sim [-p profile] [-S max sleep ms] [-t poll timeout 100ms] [-r receive delay ms] [-w receive window ms]
+ *                [-c cache_buf_len] [-g group messages per hour] [-n sessions per day] [-k messages per session]
+ *                [-l loss percent] [-d hours] [-s seed] [-T]
+ *   Without -p, -S, -t and -r the settings of the three profiles of the application are simulated.
+ *   Settings not given replace the ones of the profile, 1 balanced by default, as the LPN poll HCI
+ *   command of the application does. -T checks the poll settings and sleep decisions of the
+ *   application and exits.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "wiced_bt_types.h"
+#include "sensor_motion_profile.h"
+#include "sensor_motion_lpn.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define LPN_SIM_MS_PER_HOUR             3600000ULL
+#define LPN_SIM_DEFAULT_HOURS           24
+#define LPN_SIM_DEFAULT_SEED            0x2545F491
+#define LPN_SIM_DEFAULT_LOSS            2           // percent of the polls and of the responses lost
+#define LPN_SIM_DEFAULT_GROUP_RATE      60          // group messages per hour
+#define LPN_SIM_DEFAULT_SESSIONS        24          // configuration sessions per day
+#define LPN_SIM_DEFAULT_SESSION_LEN     8           // acknowledged messages per configuration session
+
+// Same as the Friend and Low Power configuration of sensor_motion.c
+#define LPN_SIM_DEFAULT_RECEIVE_DELAY   100
+#define LPN_SIM_DEFAULT_RECEIVE_WINDOW  20
+#define LPN_SIM_DEFAULT_CACHE_BUF_LEN   300
+#define LPN_SIM_MIN_CACHE_SIZE_LOG      3
+
+// Radio timing, estimates
+#define LPN_SIM_TX_TIME                 3           // ms the radio is on to send a PDU on the three advertising channels
+#define LPN_SIM_RX_TIME                 1           // ms to receive a PDU
+#define LPN_SIM_PDU_SIZE                29          // bytes of the cache a queued network PDU takes
+#define LPN_SIM_POLL_ATTEMPTS           4           // polls sent before the sensor waits for the next sleep to end
+#define LPN_SIM_STATUS_TIME             50          // ms from the reception of a message to the next message of the client
+#define LPN_SIM_ESTABLISH_TIME          1100        // ms the radio is on to establish a friendship, Friend Request and the offers
+
+#define LPN_SIM_MAX_QUEUE               256
+
+#define LPN_SIM_GROUP_MESSAGE           0xFFFFFFFF  // message id of the PDUs of group messages
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t max_sleep;             // ms
+    uint32_t poll_timeout;          // 100ms units
+    uint32_t receive_delay;         // ms
+} lpn_sim_poll_t;
+
+typedef struct
+{
+    uint64_t sent_time;             // first transmission of the message by the sender
+    uint32_t message;               // configuration message id, or LPN_SIM_GROUP_MESSAGE
+    uint8_t  segment;
+} lpn_sim_pdu_t;
+
+typedef struct
+{
+    uint32_t *p_values;
+    uint32_t num_values;
+    uint32_t max_values;
+} lpn_sim_samples_t;
+
+typedef struct
+{
+    // settings
+    sensor_lpn_poll_t setting;      // poll settings replacing the ones of the profile
+    const sensor_profile_t *p_profile;
+    lpn_sim_poll_t    poll;         // poll settings in effect
+    uint32_t          receive_window;
+    uint32_t          queue_size;
+    uint32_t          loss;         // in 1/65536
+    double            group_interval;
+    double            session_interval;
+    uint32_t          session_len;
+    uint64_t          duration;
+    uint32_t          random;
+
+    // Friend queue
+    lpn_sim_pdu_t     queue[LPN_SIM_MAX_QUEUE];
+    uint32_t          queue_head;
+    uint32_t          queue_len;
+
+    // traffic
+    uint64_t          next_group;
+    uint64_t          next_session;
+    uint64_t          session_start;
+    wiced_bool_t      session_active;
+    uint32_t          session_message;  // index of the message in the session
+    uint32_t          message;          // id of the current configuration message
+    uint64_t          message_time;     // first transmission of the current message
+    uint64_t          client_send;      // time of the next transmission by the client, 0 if none
+    wiced_bool_t      client_next;      // next transmission is the next message of the session
+    uint32_t          segments_received;
+
+    // results
+    uint64_t          radio_on;
+    uint32_t          polls;
+    uint32_t          sent;
+    uint32_t          received;
+    uint32_t          retransmissions;
+    uint32_t          discarded;
+    uint32_t          friendships_lost;
+    lpn_sim_samples_t latency;
+    lpn_sim_samples_t sessions;
+} lpn_sim_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+// Segments of the messages of a configuration session, for example AppKey Add, Model App Bind,
+// Model Publication Set, Model Subscription Add and Sensor Cadence Set
+static const uint8_t lpn_sim_session_segments[] = { 3, 1, 2, 1, 2, 1, 2, 1 };
+
+static lpn_sim_t lpn_sim;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+static uint32_t lpn_sim_random(void)
+{
+    lpn_sim.random ^= lpn_sim.random << 13;
+    lpn_sim.random ^= lpn_sim.random >> 17;
+    lpn_sim.random ^= lpn_sim.random << 5;
+    return lpn_sim.random;
+}
+
+/*
+ * Exponentially distributed interval with the mean in ms
+ */
+static uint64_t lpn_sim_interval(double mean)
+{
+    return (uint64_t)(-mean * log((lpn_sim_random() + 1.0) / 4294967297.0)) + 1;
+}
+
+static wiced_bool_t lpn_sim_lost(void)
+{
+    return (lpn_sim_random() & 0xFFFF) < lpn_sim.loss;
+}
+
+static void lpn_sim_sample(lpn_sim_samples_t *p_samples, uint32_t value)
+{
+    uint32_t *p_values;
+
+    if (p_samples->num_values == p_samples->max_values)
+    {
+        p_samples->max_values = p_samples->max_values ? 2 * p_samples->max_values : 256;
+        p_values = realloc(p_samples->p_values, p_samples->max_values * sizeof(uint32_t));
+        if (p_values == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+        p_samples->p_values = p_values;
+    }
+    p_samples->p_values[p_samples->num_values++] = value;
+}
+
+static int lpn_sim_compare(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a, b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/*
+ * Percentile of sorted samples in seconds
+ */
+static double lpn_sim_percentile(const lpn_sim_samples_t *p_samples, uint32_t percent)
+{
+    uint32_t index;
+
+    if (p_samples->num_values == 0)
+        return 0;
+    index = (uint32_t)(((uint64_t)p_samples->num_values * percent + 99) / 100);
+    return p_samples->p_values[(index != 0) ? index - 1 : 0] / 1000.0;
+}
+
+/*
+ * Friend queues a PDU for the sensor, the oldest PDU is discarded if the cache is full
+ */
+static void lpn_sim_queue(uint64_t sent_time, uint32_t message, uint8_t segment)
+{
+    lpn_sim_pdu_t *p_pdu;
+
+    if (lpn_sim.queue_len == lpn_sim.queue_size)
+    {
+        lpn_sim.queue_head = (lpn_sim.queue_head + 1) % LPN_SIM_MAX_QUEUE;
+        lpn_sim.queue_len--;
+        lpn_sim.discarded++;
+    }
+    p_pdu = &lpn_sim.queue[(lpn_sim.queue_head + lpn_sim.queue_len) % LPN_SIM_MAX_QUEUE];
+    p_pdu->sent_time = sent_time;
+    p_pdu->message   = message;
+    p_pdu->segment   = segment;
+    lpn_sim.queue_len++;
+}
+
+/*
+ * Configuration client sends the current message of the session, all segments are queued
+ */
+static void lpn_sim_client_send(uint64_t time)
+{
+    uint8_t segments = lpn_sim_session_segments[lpn_sim.session_message % sizeof(lpn_sim_session_segments)];
+    uint8_t s;
+
+    for (s = 0; s < segments; s++)
+        lpn_sim_queue(lpn_sim.message_time, lpn_sim.message, s);
+    // the client sends again if there is no status for the poll timeout
+    lpn_sim.client_send = time + (uint64_t)lpn_sim.poll.poll_timeout * 100;
+    lpn_sim.client_next = WICED_FALSE;
+}
+
+/*
+ * Configuration client sends the next message of the session
+ */
+static void lpn_sim_client_next(uint64_t time)
+{
+    lpn_sim.message++;
+    lpn_sim.message_time      = time;
+    lpn_sim.segments_received = 0;
+    lpn_sim.sent++;
+    lpn_sim_client_send(time);
+}
+
+/*
+ * Traffic which arrives at the Friend up to the time
+ */
+static void lpn_sim_traffic(uint64_t time)
+{
+    uint64_t next;
+
+    for (;;)
+    {
+        next = lpn_sim.next_group;
+        if (lpn_sim.next_session < next)
+            next = lpn_sim.next_session;
+        if ((lpn_sim.client_send != 0) && (lpn_sim.client_send < next))
+            next = lpn_sim.client_send;
+        if (next > time)
+            return;
+
+        if (next == lpn_sim.next_group)
+        {
+            lpn_sim_queue(next, LPN_SIM_GROUP_MESSAGE, 0);
+            lpn_sim.sent++;
+            lpn_sim.next_group = next + lpn_sim_interval(lpn_sim.group_interval);
+        }
+        else if (next == lpn_sim.next_session)
+        {
+            // a session which starts while another one is in progress is dropped
+            lpn_sim.next_session = next + lpn_sim_interval(lpn_sim.session_interval);
+            if (!lpn_sim.session_active)
+            {
+                lpn_sim.session_active  = WICED_TRUE;
+                lpn_sim.session_start   = next;
+                lpn_sim.session_message = 0;
+                lpn_sim_client_next(next);
+            }
+        }
+        else if (lpn_sim.client_next)
+        {
+            lpn_sim_client_next(next);
+        }
+        else
+        {
+            lpn_sim.retransmissions++;
+            lpn_sim_client_send(next);
+        }
+    }
+}
+
+/*
+ * Sensor received a PDU from the Friend
+ */
+static void lpn_sim_receive(const lpn_sim_pdu_t *p_pdu, uint64_t time)
+{
+    uint8_t segments;
+
+    if (p_pdu->message == LPN_SIM_GROUP_MESSAGE)
+    {
+        lpn_sim.received++;
+        lpn_sim_sample(&lpn_sim.latency, (uint32_t)(time - p_pdu->sent_time));
+        return;
+    }
+    // segments of a message which is already received, sent again by the client, are ignored
+    if (!lpn_sim.session_active || (p_pdu->message != lpn_sim.message) || lpn_sim.client_next)
+        return;
+
+    segments = lpn_sim_session_segments[lpn_sim.session_message % sizeof(lpn_sim_session_segments)];
+    lpn_sim.segments_received |= 1 << p_pdu->segment;
+    if (lpn_sim.segments_received != (1U << segments) - 1)
+        return;
+
+    // segment acknowledgment of a segmented message, and the status
+    lpn_sim.radio_on += (segments > 1) ? 2 * LPN_SIM_TX_TIME : LPN_SIM_TX_TIME;
+    lpn_sim.received++;
+    lpn_sim_sample(&lpn_sim.latency, (uint32_t)(time - p_pdu->sent_time));
+
+    if (++lpn_sim.session_message < lpn_sim.session_len)
+    {
+        lpn_sim.client_send = time + LPN_SIM_STATUS_TIME;
+        lpn_sim.client_next = WICED_TRUE;
+    }
+    else
+    {
+        lpn_sim.client_send    = 0;
+        lpn_sim.session_active = WICED_FALSE;
+        lpn_sim_sample(&lpn_sim.sessions, (uint32_t)(time - lpn_sim.session_start));
+    }
+}
+
+/*
+ * Friend terminated the friendship, the sensor establishes a new one
+ */
+static void lpn_sim_friendship_lost(void)
+{
+    lpn_sim.friendships_lost++;
+    lpn_sim.discarded += lpn_sim.queue_len;
+    lpn_sim.queue_len  = 0;
+    lpn_sim.radio_on  += LPN_SIM_ESTABLISH_TIME;
+}
+
+/*
+ * Sleep ended, the sensor polls until the Friend has no more data. Returns the time the sensor
+ * goes to sleep.
+ */
+static uint64_t lpn_sim_poll(uint64_t time, uint64_t *p_last_response)
+{
+    uint32_t     attempt = 0;
+    uint32_t     response_delay;
+    lpn_sim_pdu_t pdu;
+
+    for (;;)
+    {
+        if (time - *p_last_response > (uint64_t)lpn_sim.poll.poll_timeout * 100)
+        {
+            lpn_sim_friendship_lost();
+            *p_last_response = time;
+        }
+        lpn_sim_traffic(time);
+
+        lpn_sim.polls++;
+        lpn_sim.radio_on += LPN_SIM_TX_TIME;
+        if (lpn_sim_lost() || lpn_sim_lost())
+        {
+            // no response, the sensor listened for the whole receive window
+            lpn_sim.radio_on += lpn_sim.receive_window;
+            time += lpn_sim.poll.receive_delay + lpn_sim.receive_window;
+            if (++attempt == LPN_SIM_POLL_ATTEMPTS)
+                return time;
+            continue;
+        }
+        response_delay = lpn_sim_random() % (lpn_sim.receive_window + 1);
+        lpn_sim.radio_on += response_delay + LPN_SIM_RX_TIME;
+        time += lpn_sim.poll.receive_delay + response_delay + LPN_SIM_RX_TIME;
+        *p_last_response = time;
+        attempt = 0;
+
+        // Friend Update if the queue is empty
+        if (lpn_sim.queue_len == 0)
+            return time;
+
+        pdu = lpn_sim.queue[lpn_sim.queue_head];
+        lpn_sim.queue_head = (lpn_sim.queue_head + 1) % LPN_SIM_MAX_QUEUE;
+        lpn_sim.queue_len--;
+        lpn_sim_receive(&pdu, time);
+
+        // more data flag
+        if (lpn_sim.queue_len == 0)
+            return time;
+    }
+}
+
+static void lpn_sim_run(const sensor_lpn_poll_t *p_setting, uint8_t profile, uint32_t receive_window, uint32_t cache_buf_len, uint32_t loss,
+                        uint32_t group_rate, uint32_t sessions, uint32_t session_len, uint32_t hours, uint32_t seed)
+{
+    uint64_t time = 0, last_response = 0;
+
+    free(lpn_sim.latency.p_values);
+    free(lpn_sim.sessions.p_values);
+    memset(&lpn_sim, 0, sizeof(lpn_sim));
+
+    lpn_sim.setting            = *p_setting;
+    lpn_sim.p_profile          = &sensor_profiles[profile];
+    lpn_sim.poll.max_sleep     = sensor_lpn_max_sleep(p_setting, lpn_sim.p_profile);
+    lpn_sim.poll.poll_timeout  = sensor_lpn_poll_timeout(p_setting, lpn_sim.p_profile);
+    lpn_sim.poll.receive_delay = (p_setting->receive_delay != 0) ? p_setting->receive_delay : LPN_SIM_DEFAULT_RECEIVE_DELAY;
+    lpn_sim.receive_window   = receive_window;
+    lpn_sim.queue_size       = cache_buf_len / LPN_SIM_PDU_SIZE;
+    lpn_sim.loss             = loss * 65536 / 100;
+    lpn_sim.group_interval   = group_rate ? (double)LPN_SIM_MS_PER_HOUR / group_rate : 0;
+    lpn_sim.session_interval = sessions ? 24.0 * LPN_SIM_MS_PER_HOUR / sessions : 0;
+    lpn_sim.session_len      = session_len;
+    lpn_sim.duration         = hours * LPN_SIM_MS_PER_HOUR;
+    lpn_sim.random           = seed;
+
+    lpn_sim.next_group   = group_rate ? lpn_sim_interval(lpn_sim.group_interval) : UINT64_MAX;
+    lpn_sim.next_session = sessions ? lpn_sim_interval(lpn_sim.session_interval) : UINT64_MAX;
+
+    // The friendship is established at the start, the sensor polls every time its sleep ends. The
+    // mesh core allows the sensor to sleep until the poll timeout, the area is vacant.
+    lpn_sim.radio_on += LPN_SIM_ESTABLISH_TIME;
+    while (time < lpn_sim.duration)
+    {
+        time += sensor_lpn_sleep_duration(&lpn_sim.setting, lpn_sim.p_profile, lpn_sim.poll.poll_timeout * 100, 0, WICED_FALSE, 0);
+        time = lpn_sim_poll(time, &last_response);
+    }
+    qsort(lpn_sim.latency.p_values, lpn_sim.latency.num_values, sizeof(uint32_t), lpn_sim_compare);
+    qsort(lpn_sim.sessions.p_values, lpn_sim.sessions.num_values, sizeof(uint32_t), lpn_sim_compare);
+}
+
+/*
+ * Same checks as mesh_sensor_lpn_poll_set, and the Friend shall have the cache the sensor asks for
+ */
+static wiced_bool_t lpn_sim_check(sensor_lpn_poll_t *p_setting, uint8_t profile, uint32_t cache_buf_len)
+{
+    if (!sensor_lpn_poll_check(p_setting, &sensor_profiles[profile]))
+    {
+        fprintf(stderr, "poll timeout shall be %u to %u and exceed the max sleep\n", SENSOR_LPN_POLL_TIMEOUT_MIN, SENSOR_LPN_POLL_TIMEOUT_MAX);
+        return WICED_FALSE;
+    }
+    if ((cache_buf_len / LPN_SIM_PDU_SIZE < (1 << LPN_SIM_MIN_CACHE_SIZE_LOG)) || (cache_buf_len / LPN_SIM_PDU_SIZE > LPN_SIM_MAX_QUEUE))
+    {
+        fprintf(stderr, "cache_buf_len shall hold %u to %u PDUs of %u bytes\n", 1 << LPN_SIM_MIN_CACHE_SIZE_LOG, LPN_SIM_MAX_QUEUE,
+                LPN_SIM_PDU_SIZE);
+        return WICED_FALSE;
+    }
+    return WICED_TRUE;
+}
+
+static wiced_bool_t lpn_sim_expect(const char *p_name, wiced_bool_t passed)
+{
+    printf("%-46s %s\n", p_name, passed ? "ok" : "FAIL");
+    return passed;
+}
+
+/*
+ * Poll settings and sleep decisions of the application
+ */
+static int lpn_sim_self_test(void)
+{
+    const sensor_profile_t *p_balanced = &sensor_profiles[SENSOR_PROFILE_BALANCED];
+    sensor_lpn_poll_t      poll;
+    wiced_bool_t           passed = WICED_TRUE;
+    uint8_t                profile;
+
+    for (profile = 0; profile < SENSOR_PROFILE_MAX; profile++)
+    {
+        memset(&poll, 0, sizeof(poll));
+        passed &= lpn_sim_expect("profile settings accepted", sensor_lpn_poll_check(&poll, &sensor_profiles[profile]) &&
+                                 (sensor_lpn_max_sleep(&poll, &sensor_profiles[profile]) == sensor_profiles[profile].lpn_max_sleep) &&
+                                 (sensor_lpn_poll_timeout(&poll, &sensor_profiles[profile]) == sensor_profiles[profile].lpn_poll_timeout));
+    }
+
+    poll = (sensor_lpn_poll_t){ 500, SENSOR_LPN_POLL_TIMEOUT_MIN - 1, 0 };
+    passed &= lpn_sim_expect("poll timeout below the range rejected", !sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 500, SENSOR_LPN_POLL_TIMEOUT_MIN, 0 };
+    passed &= lpn_sim_expect("poll timeout at the minimum accepted", sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 0, SENSOR_LPN_POLL_TIMEOUT_MAX + 1, 0 };
+    passed &= lpn_sim_expect("poll timeout above the range rejected", !sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 60000, 600, 0 };
+    passed &= lpn_sim_expect("poll timeout equal to the max sleep rejected", !sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 60000, 601, 0 };
+    passed &= lpn_sim_expect("poll timeout above the max sleep accepted", sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 0, 500, 0 };
+    passed &= lpn_sim_expect("poll timeout below the profile sleep rejected", !sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 3600000, 0, 0 };
+    passed &= lpn_sim_expect("max sleep of the profile timeout rejected", !sensor_lpn_poll_check(&poll, p_balanced));
+    poll = (sensor_lpn_poll_t){ 0, 0, SENSOR_LPN_RECEIVE_DELAY_MIN - 1 };
+    passed &= lpn_sim_expect("short receive delay raised to the minimum", sensor_lpn_poll_check(&poll, p_balanced) &&
+                             (poll.receive_delay == SENSOR_LPN_RECEIVE_DELAY_MIN));
+
+    memset(&poll, 0, sizeof(poll));
+    passed &= lpn_sim_expect("sleep limited by the profile",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 0, WICED_FALSE, 0) == p_balanced->lpn_max_sleep);
+    passed &= lpn_sim_expect("sleep limited by the mesh core", sensor_lpn_sleep_duration(&poll, p_balanced, 5000, 0, WICED_FALSE, 0) == 5000);
+    passed &= lpn_sim_expect("sleep limited by the cadence on presence",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 1 << 10, WICED_TRUE, 0) == (1 << 10));
+    passed &= lpn_sim_expect("sleep not limited by the cadence on vacancy",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 1 << 10, WICED_FALSE, 0) == p_balanced->lpn_max_sleep);
+    passed &= lpn_sim_expect("sleep not limited without the cadence timer",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 0, WICED_TRUE, 0) == p_balanced->lpn_max_sleep);
+    passed &= lpn_sim_expect("sleep limited by the next delayed rule",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 0, WICED_FALSE, 30000) == 30000);
+    passed &= lpn_sim_expect("sleep not extended by a later rule",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 0, WICED_FALSE, 3600000) == p_balanced->lpn_max_sleep);
+    poll.max_sleep = 20000;
+    passed &= lpn_sim_expect("sleep limited by the poll setting",
+                             sensor_lpn_sleep_duration(&poll, p_balanced, 600000, 0, WICED_FALSE, 0) == 20000);
+
+    passed &= lpn_sim_expect("ePDS below 30 minutes", !sensor_lpn_hid_off(SENSOR_LPN_HID_OFF_MIN_SLEEP - 1));
+    passed &= lpn_sim_expect("HID-Off from 30 minutes", sensor_lpn_hid_off(SENSOR_LPN_HID_OFF_MIN_SLEEP));
+    for (profile = 0; profile < SENSOR_PROFILE_MAX; profile++)
+    {
+        memset(&poll, 0, sizeof(poll));
+        passed &= lpn_sim_expect("profile sleeps in ePDS",
+                                 !sensor_lpn_hid_off(sensor_lpn_sleep_duration(&poll, &sensor_profiles[profile], 0xFFFFFFFF, 0, WICED_FALSE, 0)));
+    }
+    poll = (sensor_lpn_poll_t){ SENSOR_LPN_HID_OFF_MIN_SLEEP, SENSOR_LPN_HID_OFF_MIN_SLEEP / 100 + 1, 0 };
+    passed &= lpn_sim_expect("30 minutes poll setting sleeps in HID-Off", sensor_lpn_poll_check(&poll, p_balanced) &&
+                             sensor_lpn_hid_off(sensor_lpn_sleep_duration(&poll, p_balanced, 0xFFFFFFFF, 0, WICED_FALSE, 0)));
+
+    if (!passed)
+    {
+        printf("FAIL: poll settings or sleep decisions\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    sensor_lpn_poll_t polls[SENSOR_PROFILE_MAX];
+    uint8_t        profiles[SENSOR_PROFILE_MAX];
+    sensor_lpn_poll_t setting = { 0 };
+    uint32_t       profile = SENSOR_PROFILE_BALANCED;
+    uint32_t       receive_delay = 0;
+    uint32_t       num_polls = SENSOR_PROFILE_MAX;
+    uint32_t       receive_window = LPN_SIM_DEFAULT_RECEIVE_WINDOW;
+    uint32_t       cache_buf_len = LPN_SIM_DEFAULT_CACHE_BUF_LEN;
+    uint32_t       group_rate = LPN_SIM_DEFAULT_GROUP_RATE;
+    uint32_t       sessions = LPN_SIM_DEFAULT_SESSIONS;
+    uint32_t       session_len = LPN_SIM_DEFAULT_SESSION_LEN;
+    uint32_t       loss = LPN_SIM_DEFAULT_LOSS;
+    uint32_t       hours = LPN_SIM_DEFAULT_HOURS;
+    uint32_t       seed = LPN_SIM_DEFAULT_SEED;
+    uint32_t       pending;
+    uint32_t       i;
+    int            result = 0;
+    int            opt;
+
+    memset(polls, 0, sizeof(polls));
+    for (i = 0; i < SENSOR_PROFILE_MAX; i++)
+        profiles[i] = (uint8_t)i;
+
+    while ((opt = getopt(argc, argv, "p:S:t:r:w:c:g:n:k:l:d:s:T")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p': profile = (uint32_t)strtoul(optarg, NULL, 0); num_polls = 1; break;
+        case 'S': setting.max_sleep = (uint32_t)strtoul(optarg, NULL, 0); num_polls = 1; break;
+        case 't': setting.poll_timeout = (uint32_t)strtoul(optarg, NULL, 0); num_polls = 1; break;
+        case 'r': receive_delay = (uint32_t)strtoul(optarg, NULL, 0); num_polls = 1; break;
+        case 'w': receive_window = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'c': cache_buf_len = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'g': group_rate = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'n': sessions = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'k': session_len = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'l': loss = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'd': hours = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'T': return lpn_sim_self_test();
+        default:
+            fprintf(stderr, "usage: %s [-p profile] [-S max sleep ms] [-t poll timeout 100ms] [-r receive delay ms] [-w receive window ms] [-c cache_buf_len]\n"
+                    "       [-g group messages per hour] [-n sessions per day] [-k messages per session] [-l loss percent] [-d hours] [-s seed] [-T]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if ((hours == 0) || (hours > 10000) || (profile >= SENSOR_PROFILE_MAX) || (receive_delay > 0xFF) || (loss >= 50) || (receive_window == 0) ||
+        (receive_window > 0xFF) || (session_len == 0) || (session_len > 32))
+    {
+        fprintf(stderr, "hours shall be 1 to 10000, profile 0 to 2, receive delay up to 255, loss below 50%%, receive window 1 to 255 and messages per session 1 to 32\n");
+        return 2;
+    }
+    // settings not given on the command line are the ones of the profile
+    setting.receive_delay = (uint8_t)receive_delay;
+    if (num_polls == 1)
+    {
+        polls[0]    = setting;
+        profiles[0] = (uint8_t)profile;
+    }
+    for (i = 0; i < num_polls; i++)
+        if (!lpn_sim_check(&polls[i], profiles[i], cache_buf_len))
+            return 2;
+
+    printf("%u group messages per hour, %u sessions of %u messages per day, cache of %u PDUs, receive window %u ms, loss %u%%\n",
+           (unsigned)group_rate, (unsigned)sessions, (unsigned)session_len, (unsigned)(cache_buf_len / LPN_SIM_PDU_SIZE),
+           (unsigned)receive_window, (unsigned)loss);
+    printf("%9s %8s %6s %8s %10s %6s %8s %8s %8s %8s %10s %11s %9s %5s\n", "sleep ms", "timeout", "delay", "polls/h", "radio ms/h",
+           "duty", "p50 s", "p90 s", "p99 s", "max s", "session s", "session max", "discarded", "lost");
+
+    for (i = 0; i < num_polls; i++)
+    {
+        lpn_sim_run(&polls[i], profiles[i], receive_window, cache_buf_len, loss, group_rate, sessions, session_len, hours, seed);
+
+        printf("%9u %8u %6u %8.1f %10.0f %5.2f%% %8.1f %8.1f %8.1f %8.1f %10.1f %11.1f %9u %5u\n",
+               (unsigned)lpn_sim.poll.max_sleep, (unsigned)lpn_sim.poll.poll_timeout, (unsigned)lpn_sim.poll.receive_delay,
+               (double)lpn_sim.polls / hours, (double)lpn_sim.radio_on / hours, 100.0 * lpn_sim.radio_on / lpn_sim.duration,
+               lpn_sim_percentile(&lpn_sim.latency, 50), lpn_sim_percentile(&lpn_sim.latency, 90),
+               lpn_sim_percentile(&lpn_sim.latency, 99), lpn_sim_percentile(&lpn_sim.latency, 100),
+               lpn_sim_percentile(&lpn_sim.sessions, 50), lpn_sim_percentile(&lpn_sim.sessions, 100),
+               (unsigned)lpn_sim.discarded, (unsigned)lpn_sim.friendships_lost);
+
+        // a message is received, or still in the queue or in progress at the end, or some of its PDUs were discarded
+        pending = lpn_sim.queue_len + (lpn_sim.session_active ? 1 : 0);
+        if ((lpn_sim.received > lpn_sim.sent) || (lpn_sim.sent > lpn_sim.received + pending + lpn_sim.discarded))
+        {
+            printf("FAIL: %u messages sent, %u received, %u pending and %u PDUs discarded\n", (unsigned)lpn_sim.sent,
+                   (unsigned)lpn_sim.received, (unsigned)pending, (unsigned)lpn_sim.discarded);
+            result = 1;
+        }
+    }
+    free(lpn_sim.latency.p_values);
+    free(lpn_sim.sessions.p_values);
+    return result;
+}
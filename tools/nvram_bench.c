@@ -0,0 +1,340 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * NVRAM cost of provisioning and reconfiguration.
+ *
+ * Replays the NVRAM accesses of provisioning, reconfiguration and factory reset sessions through
+ * sensor_motion_nvram.c, the module the application writes the NVRAM with, on top of the flash
+ * model of tools/host/host_nvram.c. For each session the tool reports the writes, the writes skipped
+ * because the data did not change, the deletes, the CPU stall and the sector erases, then runs
+ * reconfiguration sessions at the given rate for 4 weeks to project the stall and the erase cycles
+ * per year. The run is shorter than the 49 days after which the tick count wraps, as on the device.
+ * The flash model copies the live records at every sector change, which the estimate the device
+ * reports with sensor_motion_nvram_erases_per_year does not, so both projections are printed.
+ *
+ * The records of the application have the sizes of the types sensor_motion.c stores. The mesh
+ * core stores its own configuration in the NVRAM as well, the sizes of those records are estimates.
+ *
+ * Usage: nvram_bench [-r reconfigurations per day]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "wiced_hal_nvram.h"
+#include "wiced_bt_mesh_models.h"
+#include "sensor_motion_nvram.h"
+#include "sensor_motion_rule.h"
+#include "host_sim.h"
+#include "host_nvram.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Same as sensor_motion.c
+#define MESH_MOTION_SENSOR_CADENCE_VSID_START           WICED_NVRAM_VSID_START
+#define MESH_MOTION_SENSOR_CADENCE_BASELINE_VSID        (WICED_NVRAM_VSID_START + 1)
+#define MESH_MOTION_SENSOR_COMMISSIONING_VSID           (WICED_NVRAM_VSID_START + 2)
+#define MESH_MOTION_SENSOR_ZONE_VSID                    (WICED_NVRAM_VSID_START + 3)
+#define MESH_MOTION_SENSOR_RELAY_VSID                   (WICED_NVRAM_VSID_START + 4)
+#define MESH_MOTION_SENSOR_PIR_SETTING_VSID             (WICED_NVRAM_VSID_START + 5)
+#define MESH_MOTION_SENSOR_PROFILE_VSID                 (WICED_NVRAM_VSID_START + 6)
+#define MESH_MOTION_SENSOR_RULE_VSID                    (WICED_NVRAM_VSID_START + 7)
+#define MESH_MOTION_SENSOR_LPN_POLL_VSID                (WICED_NVRAM_VSID_START + 8)
+#define MESH_MOTION_SENSOR_NUM_VSIDS                    9
+
+// Records of the mesh core, below the application range
+#define NVRAM_BENCH_CORE_VSID_START                     0x100
+#define NVRAM_BENCH_CORE_NUM_VSIDS                      4
+
+#define NVRAM_BENCH_MS_PER_DAY                          (24UL * 3600 * 1000)
+#define NVRAM_BENCH_DAYS_PER_YEAR                       365
+#define NVRAM_BENCH_DAYS                                28
+
+#define NVRAM_BENCH_DEFAULT_RECONFIGURATIONS_PER_DAY    4
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// Sizes of the records of sensor_motion.c
+typedef struct { uint16_t addr; uint16_t app_key_idx; uint8_t ttl; } nvram_bench_zone_t;
+typedef struct { uint32_t provisioned_time; uint32_t first_publish_time; } nvram_bench_commissioning_t;
+typedef struct { uint32_t evaluations_per_hour; uint32_t publishes_per_hour; uint32_t timer_rearms_per_hour; } nvram_bench_rates_t;
+typedef struct { uint32_t max_sleep; uint32_t poll_timeout; uint8_t receive_delay; } nvram_bench_lpn_poll_t;
+
+typedef struct
+{
+    const char *name;
+    void       (*session)(uint32_t index);
+} nvram_bench_session_t;
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static void nvram_bench_provision(uint32_t index);
+static void nvram_bench_reconfigure(uint32_t index);
+static void nvram_bench_factory_reset(uint32_t index);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+// Estimated sizes of the node, network key, application key and model configuration of the mesh core
+static const uint16_t nvram_bench_core_record_len[NVRAM_BENCH_CORE_NUM_VSIDS] = { 64, 34, 36, 48 };
+
+static const nvram_bench_session_t nvram_bench_sessions[] =
+{
+    { "provisioning",     nvram_bench_provision },
+    { "reconfiguration",  nvram_bench_reconfigure },
+    { "factory reset",    nvram_bench_factory_reset },
+};
+
+static const host_nvram_flash_t nvram_bench_flash =
+{
+    .sector_size              = SENSOR_MOTION_NVRAM_SECTOR_SIZE,
+    .num_sectors              = SENSOR_MOTION_NVRAM_NUM_SECTORS,
+    .record_overhead          = SENSOR_MOTION_NVRAM_RECORD_OVERHEAD,
+    .erase_time_us            = SENSOR_MOTION_NVRAM_ERASE_TIME_US,
+    .program_time_us_per_byte = SENSOR_MOTION_NVRAM_PROGRAM_TIME_US_PER_BYTE,
+};
+
+static wiced_bt_mesh_sensor_config_cadence_t nvram_bench_cadence;
+static uint8_t                               nvram_bench_profile;
+static nvram_bench_zone_t                    nvram_bench_zone;
+static sensor_rule_t                         nvram_bench_rules[SENSOR_RULE_MAX];
+static uint32_t                              nvram_bench_failures;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Record is expected to be stored with the data
+ */
+static void nvram_bench_verify(uint16_t vs_id, uint16_t length, const void *p_data)
+{
+    uint8_t        stored[HOST_NVRAM_MAX_RECORD_LEN];
+    wiced_result_t result;
+
+    if ((wiced_hal_read_nvram(vs_id, length, stored, &result) != length) || (memcmp(stored, p_data, length) != 0))
+    {
+        printf("FAIL: record %04x is not stored\n", vs_id);
+        nvram_bench_failures++;
+    }
+}
+
+/*
+ * Configuration written by mesh_sensor_server_process_cadence_changed
+ */
+static void nvram_bench_cadence_changed(void)
+{
+    wiced_result_t result;
+
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(nvram_bench_cadence), (uint8_t *)&nvram_bench_cadence, &result);
+}
+
+/*
+ * Provisioning writes the configuration of the mesh core, the commissioning measurement, and the
+ * cadence, zone and rules set by the provisioner
+ */
+void nvram_bench_provision(uint32_t index)
+{
+    uint8_t                     core_record[HOST_NVRAM_MAX_RECORD_LEN];
+    nvram_bench_commissioning_t commissioning = { 12000 + index, 15000 + index };
+    wiced_result_t              result;
+    uint8_t                     i;
+
+    for (i = 0; i < NVRAM_BENCH_CORE_NUM_VSIDS; i++)
+    {
+        memset(core_record, (uint8_t)(index + i), nvram_bench_core_record_len[i]);
+        wiced_hal_write_nvram(NVRAM_BENCH_CORE_VSID_START + i, nvram_bench_core_record_len[i], core_record, &result);
+    }
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_COMMISSIONING_VSID, sizeof(commissioning), (uint8_t *)&commissioning, &result);
+
+    memset(&nvram_bench_cadence, 0, sizeof(nvram_bench_cadence));
+    nvram_bench_cadence.fast_cadence_period_divisor = 1;
+    nvram_bench_cadence.min_interval                = 1 << 10;
+    nvram_bench_cadence_changed();
+
+    nvram_bench_zone.addr        = 0xC000;
+    nvram_bench_zone.app_key_idx = 0;
+    nvram_bench_zone.ttl         = 2;
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_ZONE_VSID, sizeof(nvram_bench_zone), (uint8_t *)&nvram_bench_zone, &result);
+
+    memset(nvram_bench_rules, 0, sizeof(nvram_bench_rules));
+    nvram_bench_rules[0].type  = SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_ONOFF);
+    nvram_bench_rules[0].dst   = 0xC001;
+    nvram_bench_rules[0].value = 1;
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_RULE_VSID, sizeof(nvram_bench_rules), (uint8_t *)nvram_bench_rules, &result);
+
+    nvram_bench_verify(MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(nvram_bench_cadence), &nvram_bench_cadence);
+    nvram_bench_verify(MESH_MOTION_SENSOR_COMMISSIONING_VSID, sizeof(commissioning), &commissioning);
+    nvram_bench_verify(MESH_MOTION_SENSOR_ZONE_VSID, sizeof(nvram_bench_zone), &nvram_bench_zone);
+    nvram_bench_verify(MESH_MOTION_SENSOR_RULE_VSID, sizeof(nvram_bench_rules), nvram_bench_rules);
+}
+
+/*
+ * A typical tuning visit: the cadence is set twice as the installer tries two min intervals, the
+ * performance profile is switched (mesh_sensor_profile_set writes the cadence and the profile), the
+ * zone is set again to the same group and the delay of a rule is changed
+ */
+void nvram_bench_reconfigure(uint32_t index)
+{
+    nvram_bench_rates_t rates = { 120 + index, 60, 120 };
+    wiced_result_t      result;
+
+    nvram_bench_cadence.min_interval = 1 << 8;
+    nvram_bench_cadence_changed();
+    nvram_bench_cadence.min_interval = 1 << 10;
+    nvram_bench_cadence_changed();
+
+    nvram_bench_profile = (uint8_t)(index % 3);
+    nvram_bench_cadence.min_interval = 1 << (8 + 2 * nvram_bench_profile);
+    nvram_bench_cadence_changed();
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_PROFILE_VSID, sizeof(nvram_bench_profile), &nvram_bench_profile, &result);
+
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_ZONE_VSID, sizeof(nvram_bench_zone), (uint8_t *)&nvram_bench_zone, &result);
+
+    nvram_bench_rules[0].delay = (uint8_t)(index % 2);
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_RULE_VSID, sizeof(nvram_bench_rules), (uint8_t *)nvram_bench_rules, &result);
+
+    // cadence statistics baseline is saved after the visit
+    sensor_motion_nvram_write(MESH_MOTION_SENSOR_CADENCE_BASELINE_VSID, sizeof(rates), (uint8_t *)&rates, &result);
+
+    nvram_bench_verify(MESH_MOTION_SENSOR_CADENCE_VSID_START, sizeof(nvram_bench_cadence), &nvram_bench_cadence);
+    nvram_bench_verify(MESH_MOTION_SENSOR_PROFILE_VSID, sizeof(nvram_bench_profile), &nvram_bench_profile);
+    nvram_bench_verify(MESH_MOTION_SENSOR_RULE_VSID, sizeof(nvram_bench_rules), nvram_bench_rules);
+}
+
+/*
+ * mesh_app_factory_reset deletes every record of the application, the mesh core deletes its own
+ */
+void nvram_bench_factory_reset(uint32_t index)
+{
+    uint8_t        stored[HOST_NVRAM_MAX_RECORD_LEN];
+    wiced_result_t result;
+    uint16_t       i;
+
+    for (i = 0; i < MESH_MOTION_SENSOR_NUM_VSIDS; i++)
+        sensor_motion_nvram_delete(MESH_MOTION_SENSOR_CADENCE_VSID_START + i);
+    for (i = 0; i < NVRAM_BENCH_CORE_NUM_VSIDS; i++)
+        wiced_hal_delete_nvram(NVRAM_BENCH_CORE_VSID_START + i, &result);
+
+    for (i = 0; i < MESH_MOTION_SENSOR_NUM_VSIDS; i++)
+    {
+        if (wiced_hal_read_nvram(MESH_MOTION_SENSOR_CADENCE_VSID_START + i, sizeof(stored), stored, &result) != 0)
+        {
+            printf("FAIL: record %04x is not deleted\n", MESH_MOTION_SENSOR_CADENCE_VSID_START + i);
+            nvram_bench_failures++;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t                    reconfigurations_per_day = NVRAM_BENCH_DEFAULT_RECONFIGURATIONS_PER_DAY;
+    sensor_motion_nvram_stats_t stats;
+    host_nvram_stats_t          flash_stats;
+    uint32_t                    day, i, index = 0;
+    size_t                      s;
+    int                         opt;
+
+    while ((opt = getopt(argc, argv, "r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r': reconfigurations_per_day = (uint32_t)strtoul(optarg, NULL, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-r reconfigurations per day]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((reconfigurations_per_day == 0) || (reconfigurations_per_day > 1000))
+    {
+        fprintf(stderr, "reconfigurations per day shall be 1 to 1000\n");
+        return 2;
+    }
+
+    host_sim_reset();
+    host_nvram_init(&nvram_bench_flash);
+
+    // Columns from the statistics of sensor_motion_nvram.c, then from the flash model, which includes the mesh core records
+    printf("%-16s %6s %7s %7s %7s %10s %11s %10s %7s\n", "session", "writes", "skipped", "deletes", "bytes", "model ms",
+           "flash bytes", "flash ms", "erases");
+    for (s = 0; s < sizeof(nvram_bench_sessions) / sizeof(nvram_bench_sessions[0]); s++)
+    {
+        sensor_motion_nvram_stats_reset();
+        host_nvram_stats_reset();
+        nvram_bench_sessions[s].session(index++);
+        sensor_motion_nvram_get_stats(&stats);
+        host_nvram_get_stats(&flash_stats);
+
+        printf("%-16s %6u %7u %7u %7u %10.1f %11u %10.1f %7u\n", nvram_bench_sessions[s].name, (unsigned)stats.writes,
+               (unsigned)stats.writes_skipped, (unsigned)stats.deletes, (unsigned)stats.bytes_written, stats.model_stall_us / 1000.0,
+               (unsigned)flash_stats.bytes_programmed, flash_stats.stall_us / 1000.0, (unsigned)flash_stats.compactions);
+    }
+
+    // Reconfigurations of a provisioned device at the rate
+    host_sim_reset();
+    host_nvram_init(&nvram_bench_flash);
+    nvram_bench_provision(index++);
+    sensor_motion_nvram_stats_reset();
+    host_nvram_stats_reset();
+
+    for (day = 0; day < NVRAM_BENCH_DAYS; day++)
+    {
+        for (i = 0; i < reconfigurations_per_day; i++)
+        {
+            host_sim_run_until(day * NVRAM_BENCH_MS_PER_DAY + i * (NVRAM_BENCH_MS_PER_DAY / reconfigurations_per_day));
+            nvram_bench_reconfigure(index++);
+        }
+    }
+    host_sim_run_until(NVRAM_BENCH_DAYS * NVRAM_BENCH_MS_PER_DAY);
+    sensor_motion_nvram_get_stats(&stats);
+    host_nvram_get_stats(&flash_stats);
+
+    printf("\nper year with %u reconfigurations per day:\n", (unsigned)reconfigurations_per_day);
+    printf("  device estimate: %u erase cycles, %.1f ms stall\n", (unsigned)sensor_motion_nvram_erases_per_year(),
+           stats.model_stall_us / 1000.0 * NVRAM_BENCH_DAYS_PER_YEAR / NVRAM_BENCH_DAYS);
+    printf("  flash model:     %u erase cycles, %.1f ms stall\n", (unsigned)(flash_stats.compactions * NVRAM_BENCH_DAYS_PER_YEAR / NVRAM_BENCH_DAYS),
+           flash_stats.stall_us / 1000.0 * NVRAM_BENCH_DAYS_PER_YEAR / NVRAM_BENCH_DAYS);
+    for (i = 0; i < nvram_bench_flash.num_sectors; i++)
+        printf("  sector %u:        %u erase cycles\n", (unsigned)i, (unsigned)(flash_stats.sector_erases[i] * NVRAM_BENCH_DAYS_PER_YEAR / NVRAM_BENCH_DAYS));
+
+    if (nvram_bench_failures != 0)
+    {
+        printf("FAIL: %u records were not stored as written\n", (unsigned)nvram_bench_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+#
+# Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+
+"""Size of an OTA update between two builds of the application.
+
+Compares two <app>.bin images built with OTA_FW_UPGRADE=1 and reports the
+size of the full image, raw and compressed, and the size of a delta which
+rebuilds the new image from the old one, raw and compressed. The delta is
+a list of copies from the old image and literal bytes, in the format applied
+on the device by sensor_motion_delta.c. The delta is applied to the old image
+and the result is compared with the new image bit for bit. -o writes the delta
+to send to the device. The xz size shows how much a compressing transport
+would save in addition, the device applies the delta uncompressed.
+
+Usage: ota_delta.py old.bin new.bin [-o delta file]
+       ota_delta.py --self-test [-d directory]
+
+With -d the self test writes self_test_old.bin, self_test_new.bin and
+self_test.delta to the directory, for the round trip through the applier of
+the device with delta_apply.
+"""
+
+import argparse
+import gzip
+import lzma
+import os
+import random
+import struct
+import sys
+import zlib
+
+DELTA_MAGIC = b"SMD1"
+DELTA_BLOCK = 16            # length of the blocks of the old image which are matched
+OP_COPY = 0
+OP_ADD = 1
+
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def make_delta(old, new):
+    """Copies of the old image where a block matches, literal bytes elsewhere"""
+    index = {}
+    for offset in range(0, len(old) - DELTA_BLOCK + 1, DELTA_BLOCK):
+        index.setdefault(old[offset:offset + DELTA_BLOCK], offset)
+
+    out = bytearray(DELTA_MAGIC)
+    out += struct.pack("<II", len(new), zlib.crc32(new))
+    literal_start = 0
+    pos = 0
+    while pos + DELTA_BLOCK <= len(new):
+        offset = index.get(new[pos:pos + DELTA_BLOCK])
+        if offset is None:
+            pos += 1
+            continue
+        # extend the match backwards into the pending literal and forwards
+        while pos > literal_start and offset > 0 and new[pos - 1] == old[offset - 1]:
+            pos -= 1
+            offset -= 1
+        length = DELTA_BLOCK
+        while pos + length < len(new) and offset + length < len(old) and new[pos + length] == old[offset + length]:
+            length += 1
+        if pos > literal_start:
+            out.append(OP_ADD)
+            out += varint(pos - literal_start) + new[literal_start:pos]
+        out.append(OP_COPY)
+        out += varint(offset) + varint(length)
+        pos += length
+        literal_start = pos
+    if len(new) > literal_start:
+        out.append(OP_ADD)
+        out += varint(len(new) - literal_start) + new[literal_start:]
+    return bytes(out)
+
+
+def apply_delta(old, delta):
+    if delta[:4] != DELTA_MAGIC:
+        raise ValueError("not a delta")
+    length, crc = struct.unpack_from("<II", delta, 4)
+    out = bytearray()
+    pos = 12
+    while pos < len(delta):
+        op = delta[pos]
+        pos += 1
+        if op == OP_COPY:
+            offset, pos = read_varint(delta, pos)
+            count, pos = read_varint(delta, pos)
+            out += old[offset:offset + count]
+        elif op == OP_ADD:
+            count, pos = read_varint(delta, pos)
+            out += delta[pos:pos + count]
+            pos += count
+        else:
+            raise ValueError("bad delta operation %d" % op)
+    if len(out) != length or zlib.crc32(out) != crc:
+        raise ValueError("delta does not rebuild the image")
+    return bytes(out)
+
+
+def report(old, new, delta_file=None):
+    delta = make_delta(old, new)
+    rebuilt = apply_delta(old, delta)
+    if delta_file:
+        with open(delta_file, "wb") as f:
+            f.write(delta)
+    full_xz = len(lzma.compress(new))
+    delta_xz = len(lzma.compress(delta))
+    print("old image    %8d bytes" % len(old))
+    print("new image    %8d bytes, gzip %d, xz %d" % (len(new), len(gzip.compress(new, 9)), full_xz))
+    print("delta        %8d bytes, xz %d, %.1f%% of the compressed image" % (len(delta), delta_xz, 100.0 * delta_xz / max(full_xz, 1)))
+    if rebuilt != new:
+        print("FAIL: the delta does not rebuild the new image")
+        return 1
+    print("round trip   new image rebuilt bit for bit")
+    return 0
+
+
+def self_test(directory=None):
+    """An image with a few changed bytes and an inserted function"""
+    rng = random.Random(1)
+    words = [rng.randrange(1 << 32) for _ in range(1024)]
+    old = b"".join(struct.pack("<I", rng.choice(words)) for _ in range(32768))
+    new = bytearray(old)
+    for _ in range(20):
+        new[rng.randrange(len(new))] ^= 0xFF
+    insert = rng.randrange(len(new))
+    new[insert:insert] = bytes(rng.randrange(256) for _ in range(300))
+    new = bytes(new)
+    if directory is None:
+        return report(old, new)
+    with open(os.path.join(directory, "self_test_old.bin"), "wb") as f:
+        f.write(old)
+    with open(os.path.join(directory, "self_test_new.bin"), "wb") as f:
+        f.write(new)
+    return report(old, new, os.path.join(directory, "self_test.delta"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Size of an OTA update between two builds")
+    parser.add_argument("old", nargs="?", help="image running on the devices")
+    parser.add_argument("new", nargs="?", help="image to send")
+    parser.add_argument("-o", dest="delta_file", help="write the delta")
+    parser.add_argument("--self-test", action="store_true", help="check the round trip with a generated image")
+    parser.add_argument("-d", dest="directory", help="with --self-test, write the images and the delta to the directory")
+    args = parser.parse_args()
+
+    if args.self_test:
+        return self_test(args.directory)
+    if not args.old or not args.new:
+        parser.error("old and new images are required")
+    with open(args.old, "rb") as f:
+        old = f.read()
+    with open(args.new, "rb") as f:
+        new = f.read()
+    return report(old, new, args.delta_file)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,380 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Blind time and cadence parameter search.
+ *
+ * Runs the presence detection and publication path of the application (tools/host/sensor_sim.c)
+ * over motion traces for every combination of the PIR blind time, publish period, fast cadence
+ * divisor, min interval and trigger, and lists the combinations which meet the latency objective
+ * with the fewest publications per day. The latency is the motion to publication latency the
+ * device measures, a presence period which ends before it is published counts as an unbounded
+ * latency. The traces shall have every motion (workload_gen without -b), the blind time is applied
+ * by the simulation.
+ *
+ * The combinations are evaluated by one worker process per core. The application modules keep
+ * their state in static variables, so the workers are processes rather than threads. Each worker
+ * takes the next combination from a counter in shared memory when it is done with the previous
+ * one, so that a core which gets short runs takes more of them.
+ *
+ * Usage: param_search [-l latency ms] [-p percentile] [-j workers] [-n results] [-z] [-d hours] [trace file ...]
+ *   -l  latency objective, 300 ms by default
+ *   -p  percentile of the objective, 95 by default
+ *   -j  number of worker processes, number of cores by default
+ *   -n  number of combinations listed
+ *   -z  presence changes are sent to a zone group as well
+ *   -d  hours of the traces generated when no trace file is given, one per occupancy model
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "sensor_motion_workload.h"
+#include "host_sim.h"
+#include "host_trace.h"
+#include "sensor_sim.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define PARAM_SEARCH_MS_PER_HOUR            3600000
+#define PARAM_SEARCH_DEFAULT_HOURS          24
+#define PARAM_SEARCH_DEFAULT_SEED           0x2545F491
+#define PARAM_SEARCH_DEFAULT_LATENCY        300
+#define PARAM_SEARCH_DEFAULT_PERCENTILE     95
+#define PARAM_SEARCH_DEFAULT_RESULTS        10
+#define PARAM_SEARCH_MAX_TRACES             64
+#define PARAM_SEARCH_MAX_WORKERS            256
+
+#define PARAM_SEARCH_NUM_BLIND_TIMES        8
+#define PARAM_SEARCH_NUM_PERIODS            4
+#define PARAM_SEARCH_NUM_DIVISORS           5
+#define PARAM_SEARCH_NUM_MIN_INTERVALS      5
+#define PARAM_SEARCH_NUM_TRIGGERS           2
+#define PARAM_SEARCH_NUM_COMBINATIONS       (PARAM_SEARCH_NUM_BLIND_TIMES * PARAM_SEARCH_NUM_PERIODS * PARAM_SEARCH_NUM_DIVISORS * \
+                                             PARAM_SEARCH_NUM_MIN_INTERVALS * PARAM_SEARCH_NUM_TRIGGERS)
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint32_t index;                 // combination
+    uint32_t publishes_per_day;     // average over the traces
+    uint32_t latency;               // latency percentile over all traces
+    uint32_t missed;                // presence periods which ended before they were published
+    uint8_t  done;                  // set by the worker when the result is stored
+} param_search_result_t;
+
+typedef struct
+{
+    uint32_t              next;     // next combination to evaluate
+    param_search_result_t results[PARAM_SEARCH_NUM_COMBINATIONS];
+} param_search_shared_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+// E93196 blind time is configured in 0.5 s steps up to 8 s, the profiles use whole seconds
+static const uint32_t param_search_blind_times[PARAM_SEARCH_NUM_BLIND_TIMES]       = { 1000, 2000, 3000, 4000, 5000, 6000, 7000, 8000 };
+static const uint32_t param_search_periods[PARAM_SEARCH_NUM_PERIODS]               = { 0, 10000, 60000, 300000 };
+static const uint16_t param_search_divisors[PARAM_SEARCH_NUM_DIVISORS]             = { 1, 2, 4, 16, 30 };
+static const uint32_t param_search_min_intervals[PARAM_SEARCH_NUM_MIN_INTERVALS]   = { 0, 1 << 8, 1 << 10, 1 << 12, 1 << 13 };
+static const uint32_t param_search_triggers[PARAM_SEARCH_NUM_TRIGGERS]             = { 0, 1 };
+
+static host_trace_t param_search_traces[PARAM_SEARCH_MAX_TRACES];
+static uint32_t     param_search_num_traces;
+static uint8_t      param_search_percentile = PARAM_SEARCH_DEFAULT_PERCENTILE;
+static wiced_bool_t param_search_zone;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Configuration of the combination. The fast cadence range is the occupied value.
+ */
+static void param_search_config(uint32_t index, sensor_sim_config_t *p_config)
+{
+    memset(p_config, 0, sizeof(*p_config));
+
+    p_config->cadence.trigger_delta_up            = param_search_triggers[index % PARAM_SEARCH_NUM_TRIGGERS];
+    p_config->cadence.trigger_delta_down          = param_search_triggers[index % PARAM_SEARCH_NUM_TRIGGERS];
+    index /= PARAM_SEARCH_NUM_TRIGGERS;
+    p_config->cadence.min_interval                = param_search_min_intervals[index % PARAM_SEARCH_NUM_MIN_INTERVALS];
+    index /= PARAM_SEARCH_NUM_MIN_INTERVALS;
+    p_config->cadence.fast_cadence_period_divisor = param_search_divisors[index % PARAM_SEARCH_NUM_DIVISORS];
+    index /= PARAM_SEARCH_NUM_DIVISORS;
+    p_config->publish_period                      = param_search_periods[index % PARAM_SEARCH_NUM_PERIODS];
+    index /= PARAM_SEARCH_NUM_PERIODS;
+    p_config->blind_time                          = param_search_blind_times[index];
+
+    p_config->cadence.fast_cadence_low  = 1;
+    p_config->cadence.fast_cadence_high = 1;
+    p_config->zone                      = param_search_zone;
+}
+
+/*
+ * Without a publish period the fast cadence divisor has no effect, such combinations repeat the one with divisor 1
+ */
+static wiced_bool_t param_search_redundant(uint32_t index)
+{
+    sensor_sim_config_t config;
+
+    param_search_config(index, &config);
+    return (config.publish_period == 0) && (config.cadence.fast_cadence_period_divisor != 1);
+}
+
+/*
+ * Run the combination over all traces
+ */
+static void param_search_evaluate(uint32_t index, param_search_result_t *p_result)
+{
+    sensor_sim_config_t config;
+    sensor_sim_stats_t  stats;
+    sensor_latency_t    latency;
+    uint64_t            publishes_per_day = 0;
+    uint32_t            t;
+    uint8_t             b;
+
+    param_search_config(index, &config);
+    sensor_latency_reset(&latency);
+    p_result->missed = 0;
+
+    for (t = 0; t < param_search_num_traces; t++)
+    {
+        host_sim_reset();
+        sensor_sim_start(&config);
+        sensor_sim_run_trace(param_search_traces[t].p_edges, param_search_traces[t].num_edges, param_search_traces[t].duration);
+        sensor_sim_get_stats(&stats);
+
+        publishes_per_day += sensor_sim_publishes_per_day(&stats);
+        for (b = 0; b < SENSOR_LATENCY_BUCKETS; b++)
+            latency.buckets[b] += stats.latency.buckets[b];
+        latency.samples += stats.latency.samples;
+        if (stats.latency.max > latency.max)
+            latency.max = stats.latency.max;
+        p_result->missed += stats.latency_missed;
+    }
+
+    // missed presence is never published
+    latency.buckets[SENSOR_LATENCY_BUCKETS - 1] += p_result->missed;
+    latency.samples += p_result->missed;
+    if (p_result->missed != 0)
+        latency.max = SENSOR_LATENCY_UNBOUNDED;
+
+    p_result->index             = index;
+    p_result->publishes_per_day = (uint32_t)(publishes_per_day / param_search_num_traces);
+    p_result->latency           = sensor_latency_percentile(&latency, param_search_percentile);
+}
+
+/*
+ * Worker takes combinations until all are taken
+ */
+static void param_search_worker(param_search_shared_t *p_shared)
+{
+    uint32_t index;
+
+    while ((index = __atomic_fetch_add(&p_shared->next, 1, __ATOMIC_RELAXED)) < PARAM_SEARCH_NUM_COMBINATIONS)
+    {
+        param_search_evaluate(index, &p_shared->results[index]);
+        __atomic_store_n(&p_shared->results[index].done, 1, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ * Combinations which meet the objective first, by publications per day, then by latency.
+ * The index keeps the order stable.
+ */
+static uint32_t param_search_objective;
+
+static int param_search_compare(const void *p1, const void *p2)
+{
+    const param_search_result_t *p_a = p1;
+    const param_search_result_t *p_b = p2;
+    int                         a_ok = p_a->latency <= param_search_objective;
+    int                         b_ok = p_b->latency <= param_search_objective;
+
+    if (a_ok != b_ok)
+        return b_ok - a_ok;
+    if (a_ok && (p_a->publishes_per_day != p_b->publishes_per_day))
+        return (p_a->publishes_per_day < p_b->publishes_per_day) ? -1 : 1;
+    if (p_a->latency != p_b->latency)
+        return (p_a->latency < p_b->latency) ? -1 : 1;
+    if (p_a->publishes_per_day != p_b->publishes_per_day)
+        return (p_a->publishes_per_day < p_b->publishes_per_day) ? -1 : 1;
+    return (p_a->index < p_b->index) ? -1 : (p_a->index > p_b->index);
+}
+
+static double param_search_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    param_search_shared_t *p_shared;
+    sensor_sim_config_t   config;
+    uint32_t              hours = PARAM_SEARCH_DEFAULT_HOURS;
+    uint32_t              num_results = PARAM_SEARCH_DEFAULT_RESULTS;
+    long                  workers = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t              feasible = 0;
+    uint32_t              distinct = 0;
+    uint32_t              i;
+    double                start;
+    pid_t                 pid;
+    int                   status, opt, failed = 0;
+    long                  w;
+
+    param_search_objective = PARAM_SEARCH_DEFAULT_LATENCY;
+
+    while ((opt = getopt(argc, argv, "l:p:j:n:zd:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'l': param_search_objective = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'p': param_search_percentile = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 'j': workers = strtol(optarg, NULL, 0); break;
+        case 'n': num_results = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'z': param_search_zone = WICED_TRUE; break;
+        case 'd': hours = (uint32_t)strtoul(optarg, NULL, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-l latency ms] [-p percentile] [-j workers] [-n results] [-z] [-d hours] [trace file ...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((param_search_percentile == 0) || (param_search_percentile > 100) || (hours == 0) || (hours > 1000))
+    {
+        fprintf(stderr, "percentile shall be 1 to 100 and hours 1 to 1000\n");
+        return 2;
+    }
+    if (workers < 1)
+        workers = 1;
+    if (workers > PARAM_SEARCH_MAX_WORKERS)
+        workers = PARAM_SEARCH_MAX_WORKERS;
+
+    for (i = optind; (i < (uint32_t)argc) && (param_search_num_traces < PARAM_SEARCH_MAX_TRACES); i++)
+    {
+        if (!host_trace_load(&param_search_traces[param_search_num_traces], argv[i]))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 2;
+        }
+        param_search_num_traces++;
+    }
+    if (param_search_num_traces == 0)
+    {
+        for (i = 0; i < SENSOR_WORKLOAD_MODEL_MAX; i++)
+            if (!host_trace_generate(&param_search_traces[param_search_num_traces++], (uint8_t)i, PARAM_SEARCH_DEFAULT_SEED, 0,
+                                     hours * PARAM_SEARCH_MS_PER_HOUR))
+                return 2;
+    }
+
+    p_shared = mmap(NULL, sizeof(*p_shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p_shared == MAP_FAILED)
+    {
+        perror("mmap");
+        return 2;
+    }
+    memset(p_shared, 0, sizeof(*p_shared));
+
+    start = param_search_now();
+    for (w = 0; w < workers; w++)
+    {
+        pid = fork();
+        if (pid == 0)
+        {
+            param_search_worker(p_shared);
+            _exit(0);
+        }
+        if (pid < 0)
+        {
+            perror("fork");
+            failed = 1;
+            break;
+        }
+    }
+    while (wait(&status) > 0)
+        if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+            failed = 1;
+
+    for (i = 0; i < PARAM_SEARCH_NUM_COMBINATIONS; i++)
+        if (!p_shared->results[i].done)
+            failed = 1;
+    if (failed)
+    {
+        printf("FAIL: a worker did not complete\n");
+        return 1;
+    }
+    fprintf(stderr, "%u combinations x %u traces with %ld workers in %.2f s\n", (unsigned)PARAM_SEARCH_NUM_COMBINATIONS,
+            (unsigned)param_search_num_traces, workers, param_search_now() - start);
+
+    qsort(p_shared->results, PARAM_SEARCH_NUM_COMBINATIONS, sizeof(p_shared->results[0]), param_search_compare);
+    for (i = 0; i < PARAM_SEARCH_NUM_COMBINATIONS; i++)
+    {
+        if (param_search_redundant(p_shared->results[i].index))
+            continue;
+        distinct++;
+        if (p_shared->results[i].latency <= param_search_objective)
+            feasible++;
+    }
+
+    printf("%u of %u combinations meet p%u <= %u ms over %u traces%s\n", (unsigned)feasible, (unsigned)distinct,
+           (unsigned)param_search_percentile, (unsigned)param_search_objective, (unsigned)param_search_num_traces,
+           feasible ? "" : ", closest ones:");
+    printf("%8s %8s %4s %6s %4s %12s %10s %7s\n", "blind ms", "period", "div", "min", "trig", "publish/day", "latency ms", "missed");
+    for (i = 0; (num_results != 0) && (i < PARAM_SEARCH_NUM_COMBINATIONS); i++)
+    {
+        param_search_result_t *p_result = &p_shared->results[i];
+
+        if (param_search_redundant(p_result->index))
+            continue;
+        num_results--;
+        param_search_config(p_result->index, &config);
+        printf("%8u %8u %4u %6u %4u %12u %10u %7u\n", (unsigned)config.blind_time, (unsigned)config.publish_period,
+               (unsigned)config.cadence.fast_cadence_period_divisor, (unsigned)config.cadence.min_interval,
+               (unsigned)config.cadence.trigger_delta_up, (unsigned)p_result->publishes_per_day, (unsigned)p_result->latency,
+               (unsigned)p_result->missed);
+    }
+
+    for (i = 0; i < param_search_num_traces; i++)
+        host_trace_free(&param_search_traces[i]);
+    munmap(p_shared, sizeof(*p_shared));
+    return 0;
+}
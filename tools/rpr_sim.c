@@ -0,0 +1,247 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Remote Provisioning Server session check.
+ *
+ * Installs the instrumentation of sensor_motion_rpr.c in front of a stand-in of the Remote
+ * Provisioning Server model and drives the messages of the Remote Provisioning Client through
+ * it: a scan, a link open, the outbound provisioning PDUs of a provisioning session, each
+ * acknowledged by an outbound report of the stand-in, and a link close. The outbound report of
+ * one PDU is lost, the client sends that PDU again with the same outbound PDU number. A second
+ * session is opened and replaced by a new link open without a link close, and the statistics are
+ * reset while it is open. The tool fails if the statistics do not match the session, if a message
+ * is not passed to the model, or if the configured scan parameters are not applied.
+ *
+ * Usage: rpr_sim
+ */
+#include <stdio.h>
+#include <string.h>
+#include "wiced_bt_cfg.h"
+#include "wiced_bt_mesh_core.h"
+#include "sensor_motion_rpr.h"
+#include "host_sim.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+// Same as sensor_motion_rpr.c, from the Mesh Profile specification
+#define RPR_SIM_OPCODE_SCAN_START               0x8052
+#define RPR_SIM_OPCODE_LINK_OPEN                0x8059
+#define RPR_SIM_OPCODE_LINK_CLOSE               0x805A
+#define RPR_SIM_OPCODE_PDU_SEND                 0x805D
+
+// Provisioning PDUs sent by the provisioner: Invite, Start, Public Key, Confirmation, Random, Data
+#define RPR_SIM_OUTBOUND_PDUS                   6
+
+// Outbound PDU number whose outbound report is lost
+#define RPR_SIM_LOST_REPORT                     3
+
+#define RPR_SIM_SCAN_TIME                       5000    // scan until the device is found
+#define RPR_SIM_PDU_TIME                        400     // PDU send to outbound report, including the reply of the device
+#define RPR_SIM_RETRANSMIT_TIME                 2000    // client waits this long for the outbound report
+#define RPR_SIM_CLIENT_ADDR                     0x0001
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static wiced_bool_t rpr_sim_model_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
+{
+    .ble_scan_cfg = { 96, 48, 2048, 48 },
+};
+
+static wiced_bt_mesh_core_config_model_t rpr_sim_models[] =
+{
+    { MESH_COMPANY_ID_BT_SIG, 0x0000, NULL },
+    { MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_SRV, rpr_sim_model_handler },
+};
+
+static uint32_t rpr_sim_messages;           // messages received by the model stand-in
+static uint8_t  rpr_sim_outbound_report;    // number of the last outbound report sent by the model stand-in
+static uint32_t rpr_sim_open_time;          // time of the last link open
+static uint32_t rpr_sim_failures;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+/*
+ * Stand-in of the Remote Provisioning Server model. A PDU send is forwarded to the device and
+ * acknowledged with an outbound report carrying the same outbound PDU number.
+ */
+wiced_bool_t rpr_sim_model_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    rpr_sim_messages++;
+    if ((p_event->opcode == RPR_SIM_OPCODE_PDU_SEND) && (data_len != 0))
+        rpr_sim_outbound_report = p_data[0];
+    return WICED_TRUE;
+}
+
+/*
+ * Message of the Remote Provisioning Client received by the server
+ */
+static void rpr_sim_receive(uint16_t opcode, uint8_t *p_data, uint16_t data_len)
+{
+    wiced_bt_mesh_event_t event = { opcode, RPR_SIM_CLIENT_ADDR, 0 };
+
+    rpr_sim_models[1].p_message_handler(&event, p_data, data_len);
+}
+
+static void rpr_sim_expect(const char *name, uint32_t value, uint32_t expected)
+{
+    printf("  %-20s %8u\n", name, (unsigned)value);
+    if (value != expected)
+    {
+        printf("FAIL: %s is %u, expected %u\n", name, (unsigned)value, (unsigned)expected);
+        rpr_sim_failures++;
+    }
+}
+
+/*
+ * Provisioning session over the remote link. Returns the number of messages sent by the client.
+ */
+static uint32_t rpr_sim_session(void)
+{
+    uint8_t  scan_start[2] = { 1, 10 };                 // one report, 10 s timeout
+    uint8_t  link_open[16] = { 0 };                     // UUID of the device
+    uint8_t  pdu[2];
+    uint8_t  number;
+    uint32_t messages = 0;
+    wiced_bool_t lost = WICED_FALSE;
+
+    rpr_sim_receive(RPR_SIM_OPCODE_SCAN_START, scan_start, sizeof(scan_start));
+    messages++;
+    host_sim_run_until(host_sim_now() + RPR_SIM_SCAN_TIME);
+
+    rpr_sim_receive(RPR_SIM_OPCODE_LINK_OPEN, link_open, sizeof(link_open));
+    rpr_sim_open_time = host_sim_now();
+    messages++;
+
+    for (number = 1; number <= RPR_SIM_OUTBOUND_PDUS; number++)
+    {
+        pdu[0] = number;
+        pdu[1] = (uint8_t)(number - 1);                 // provisioning PDU type
+        rpr_sim_receive(RPR_SIM_OPCODE_PDU_SEND, pdu, sizeof(pdu));
+        messages++;
+        if (rpr_sim_outbound_report != number)
+        {
+            printf("FAIL: no outbound report for PDU %u\n", number);
+            rpr_sim_failures++;
+        }
+
+        // report is lost, the client sends the PDU again with the same number after its timeout
+        if ((number == RPR_SIM_LOST_REPORT) && !lost)
+        {
+            lost = WICED_TRUE;
+            host_sim_run_until(host_sim_now() + RPR_SIM_RETRANSMIT_TIME);
+            number--;
+            continue;
+        }
+        host_sim_run_until(host_sim_now() + RPR_SIM_PDU_TIME);
+    }
+    return messages;
+}
+
+int main(int argc, char *argv[])
+{
+    sensor_motion_rpr_stats_t stats;
+    uint8_t  link_open[16] = { 0 };
+    uint32_t messages;
+    uint32_t duration;
+
+    host_sim_reset();
+    sensor_motion_rpr_init(rpr_sim_models, sizeof(rpr_sim_models) / sizeof(rpr_sim_models[0]));
+    if (rpr_sim_models[1].p_message_handler == rpr_sim_model_handler)
+    {
+        printf("FAIL: instrumentation is not installed\n");
+        return 1;
+    }
+    if ((wiced_bt_cfg_settings.ble_scan_cfg.low_duty_scan_interval != RPR_SCAN_INTERVAL) ||
+        (wiced_bt_cfg_settings.ble_scan_cfg.low_duty_scan_window != RPR_SCAN_WINDOW))
+    {
+        printf("FAIL: scan parameters are not applied\n");
+        rpr_sim_failures++;
+    }
+
+    // First session, closed by the client
+    sensor_motion_rpr_stats_reset();
+    messages = rpr_sim_session();
+    rpr_sim_receive(RPR_SIM_OPCODE_LINK_CLOSE, NULL, 0);
+    messages++;
+    duration = host_sim_now() - rpr_sim_open_time;
+
+    sensor_motion_rpr_get_stats(&stats);
+    printf("session closed by the client:\n");
+    rpr_sim_expect("messages to model", rpr_sim_messages, messages);
+    rpr_sim_expect("sessions", stats.sessions, 1);
+    rpr_sim_expect("scans", stats.scans, 1);
+    rpr_sim_expect("pdus forwarded", stats.pdus_forwarded, RPR_SIM_OUTBOUND_PDUS);
+    rpr_sim_expect("retransmissions", stats.retransmissions, 1);
+    rpr_sim_expect("session ms", stats.session_duration, duration);
+    rpr_sim_expect("total ms", stats.total_duration, duration);
+    rpr_sim_expect("active", stats.session_active, WICED_FALSE);
+
+    // Second session, the client opens a new link without closing it. The statistics are reset while
+    // the session is open, the session still ends when the new link is opened.
+    rpr_sim_receive(RPR_SIM_OPCODE_LINK_OPEN, link_open, sizeof(link_open));
+    rpr_sim_open_time = host_sim_now();
+    host_sim_run_until(host_sim_now() + RPR_SIM_PDU_TIME);
+    sensor_motion_rpr_stats_reset();
+    host_sim_run_until(host_sim_now() + RPR_SIM_PDU_TIME);
+
+    sensor_motion_rpr_get_stats(&stats);
+    printf("session open after a reset:\n");
+    rpr_sim_expect("sessions", stats.sessions, 0);
+    rpr_sim_expect("active", stats.session_active, WICED_TRUE);
+    rpr_sim_expect("session ms", stats.session_duration, host_sim_now() - rpr_sim_open_time);
+
+    rpr_sim_receive(RPR_SIM_OPCODE_LINK_OPEN, link_open, sizeof(link_open));
+    sensor_motion_rpr_get_stats(&stats);
+    printf("session replaced by a new link:\n");
+    rpr_sim_expect("sessions", stats.sessions, 1);
+    rpr_sim_expect("total ms", stats.total_duration, 2 * RPR_SIM_PDU_TIME);
+    rpr_sim_expect("active", stats.session_active, WICED_TRUE);
+    rpr_sim_expect("pdus forwarded", stats.pdus_forwarded, 0);
+
+    if (rpr_sim_failures != 0)
+    {
+        printf("FAIL: %u checks failed\n", (unsigned)rpr_sim_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Presence rule engine check.
+ *
+ * Drives the rule engine of the application, sensor_motion_rule.c, with presence transitions and
+ * expirations of the rule timer, and records the messages the rules send. A rule without delay
+ * fires on its transition, a delayed rule fires once when it is due and is cancelled by the
+ * opposite transition or when it is replaced. The due times are checked across the wraparound of
+ * the tick count, and after a restart of the tick count as on the wake from HID-Off. Rules are
+ * encoded and decoded as in the Sensor Setting and HCI command, and invalid rules are rejected.
+ * The tool fails if a check does not pass.
+ *
+ * Usage: rule_check
+ */
+#include <stdio.h>
+#include <string.h>
+#include "sensor_motion_rule.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define RULE_CHECK_MINUTE_MS            60000
+#define RULE_CHECK_MAX_ACTIONS          16
+
+/******************************************************
+ *          Function Prototypes
+ ******************************************************/
+static void         rule_check_action(const sensor_rule_t *p_rule);
+static void         rule_check_reset(sensor_rule_engine_t *p_engine);
+static void         rule_check_add(sensor_rule_engine_t *p_engine, uint8_t index, uint8_t trigger, uint8_t action, uint8_t delay, uint16_t dst);
+static wiced_bool_t rule_check_fired(uint32_t count, uint16_t dst);
+static wiced_bool_t rule_check_expect(const char *p_name, wiced_bool_t passed);
+static wiced_bool_t rule_check_codec(void);
+static wiced_bool_t rule_check_set(void);
+static wiced_bool_t rule_check_immediate(void);
+static wiced_bool_t rule_check_delayed(void);
+static wiced_bool_t rule_check_wraparound(void);
+static wiced_bool_t rule_check_rebase(void);
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static uint16_t rule_check_actions[RULE_CHECK_MAX_ACTIONS];     // destinations of the messages sent
+static uint32_t rule_check_num_actions;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+int main(int argc, char *argv[])
+{
+    wiced_bool_t passed = WICED_TRUE;
+
+    passed &= rule_check_codec();
+    passed &= rule_check_set();
+    passed &= rule_check_immediate();
+    passed &= rule_check_delayed();
+    passed &= rule_check_wraparound();
+    passed &= rule_check_rebase();
+
+    if (!passed)
+    {
+        printf("FAIL: rule engine\n");
+        return 1;
+    }
+    return 0;
+}
+
+static void rule_check_action(const sensor_rule_t *p_rule)
+{
+    if (rule_check_num_actions < RULE_CHECK_MAX_ACTIONS)
+        rule_check_actions[rule_check_num_actions] = p_rule->dst;
+    rule_check_num_actions++;
+}
+
+static void rule_check_reset(sensor_rule_engine_t *p_engine)
+{
+    sensor_rule_init(p_engine);
+    rule_check_num_actions = 0;
+}
+
+static void rule_check_add(sensor_rule_engine_t *p_engine, uint8_t index, uint8_t trigger, uint8_t action, uint8_t delay, uint16_t dst)
+{
+    sensor_rule_t rule;
+
+    memset(&rule, 0, sizeof(rule));
+    rule.type  = SENSOR_RULE_TYPE(trigger, action);
+    rule.delay = delay;
+    rule.dst   = dst;
+    rule.value = 1;
+    sensor_rule_set(p_engine, index, &rule);
+}
+
+/*
+ * Exactly count messages have been sent, the last one to dst
+ */
+static wiced_bool_t rule_check_fired(uint32_t count, uint16_t dst)
+{
+    return (rule_check_num_actions == count) && ((count == 0) || (rule_check_actions[count - 1] == dst));
+}
+
+static wiced_bool_t rule_check_expect(const char *p_name, wiced_bool_t passed)
+{
+    printf("%-48s %s\n", p_name, passed ? "ok" : "FAIL");
+    return passed;
+}
+
+/*
+ * Encode and decode round trips, with the index in the first byte and a negative level
+ */
+static wiced_bool_t rule_check_codec(void)
+{
+    static const sensor_rule_t rules[] =
+    {
+        { SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_ONOFF), 0,   0xC001, 0x0000, 1      },
+        { SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF),   10,  0xC002, 0x0001, 0      },
+        { SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_LEVEL),   255, 0xFFFF, 0x0FFF, -32768 },
+        { SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_LEVEL), 1,   0x0102, 0x0304, 32767  },
+    };
+    uint8_t       data[SENSOR_RULE_ENCODED_LEN];
+    sensor_rule_t rule;
+    uint8_t       index;
+    uint8_t       i;
+    wiced_bool_t  passed = WICED_TRUE;
+
+    for (i = 0; i < sizeof(rules) / sizeof(rules[0]); i++)
+    {
+        sensor_rule_encode(i, &rules[i], data);
+        passed &= sensor_rule_decode(data, sizeof(data), &index, &rule) && (index == i) && (rule.type == rules[i].type) &&
+                  (rule.delay == rules[i].delay) && (rule.dst == rules[i].dst) && (rule.app_key_idx == rules[i].app_key_idx) &&
+                  (rule.value == rules[i].value);
+    }
+    passed = rule_check_expect("encode and decode round trip", passed);
+
+    sensor_rule_encode(1, &rules[2], data);
+    passed &= rule_check_expect("encoding little endian", (data[0] == 0x16) && (data[1] == 255) && (data[2] == 0xFF) && (data[3] == 0xFF) &&
+                                (data[4] == 0xFF) && (data[5] == 0x0F) && (data[6] == 0x00) && (data[7] == 0x80));
+    passed &= rule_check_expect("short rule rejected", !sensor_rule_decode(data, SENSOR_RULE_ENCODED_LEN - 1, &index, &rule));
+    return passed;
+}
+
+/*
+ * Invalid rules are rejected, a rule without trigger or destination removes the rule
+ */
+static wiced_bool_t rule_check_set(void)
+{
+    sensor_rule_engine_t engine;
+    sensor_rule_t        rule;
+    wiced_bool_t         passed = WICED_TRUE;
+
+    rule_check_reset(&engine);
+    memset(&rule, 0, sizeof(rule));
+    rule.dst = 0xC001;
+
+    rule.type = SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_ONOFF);
+    passed &= rule_check_expect("index out of the table rejected", !sensor_rule_set(&engine, SENSOR_RULE_MAX, &rule));
+    rule.type = SENSOR_RULE_TYPE(3, SENSOR_RULE_ACTION_ONOFF);
+    passed &= rule_check_expect("unknown trigger rejected", !sensor_rule_set(&engine, 0, &rule));
+    rule.type = SENSOR_RULE_TYPE(SENSOR_RULE_TRIGGER_OCCUPIED, 2);
+    passed &= rule_check_expect("unknown action rejected", !sensor_rule_set(&engine, 0, &rule));
+
+    rule_check_add(&engine, 0, SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_ONOFF, 0, 0xC001);
+    rule_check_add(&engine, 1, SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_ONOFF, 0, 0);
+    passed &= rule_check_expect("rule without destination removed",
+                                (engine.rules[0].dst == 0xC001) && (SENSOR_RULE_TRIGGER(&engine.rules[1]) == SENSOR_RULE_TRIGGER_NONE));
+    rule_check_add(&engine, 0, SENSOR_RULE_TRIGGER_NONE, SENSOR_RULE_ACTION_ONOFF, 0, 0xC001);
+    passed &= rule_check_expect("rule without trigger removed", engine.rules[0].dst == 0);
+    return passed;
+}
+
+/*
+ * Rules without delay fire on their transition only
+ */
+static wiced_bool_t rule_check_immediate(void)
+{
+    sensor_rule_engine_t engine;
+    wiced_bool_t         passed = WICED_TRUE;
+    uint32_t             next;
+
+    rule_check_reset(&engine);
+    rule_check_add(&engine, 0, SENSOR_RULE_TRIGGER_OCCUPIED, SENSOR_RULE_ACTION_ONOFF, 0, 0xC001);
+    rule_check_add(&engine, 2, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_LEVEL, 0, 0xC002);
+
+    next = sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_OCCUPIED, 1000, rule_check_action);
+    passed &= rule_check_expect("occupied rule fires on occupied", rule_check_fired(1, 0xC001) && (next == 0));
+    next = sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, 2000, rule_check_action);
+    passed &= rule_check_expect("vacant rule fires on vacant", rule_check_fired(2, 0xC002) && (next == 0));
+    return passed;
+}
+
+/*
+ * Delayed rules fire once when due, and are cancelled by the opposite transition or when replaced
+ */
+static wiced_bool_t rule_check_delayed(void)
+{
+    sensor_rule_engine_t engine;
+    wiced_bool_t         passed = WICED_TRUE;
+    uint32_t             next;
+
+    rule_check_reset(&engine);
+    rule_check_add(&engine, 1, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 10, 0xC003);
+    rule_check_add(&engine, 3, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 2, 0xC004);
+
+    next = sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, 0, rule_check_action);
+    passed &= rule_check_expect("delayed rules armed, next due first",
+                                rule_check_fired(0, 0) && (engine.pending == 0x0A) && (next == 2 * RULE_CHECK_MINUTE_MS));
+    next = sensor_rule_expired(&engine, 2 * RULE_CHECK_MINUTE_MS - 1, rule_check_action);
+    passed &= rule_check_expect("rule not fired before due", rule_check_fired(0, 0) && (next == 1));
+    next = sensor_rule_expired(&engine, 2 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("rule fired when due", rule_check_fired(1, 0xC004) && (next == 8 * RULE_CHECK_MINUTE_MS));
+    next = sensor_rule_expired(&engine, 2 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("rule fired once", rule_check_fired(1, 0xC004) && (next == 8 * RULE_CHECK_MINUTE_MS));
+
+    next = sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_OCCUPIED, 5 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("rule cancelled by the opposite transition", (engine.pending == 0) && (next == 0));
+    next = sensor_rule_expired(&engine, 10 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("cancelled rule not fired", rule_check_fired(1, 0xC004) && (next == 0));
+
+    sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, 20 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    next = sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, 25 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("rule armed again by the same transition", next == 2 * RULE_CHECK_MINUTE_MS);
+    sensor_rule_expired(&engine, 27 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    next = sensor_rule_expired(&engine, 34 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("delay counted from the last transition", rule_check_fired(2, 0xC004) && (next == RULE_CHECK_MINUTE_MS));
+
+    rule_check_add(&engine, 1, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 10, 0xC005);
+    next = sensor_rule_expired(&engine, 40 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("rule cancelled when replaced", rule_check_fired(2, 0xC004) && (engine.pending == 0) && (next == 0));
+
+    sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, 50 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    next = sensor_rule_expired(&engine, 80 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("overdue rules fired together", (rule_check_num_actions == 4) && (engine.pending == 0) && (next == 0));
+    return passed;
+}
+
+/*
+ * Due times across the wraparound of the tick count
+ */
+static wiced_bool_t rule_check_wraparound(void)
+{
+    sensor_rule_engine_t engine;
+    wiced_bool_t         passed = WICED_TRUE;
+    uint32_t             now = 0xFFFFFFFF - RULE_CHECK_MINUTE_MS / 2;
+    uint32_t             next;
+
+    rule_check_reset(&engine);
+    rule_check_add(&engine, 0, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 1, 0xC006);
+    rule_check_add(&engine, 1, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 3, 0xC007);
+
+    next = sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, now, rule_check_action);
+    passed &= rule_check_expect("due after the wraparound", (engine.due[0] < now) && (next == RULE_CHECK_MINUTE_MS));
+    next = sensor_rule_next_due(&engine, 0xFFFFFFFF);
+    passed &= rule_check_expect("next due before the wraparound", next == RULE_CHECK_MINUTE_MS / 2);
+    next = sensor_rule_expired(&engine, 0xFFFFFFFF, rule_check_action);
+    passed &= rule_check_expect("rule not fired at the wraparound", rule_check_fired(0, 0) && (next == RULE_CHECK_MINUTE_MS / 2));
+    next = sensor_rule_expired(&engine, now + RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("rule fired after the wraparound", rule_check_fired(1, 0xC006) && (next == 2 * RULE_CHECK_MINUTE_MS));
+    next = sensor_rule_next_due(&engine, now + 4 * RULE_CHECK_MINUTE_MS);
+    passed &= rule_check_expect("overdue rule due in 1 ms", next == 1);
+    next = sensor_rule_expired(&engine, now + 4 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("overdue rule fired", rule_check_fired(2, 0xC007) && (next == 0));
+    return passed;
+}
+
+/*
+ * Pending rules moved to a new tick count, as on the wake from HID-Off
+ */
+static wiced_bool_t rule_check_rebase(void)
+{
+    sensor_rule_engine_t engine;
+    wiced_bool_t         passed = WICED_TRUE;
+    uint32_t             sleep_tick = 100 * RULE_CHECK_MINUTE_MS;
+    uint32_t             next;
+
+    rule_check_reset(&engine);
+    rule_check_add(&engine, 0, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 60, 0xC008);
+    rule_check_add(&engine, 1, SENSOR_RULE_TRIGGER_VACANT, SENSOR_RULE_ACTION_ONOFF, 90, 0xC009);
+    sensor_rule_transition(&engine, SENSOR_RULE_TRIGGER_VACANT, sleep_tick - 10 * RULE_CHECK_MINUTE_MS, rule_check_action);
+
+    // timed wake when the first rule is due, the tick count restarts at 0
+    sensor_rule_rebase(&engine, sleep_tick + 50 * RULE_CHECK_MINUTE_MS);
+    next = sensor_rule_next_due(&engine, 0);
+    passed &= rule_check_expect("restored rule due at the wake", next == 1);
+    next = sensor_rule_expired(&engine, 0, rule_check_action);
+    passed &= rule_check_expect("restored rule fired at the wake", rule_check_fired(1, 0xC008) && (next == 30 * RULE_CHECK_MINUTE_MS));
+    next = sensor_rule_expired(&engine, 30 * RULE_CHECK_MINUTE_MS, rule_check_action);
+    passed &= rule_check_expect("restored rule fired after the wake", rule_check_fired(2, 0xC009) && (next == 0));
+    return passed;
+}
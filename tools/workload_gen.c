@@ -0,0 +1,182 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Occupancy workload generator.
+ *
+ * Writes the motion trace of an occupancy model of sensor_motion_workload.c in the trace format of
+ * the host tools: one time in ms per line and "# duration <ms>". The same model and seed always give
+ * the same trace, and the trace is the same sequence a device built with SYNTHETIC_MOTION=1 generates
+ * from the model and seed. With a blind time the trace has the interrupts of a PIR sensor with that
+ * blind time, without it every motion, for tools which apply the blind time themselves. A written
+ * trace is read back and compared, the tool fails if it differs.
+ *
+ * The summary lists for every model the motions, the interrupts with the blind time and the share of
+ * the motions the sensor suppresses.
+ *
+ * Usage: workload_gen [-m model] [-s seed] [-d hours] [-b blind time ms] [-o file] [-l]
+ *   -m  office, corridor, meeting or cleaning
+ *   -o  trace file, standard output by default
+ *   -l  print the summary of all models instead of a trace
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sensor_motion_workload.h"
+#include "host_trace.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define WORKLOAD_GEN_MS_PER_HOUR            3600000
+#define WORKLOAD_GEN_DEFAULT_HOURS          24
+#define WORKLOAD_GEN_DEFAULT_SEED           0x2545F491
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+static int workload_gen_model(const char *p_name)
+{
+    uint8_t m;
+
+    for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+        if (strcmp(p_name, host_trace_model_name(m)) == 0)
+            return m;
+    return -1;
+}
+
+static int workload_gen_summary(uint32_t seed, uint32_t blind_time, uint32_t duration)
+{
+    host_trace_t motions, interrupts;
+    uint8_t      m;
+
+    printf("%-9s %9s %11s %11s\n", "model", "motions", "interrupts", "suppressed");
+    for (m = 0; m < SENSOR_WORKLOAD_MODEL_MAX; m++)
+    {
+        if (!host_trace_generate(&motions, m, seed, 0, duration) || !host_trace_generate(&interrupts, m, seed, blind_time, duration))
+            return 2;
+        printf("%-9s %9u %11u %10.1f%%\n", host_trace_model_name(m), (unsigned)motions.num_edges, (unsigned)interrupts.num_edges,
+               motions.num_edges ? 100.0 * (motions.num_edges - interrupts.num_edges) / motions.num_edges : 0.0);
+        host_trace_free(&motions);
+        host_trace_free(&interrupts);
+    }
+    return 0;
+}
+
+/*
+ * Traces are equal if they have the same motions and duration
+ */
+static wiced_bool_t workload_gen_verify(const host_trace_t *p_trace, const char *p_file_name)
+{
+    host_trace_t read;
+    wiced_bool_t equal;
+
+    if (!host_trace_load(&read, p_file_name))
+        return WICED_FALSE;
+
+    equal = (read.num_edges == p_trace->num_edges) && (read.duration == p_trace->duration) &&
+            ((read.num_edges == 0) || (memcmp(read.p_edges, p_trace->p_edges, read.num_edges * sizeof(uint32_t)) == 0));
+    host_trace_free(&read);
+    return equal;
+}
+
+int main(int argc, char *argv[])
+{
+    int          model = SENSOR_WORKLOAD_MODEL_OFFICE;
+    uint32_t     seed = WORKLOAD_GEN_DEFAULT_SEED;
+    uint32_t     hours = WORKLOAD_GEN_DEFAULT_HOURS;
+    uint32_t     blind_time = 0;
+    const char   *p_file_name = NULL;
+    wiced_bool_t summary = WICED_FALSE;
+    host_trace_t trace;
+    FILE         *p_file = stdout;
+    int          opt;
+
+    while ((opt = getopt(argc, argv, "m:s:d:b:o:l")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm': model = workload_gen_model(optarg); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'd': hours = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'b': blind_time = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'o': p_file_name = optarg; break;
+        case 'l': summary = WICED_TRUE; break;
+        default:
+            fprintf(stderr, "usage: %s [-m model] [-s seed] [-d hours] [-b blind time ms] [-o file] [-l]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (model < 0)
+    {
+        fprintf(stderr, "model shall be office, corridor, meeting or cleaning\n");
+        return 2;
+    }
+    // the tick count wraps after 49 days
+    if ((hours == 0) || (hours > 1000))
+    {
+        fprintf(stderr, "hours shall be 1 to 1000\n");
+        return 2;
+    }
+
+    if (summary)
+        return workload_gen_summary(seed, blind_time, hours * WORKLOAD_GEN_MS_PER_HOUR);
+
+    if (!host_trace_generate(&trace, (uint8_t)model, seed, blind_time, hours * WORKLOAD_GEN_MS_PER_HOUR))
+    {
+        fprintf(stderr, "cannot generate the trace\n");
+        return 2;
+    }
+    if ((p_file_name != NULL) && ((p_file = fopen(p_file_name, "w")) == NULL))
+    {
+        fprintf(stderr, "cannot write %s\n", p_file_name);
+        return 2;
+    }
+    fprintf(p_file, "# seed %u blind time %u\n", (unsigned)seed, (unsigned)blind_time);
+    host_trace_write(&trace, p_file);
+
+    if (p_file_name != NULL)
+    {
+        fclose(p_file);
+        if (!workload_gen_verify(&trace, p_file_name))
+        {
+            printf("FAIL: %s does not read back as written\n", p_file_name);
+            host_trace_free(&trace);
+            return 1;
+        }
+    }
+    host_trace_free(&trace);
+    return 0;
+}